@@ -97,7 +97,51 @@
 // Requires (11 + size*size*6*8) bytes of transmission for each character
 uint32_t StX=0; // position along the horizonal axis 0 to 20
 uint32_t StY=0; // position along the vertical axis 0 to 15
+static uint8_t ScrollOn;         // 1 while ST7735_OutChar() scrolls the display
+static uint8_t ScrollLines;      // text lines in the hardware scroll area
+static uint8_t ScrollTop;        // text line of frame memory shown at the top
+static uint8_t StripOn;          // 1 while the strip chart or waterfall owns the scroll area
 uint16_t StTextColor = ST7735_YELLOW;
+uint16_t StTextBgColor = ST7735_BLACK;
+
+// Console shadow: what each character cell of frame memory shows
+// (or will show after ST7735_TextFlush()), indexed by text line of
+// frame memory, so hardware scrolling does not move it.
+static char TextChar[16][21];
+static uint16_t TextFg[16][21];
+static uint16_t TextBg[16][21];
+static uint32_t TextDirty[16];   // bit c set if cell c of the line must be redrawn
+static uint32_t TextFresh[16];   // bit c set if cell c was written since its line was blanked
+static uint16_t TextBlank;       // bit n set if line n is to be blanked, except fresh cells
+static uint32_t TextUnknown[16]; // bit c set if what cell c shows is not known
+
+// The whole screen was filled with color: every cell is a blank
+// that is already shown.
+void static textReset(uint16_t color){
+  uint32_t line, c;
+  for(line=0; line<16; line=line+1){
+    for(c=0; c<21; c=c+1){
+      TextChar[line][c] = ' ';
+      TextFg[line][c] = color;
+      TextBg[line][c] = color;
+    }
+    TextDirty[line] = 0;
+    TextUnknown[line] = 0;
+  }
+  TextBlank = 0;
+}
+
+// Another panel was selected: nothing it shows is known, so every
+// cell written is drawn.
+void static textForget(void){
+  uint32_t line;
+  for(line=0; line<16; line=line+1){
+    TextUnknown[line] = 0x001FFFFF;     // all 21 cells
+    TextDirty[line] = 0;
+    TextFresh[line] = 0;
+  }
+  TextBlank = 0;
+}
 
 #define ST7735_NOP     0x00
 #define ST7735_SWRESET 0x01
@@ -145,15 +189,42 @@ uint16_t StTextColor = ST7735_YELLOW;
 #define ST7735_GMCTRP1 0xE0
 #define ST7735_GMCTRN1 0xE1
 
-#define TFT_CS                  (*((volatile uint32_t *)0x40004020))
+// Pins of the selected panel, see ST7735_SelectPanel().  Each is
+// the bit-specific address of one GPIO pin, so writing 0xFF sets
+// just that pin.
+#define TFT_CS                  (*((volatile uint32_t *)CSAddr))
 #define TFT_CS_LOW              0           // CS normally controlled by hardware
-#define TFT_CS_HIGH             0x08
-#define DC                      (*((volatile uint32_t *)0x40004100))
+#define TFT_CS_HIGH             0xFF
+#define DC                      (*((volatile uint32_t *)DCAddr))
 #define DC_COMMAND              0
-#define DC_DATA                 0x40
-#define RESET                   (*((volatile uint32_t *)0x40004200))
+#define DC_DATA                 0xFF
+#define RESET                   (*((volatile uint32_t *)ResetAddr))
 #define RESET_LOW               0
-#define RESET_HIGH              0x80
+#define RESET_HIGH              0xFF
+
+// Registers of the SSI module of the selected panel
+#define SSI_O_CR0               0x00000000  // SSI Control 0
+#define SSI_O_CR1               0x00000004  // SSI Control 1
+#define SSI_O_DR                0x00000008  // SSI Data
+#define SSI_O_SR                0x0000000C  // SSI Status
+#define SSI_O_CPSR              0x00000010  // SSI Clock Prescale
+#define SSI_O_DMACTL            0x00000024  // SSI DMA Control
+#define SSI_O_CC                0x00000FC8  // SSI Clock Configuration
+#define SSI_CR0_R               (*((volatile uint32_t *)(SSIBase + SSI_O_CR0)))
+#define SSI_CR1_R               (*((volatile uint32_t *)(SSIBase + SSI_O_CR1)))
+#define SSI_DR_R                (*((volatile uint32_t *)(SSIBase + SSI_O_DR)))
+#define SSI_SR_R                (*((volatile uint32_t *)(SSIBase + SSI_O_SR)))
+#define SSI_CPSR_R              (*((volatile uint32_t *)(SSIBase + SSI_O_CPSR)))
+#define SSI_DMACTL_R            (*((volatile uint32_t *)(SSIBase + SSI_O_DMACTL)))
+#define SSI_CC_R                (*((volatile uint32_t *)(SSIBase + SSI_O_CC)))
+
+// GPIO registers of a port, given its base address
+#define GPIO_O_DIR              0x00000400  // GPIO Direction
+#define GPIO_O_AFSEL            0x00000420  // GPIO Alternate Function Select
+#define GPIO_O_DEN              0x0000051C  // GPIO Digital Enable
+#define GPIO_O_AMSEL            0x00000528  // GPIO Analog Mode Select
+#define GPIO_O_PCTL             0x0000052C  // GPIO Port Control
+#define GPIO_REG(port, offset)  (*((volatile uint32_t *)((port) + (offset))))
 
 #define SSI_CR0_SCR_M           0x0000FF00  // SSI Serial Clock Rate
 #define SSI_CR0_SPH             0x00000080  // SSI Serial Clock Phase
@@ -162,11 +233,13 @@ uint16_t StTextColor = ST7735_YELLOW;
 #define SSI_CR0_FRF_MOTO        0x00000000  // Freescale SPI Frame Format
 #define SSI_CR0_DSS_M           0x0000000F  // SSI Data Size Select
 #define SSI_CR0_DSS_8           0x00000007  // 8-bit data
+#define SSI_CR0_DSS_16          0x0000000F  // 16-bit data
 #define SSI_CR1_MS              0x00000004  // SSI Master/Slave Select
 #define SSI_CR1_SSE             0x00000002  // SSI Synchronous Serial Port
                                             // Enable
 #define SSI_SR_BSY              0x00000010  // SSI Busy Bit
 #define SSI_SR_TNF              0x00000002  // SSI Transmit FIFO Not Full
+#define SSI_DMACTL_TXDMAE       0x00000002  // Transmit DMA Enable
 #define SSI_CPSR_CPSDVSR_M      0x000000FF  // SSI Clock Prescale Divisor
 #define SSI_CC_CS_M             0x0000000F  // SSI Baud Clock Source
 #define SSI_CC_CS_SYSPLL        0x00000000  // Either the system clock (if the
@@ -174,6 +247,27 @@ uint16_t StTextColor = ST7735_YELLOW;
                                             // PLL output (default)
 #define SYSCTL_RCGC1_SSI0       0x00000010  // SSI0 Clock Gating Control
 #define SYSCTL_RCGC2_GPIOA      0x00000001  // port A Clock Gating Control
+#define DMA_CH_SSI0TX           11          // uDMA channel 11, encoding 0 is SSI0 Tx
+#define DMA_CH_SSI2TX           13          // uDMA channel 13, encoding 2 is SSI2 Tx
+#define DMA_MAXITEMS            1024        // basic mode transfer size limit
+#define DMA_LINEMAX             160         // longest row, either rotation
+#define INT_SSI0_BIT            (1<<7)      // SSI0 is interrupt number 7
+#define INT_SSI2_BIT            (1<<(57-32))  // SSI2 is interrupt number 57
+
+// The only places the driver and the hardware meet while drawing:
+// the SSI data register, starting a uDMA channel, and the body of
+// every loop that waits on the SSI or the uDMA.  A host build
+// (tools/st7735shim.c) defines ST7735_SHIM to replace them with a
+// model of the SSI FIFO and the uDMA that records the bytes on the
+// wire and counts the cycles spent waiting.
+#ifdef ST7735_SHIM
+#include "st7735shim.h"
+#else
+#define SSI_WRITE(data)         (SSI_DR_R = (data))
+#define DMA_ENABLE(channel)     (UDMA_ENASET_R = (1<<(channel)))
+#define POLL()
+#endif
+#define ST7735_FRAMEROWS 162         // rows of controller frame memory (132x162)
 #define ST7735_TFTWIDTH  128
 #define ST7735_TFTHEIGHT 160
 
@@ -197,6 +291,8 @@ uint16_t StTextColor = ST7735_YELLOW;
 #define ST7735_RAMRD   0x2E
 
 #define ST7735_PTLAR   0x30
+#define ST7735_VSCRDEF 0x33
+#define ST7735_VSCSAD  0x37
 #define ST7735_COLMOD  0x3A
 #define ST7735_MADCTL  0x36
 
@@ -225,262 +321,267 @@ uint16_t StTextColor = ST7735_YELLOW;
 
 // standard ascii 5x7 font
 // originally from glcdfont.c from Adafruit project
-static const uint8_t Font[] = {
-  0x00, 0x00, 0x00, 0x00, 0x00,
-  0x3E, 0x5B, 0x4F, 0x5B, 0x3E,
-  0x3E, 0x6B, 0x4F, 0x6B, 0x3E,
-  0x1C, 0x3E, 0x7C, 0x3E, 0x1C,
-  0x18, 0x3C, 0x7E, 0x3C, 0x18,
-  0x1C, 0x57, 0x7D, 0x57, 0x1C,
-  0x1C, 0x5E, 0x7F, 0x5E, 0x1C,
-  0x00, 0x18, 0x3C, 0x18, 0x00,
-  0xFF, 0xE7, 0xC3, 0xE7, 0xFF,
-  0x00, 0x18, 0x24, 0x18, 0x00,
-  0xFF, 0xE7, 0xDB, 0xE7, 0xFF,
-  0x30, 0x48, 0x3A, 0x06, 0x0E,
-  0x26, 0x29, 0x79, 0x29, 0x26,
-  0x40, 0x7F, 0x05, 0x05, 0x07,
-  0x40, 0x7F, 0x05, 0x25, 0x3F,
-  0x5A, 0x3C, 0xE7, 0x3C, 0x5A,
-  0x7F, 0x3E, 0x1C, 0x1C, 0x08,
-  0x08, 0x1C, 0x1C, 0x3E, 0x7F,
-  0x14, 0x22, 0x7F, 0x22, 0x14,
-  0x5F, 0x5F, 0x00, 0x5F, 0x5F,
-  0x06, 0x09, 0x7F, 0x01, 0x7F,
-  0x00, 0x66, 0x89, 0x95, 0x6A,
-  0x60, 0x60, 0x60, 0x60, 0x60,
-  0x94, 0xA2, 0xFF, 0xA2, 0x94,
-  0x08, 0x04, 0x7E, 0x04, 0x08,
-  0x10, 0x20, 0x7E, 0x20, 0x10,
-  0x08, 0x08, 0x2A, 0x1C, 0x08,
-  0x08, 0x1C, 0x2A, 0x08, 0x08,
-  0x1E, 0x10, 0x10, 0x10, 0x10,
-  0x0C, 0x1E, 0x0C, 0x1E, 0x0C,
-  0x30, 0x38, 0x3E, 0x38, 0x30,
-  0x06, 0x0E, 0x3E, 0x0E, 0x06,
-  0x00, 0x00, 0x00, 0x00, 0x00,
-  0x00, 0x00, 0x5F, 0x00, 0x00,
-  0x00, 0x07, 0x00, 0x07, 0x00,
-  0x14, 0x7F, 0x14, 0x7F, 0x14,
-  0x24, 0x2A, 0x7F, 0x2A, 0x12,
-  0x23, 0x13, 0x08, 0x64, 0x62,
-  0x36, 0x49, 0x56, 0x20, 0x50,
-  0x00, 0x08, 0x07, 0x03, 0x00,
-  0x00, 0x1C, 0x22, 0x41, 0x00,
-  0x00, 0x41, 0x22, 0x1C, 0x00,
-  0x2A, 0x1C, 0x7F, 0x1C, 0x2A,
-  0x08, 0x08, 0x3E, 0x08, 0x08,
-  0x00, 0x80, 0x70, 0x30, 0x00,
-  0x08, 0x08, 0x08, 0x08, 0x08,
-  0x00, 0x00, 0x60, 0x60, 0x00,
-  0x20, 0x10, 0x08, 0x04, 0x02,
-  0x3E, 0x51, 0x49, 0x45, 0x3E, // 0
-  0x00, 0x42, 0x7F, 0x40, 0x00, // 1
-  0x72, 0x49, 0x49, 0x49, 0x46, // 2
-  0x21, 0x41, 0x49, 0x4D, 0x33, // 3
-  0x18, 0x14, 0x12, 0x7F, 0x10, // 4
-  0x27, 0x45, 0x45, 0x45, 0x39, // 5
-  0x3C, 0x4A, 0x49, 0x49, 0x31, // 6
-  0x41, 0x21, 0x11, 0x09, 0x07, // 7
-  0x36, 0x49, 0x49, 0x49, 0x36, // 8
-  0x46, 0x49, 0x49, 0x29, 0x1E, // 9
-  0x00, 0x00, 0x14, 0x00, 0x00,
-  0x00, 0x40, 0x34, 0x00, 0x00,
-  0x00, 0x08, 0x14, 0x22, 0x41,
-  0x14, 0x14, 0x14, 0x14, 0x14,
-  0x00, 0x41, 0x22, 0x14, 0x08,
-  0x02, 0x01, 0x59, 0x09, 0x06,
-  0x3E, 0x41, 0x5D, 0x59, 0x4E,
-  0x7C, 0x12, 0x11, 0x12, 0x7C, // A
-  0x7F, 0x49, 0x49, 0x49, 0x36, // B
-  0x3E, 0x41, 0x41, 0x41, 0x22, // C
-  0x7F, 0x41, 0x41, 0x41, 0x3E, // D
-  0x7F, 0x49, 0x49, 0x49, 0x41, // E
-  0x7F, 0x09, 0x09, 0x09, 0x01, // F
-  0x3E, 0x41, 0x41, 0x51, 0x73, // G
-  0x7F, 0x08, 0x08, 0x08, 0x7F, // H
-  0x00, 0x41, 0x7F, 0x41, 0x00, // I
-  0x20, 0x40, 0x41, 0x3F, 0x01, // J
-  0x7F, 0x08, 0x14, 0x22, 0x41, // K
-  0x7F, 0x40, 0x40, 0x40, 0x40, // L
-  0x7F, 0x02, 0x1C, 0x02, 0x7F, // M
-  0x7F, 0x04, 0x08, 0x10, 0x7F, // N
-  0x3E, 0x41, 0x41, 0x41, 0x3E, // O
-  0x7F, 0x09, 0x09, 0x09, 0x06, // P
-  0x3E, 0x41, 0x51, 0x21, 0x5E, // Q
-  0x7F, 0x09, 0x19, 0x29, 0x46, // R
-  0x26, 0x49, 0x49, 0x49, 0x32, // S
-  0x03, 0x01, 0x7F, 0x01, 0x03, // T
-  0x3F, 0x40, 0x40, 0x40, 0x3F, // U
-  0x1F, 0x20, 0x40, 0x20, 0x1F, // V
-  0x3F, 0x40, 0x38, 0x40, 0x3F, // W
-  0x63, 0x14, 0x08, 0x14, 0x63, // X
-  0x03, 0x04, 0x78, 0x04, 0x03, // Y
-  0x61, 0x59, 0x49, 0x4D, 0x43, // Z
-  0x00, 0x7F, 0x41, 0x41, 0x41,
-  0x02, 0x04, 0x08, 0x10, 0x20,
-  0x00, 0x41, 0x41, 0x41, 0x7F,
-  0x04, 0x02, 0x01, 0x02, 0x04,
-  0x40, 0x40, 0x40, 0x40, 0x40,
-  0x00, 0x03, 0x07, 0x08, 0x00,
-  0x20, 0x54, 0x54, 0x78, 0x40, // a
-  0x7F, 0x28, 0x44, 0x44, 0x38, // b
-  0x38, 0x44, 0x44, 0x44, 0x28, // c
-  0x38, 0x44, 0x44, 0x28, 0x7F, // d
-  0x38, 0x54, 0x54, 0x54, 0x18, // e
-  0x00, 0x08, 0x7E, 0x09, 0x02, // f
-  0x18, 0xA4, 0xA4, 0x9C, 0x78, // g
-  0x7F, 0x08, 0x04, 0x04, 0x78, // h
-  0x00, 0x44, 0x7D, 0x40, 0x00, // i
-  0x20, 0x40, 0x40, 0x3D, 0x00, // j
-  0x7F, 0x10, 0x28, 0x44, 0x00, // k
-  0x00, 0x41, 0x7F, 0x40, 0x00, // l
-  0x7C, 0x04, 0x78, 0x04, 0x78, // m
-  0x7C, 0x08, 0x04, 0x04, 0x78, // n
-  0x38, 0x44, 0x44, 0x44, 0x38, // o
-  0xFC, 0x18, 0x24, 0x24, 0x18, // p
-  0x18, 0x24, 0x24, 0x18, 0xFC, // q
-  0x7C, 0x08, 0x04, 0x04, 0x08, // r
-  0x48, 0x54, 0x54, 0x54, 0x24, // s
-  0x04, 0x04, 0x3F, 0x44, 0x24, // t
-  0x3C, 0x40, 0x40, 0x20, 0x7C, // u
-  0x1C, 0x20, 0x40, 0x20, 0x1C, // v
-  0x3C, 0x40, 0x30, 0x40, 0x3C, // w
-  0x44, 0x28, 0x10, 0x28, 0x44, // x
-  0x4C, 0x90, 0x90, 0x90, 0x7C, // y
-  0x44, 0x64, 0x54, 0x4C, 0x44, // z
-  0x00, 0x08, 0x36, 0x41, 0x00,
-  0x00, 0x00, 0x77, 0x00, 0x00,
-  0x00, 0x41, 0x36, 0x08, 0x00,
-  0x02, 0x01, 0x02, 0x04, 0x02,
-  0x3C, 0x26, 0x23, 0x26, 0x3C,
-  0x1E, 0xA1, 0xA1, 0x61, 0x12,
-  0x3A, 0x40, 0x40, 0x20, 0x7A,
-  0x38, 0x54, 0x54, 0x55, 0x59,
-  0x21, 0x55, 0x55, 0x79, 0x41,
-  0x21, 0x54, 0x54, 0x78, 0x41,
-  0x21, 0x55, 0x54, 0x78, 0x40,
-  0x20, 0x54, 0x55, 0x79, 0x40,
-  0x0C, 0x1E, 0x52, 0x72, 0x12,
-  0x39, 0x55, 0x55, 0x55, 0x59,
-  0x39, 0x54, 0x54, 0x54, 0x59,
-  0x39, 0x55, 0x54, 0x54, 0x58,
-  0x00, 0x00, 0x45, 0x7C, 0x41,
-  0x00, 0x02, 0x45, 0x7D, 0x42,
-  0x00, 0x01, 0x45, 0x7C, 0x40,
-  0xF0, 0x29, 0x24, 0x29, 0xF0,
-  0xF0, 0x28, 0x25, 0x28, 0xF0,
-  0x7C, 0x54, 0x55, 0x45, 0x00,
-  0x20, 0x54, 0x54, 0x7C, 0x54,
-  0x7C, 0x0A, 0x09, 0x7F, 0x49,
-  0x32, 0x49, 0x49, 0x49, 0x32,
-  0x32, 0x48, 0x48, 0x48, 0x32,
-  0x32, 0x4A, 0x48, 0x48, 0x30,
-  0x3A, 0x41, 0x41, 0x21, 0x7A,
-  0x3A, 0x42, 0x40, 0x20, 0x78,
-  0x00, 0x9D, 0xA0, 0xA0, 0x7D,
-  0x39, 0x44, 0x44, 0x44, 0x39,
-  0x3D, 0x40, 0x40, 0x40, 0x3D,
-  0x3C, 0x24, 0xFF, 0x24, 0x24,
-  0x48, 0x7E, 0x49, 0x43, 0x66,
-  0x2B, 0x2F, 0xFC, 0x2F, 0x2B,
-  0xFF, 0x09, 0x29, 0xF6, 0x20,
-  0xC0, 0x88, 0x7E, 0x09, 0x03,
-  0x20, 0x54, 0x54, 0x79, 0x41,
-  0x00, 0x00, 0x44, 0x7D, 0x41,
-  0x30, 0x48, 0x48, 0x4A, 0x32,
-  0x38, 0x40, 0x40, 0x22, 0x7A,
-  0x00, 0x7A, 0x0A, 0x0A, 0x72,
-  0x7D, 0x0D, 0x19, 0x31, 0x7D,
-  0x26, 0x29, 0x29, 0x2F, 0x28,
-  0x26, 0x29, 0x29, 0x29, 0x26,
-  0x30, 0x48, 0x4D, 0x40, 0x20,
-  0x38, 0x08, 0x08, 0x08, 0x08,
-  0x08, 0x08, 0x08, 0x08, 0x38,
-  0x2F, 0x10, 0xC8, 0xAC, 0xBA,
-  0x2F, 0x10, 0x28, 0x34, 0xFA,
-  0x00, 0x00, 0x7B, 0x00, 0x00,
-  0x08, 0x14, 0x2A, 0x14, 0x22,
-  0x22, 0x14, 0x2A, 0x14, 0x08,
-  0xAA, 0x00, 0x55, 0x00, 0xAA,
-  0xAA, 0x55, 0xAA, 0x55, 0xAA,
-  0x00, 0x00, 0x00, 0xFF, 0x00,
-  0x10, 0x10, 0x10, 0xFF, 0x00,
-  0x14, 0x14, 0x14, 0xFF, 0x00,
-  0x10, 0x10, 0xFF, 0x00, 0xFF,
-  0x10, 0x10, 0xF0, 0x10, 0xF0,
-  0x14, 0x14, 0x14, 0xFC, 0x00,
-  0x14, 0x14, 0xF7, 0x00, 0xFF,
-  0x00, 0x00, 0xFF, 0x00, 0xFF,
-  0x14, 0x14, 0xF4, 0x04, 0xFC,
-  0x14, 0x14, 0x17, 0x10, 0x1F,
-  0x10, 0x10, 0x1F, 0x10, 0x1F,
-  0x14, 0x14, 0x14, 0x1F, 0x00,
-  0x10, 0x10, 0x10, 0xF0, 0x00,
-  0x00, 0x00, 0x00, 0x1F, 0x10,
-  0x10, 0x10, 0x10, 0x1F, 0x10,
-  0x10, 0x10, 0x10, 0xF0, 0x10,
-  0x00, 0x00, 0x00, 0xFF, 0x10,
-  0x10, 0x10, 0x10, 0x10, 0x10,
-  0x10, 0x10, 0x10, 0xFF, 0x10,
-  0x00, 0x00, 0x00, 0xFF, 0x14,
-  0x00, 0x00, 0xFF, 0x00, 0xFF,
-  0x00, 0x00, 0x1F, 0x10, 0x17,
-  0x00, 0x00, 0xFC, 0x04, 0xF4,
-  0x14, 0x14, 0x17, 0x10, 0x17,
-  0x14, 0x14, 0xF4, 0x04, 0xF4,
-  0x00, 0x00, 0xFF, 0x00, 0xF7,
-  0x14, 0x14, 0x14, 0x14, 0x14,
-  0x14, 0x14, 0xF7, 0x00, 0xF7,
-  0x14, 0x14, 0x14, 0x17, 0x14,
-  0x10, 0x10, 0x1F, 0x10, 0x1F,
-  0x14, 0x14, 0x14, 0xF4, 0x14,
-  0x10, 0x10, 0xF0, 0x10, 0xF0,
-  0x00, 0x00, 0x1F, 0x10, 0x1F,
-  0x00, 0x00, 0x00, 0x1F, 0x14,
-  0x00, 0x00, 0x00, 0xFC, 0x14,
-  0x00, 0x00, 0xF0, 0x10, 0xF0,
-  0x10, 0x10, 0xFF, 0x10, 0xFF,
-  0x14, 0x14, 0x14, 0xFF, 0x14,
-  0x10, 0x10, 0x10, 0x1F, 0x00,
-  0x00, 0x00, 0x00, 0xF0, 0x10,
-  0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-  0xF0, 0xF0, 0xF0, 0xF0, 0xF0,
-  0xFF, 0xFF, 0xFF, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0xFF, 0xFF,
-  0x0F, 0x0F, 0x0F, 0x0F, 0x0F,
-  0x38, 0x44, 0x44, 0x38, 0x44,
-  0x7C, 0x2A, 0x2A, 0x3E, 0x14,
-  0x7E, 0x02, 0x02, 0x06, 0x06,
-  0x02, 0x7E, 0x02, 0x7E, 0x02,
-  0x63, 0x55, 0x49, 0x41, 0x63,
-  0x38, 0x44, 0x44, 0x3C, 0x04,
-  0x40, 0x7E, 0x20, 0x1E, 0x20,
-  0x06, 0x02, 0x7E, 0x02, 0x02,
-  0x99, 0xA5, 0xE7, 0xA5, 0x99,
-  0x1C, 0x2A, 0x49, 0x2A, 0x1C,
-  0x4C, 0x72, 0x01, 0x72, 0x4C,
-  0x30, 0x4A, 0x4D, 0x4D, 0x30,
-  0x30, 0x48, 0x78, 0x48, 0x30,
-  0xBC, 0x62, 0x5A, 0x46, 0x3D,
-  0x3E, 0x49, 0x49, 0x49, 0x00,
-  0x7E, 0x01, 0x01, 0x01, 0x7E,
-  0x2A, 0x2A, 0x2A, 0x2A, 0x2A,
-  0x44, 0x44, 0x5F, 0x44, 0x44,
-  0x40, 0x51, 0x4A, 0x44, 0x40,
-  0x40, 0x44, 0x4A, 0x51, 0x40,
-  0x00, 0x00, 0xFF, 0x01, 0x03,
-  0xE0, 0x80, 0xFF, 0x00, 0x00,
-  0x08, 0x08, 0x6B, 0x6B, 0x08,
-  0x36, 0x12, 0x36, 0x24, 0x36,
-  0x06, 0x0F, 0x09, 0x0F, 0x06,
-  0x00, 0x00, 0x18, 0x18, 0x00,
-  0x00, 0x00, 0x10, 0x10, 0x00,
-  0x30, 0x40, 0xFF, 0x01, 0x01,
-  0x00, 0x1F, 0x01, 0x01, 0x1E,
-  0x00, 0x19, 0x1D, 0x17, 0x12,
-  0x00, 0x3C, 0x3C, 0x3C, 0x3C,
-  0x00, 0x00, 0x00, 0x00, 0x00,
+// Transposed from the original column-major table into rows so
+// text can be streamed a whole row at a time: 8 bytes per
+// character, top row first, bit 0 is the leftmost column and
+// bits 5 to 7 are always clear (the blank column between characters)
+static const uint8_t FontRow[] = {
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x0E, 0x1F, 0x15, 0x1F, 0x1B, 0x11, 0x0E, 0x00,
+  0x0E, 0x1F, 0x15, 0x1F, 0x11, 0x1B, 0x0E, 0x00,
+  0x00, 0x0A, 0x1F, 0x1F, 0x1F, 0x0E, 0x04, 0x00,
+  0x00, 0x04, 0x0E, 0x1F, 0x1F, 0x0E, 0x04, 0x00,
+  0x0E, 0x0A, 0x1F, 0x15, 0x1F, 0x04, 0x0E, 0x00,
+  0x04, 0x0E, 0x1F, 0x1F, 0x1F, 0x04, 0x0E, 0x00,
+  0x00, 0x00, 0x04, 0x0E, 0x0E, 0x04, 0x00, 0x00,
+  0x1F, 0x1F, 0x1B, 0x11, 0x11, 0x1B, 0x1F, 0x1F,
+  0x00, 0x00, 0x04, 0x0A, 0x0A, 0x04, 0x00, 0x00,
+  0x1F, 0x1F, 0x1B, 0x15, 0x15, 0x1B, 0x1F, 0x1F,
+  0x00, 0x1C, 0x18, 0x16, 0x05, 0x05, 0x02, 0x00,
+  0x0E, 0x11, 0x11, 0x0E, 0x04, 0x1F, 0x04, 0x00,
+  0x1E, 0x12, 0x1E, 0x02, 0x02, 0x02, 0x03, 0x00,
+  0x1E, 0x12, 0x1E, 0x12, 0x12, 0x1A, 0x03, 0x00,
+  0x04, 0x15, 0x0E, 0x1B, 0x1B, 0x0E, 0x15, 0x04,
+  0x01, 0x03, 0x0F, 0x1F, 0x0F, 0x03, 0x01, 0x00,
+  0x10, 0x18, 0x1E, 0x1F, 0x1E, 0x18, 0x10, 0x00,
+  0x04, 0x0E, 0x15, 0x04, 0x15, 0x0E, 0x04, 0x00,
+  0x1B, 0x1B, 0x1B, 0x1B, 0x1B, 0x00, 0x1B, 0x00,
+  0x1E, 0x15, 0x15, 0x16, 0x14, 0x14, 0x14, 0x00,
+  0x0C, 0x12, 0x0A, 0x14, 0x08, 0x12, 0x12, 0x0C,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x1F, 0x1F, 0x00,
+  0x04, 0x0E, 0x15, 0x04, 0x15, 0x0E, 0x04, 0x1F,
+  0x00, 0x04, 0x0E, 0x15, 0x04, 0x04, 0x04, 0x00,
+  0x00, 0x04, 0x04, 0x04, 0x15, 0x0E, 0x04, 0x00,
+  0x00, 0x04, 0x08, 0x1F, 0x08, 0x04, 0x00, 0x00,
+  0x00, 0x04, 0x02, 0x1F, 0x02, 0x04, 0x00, 0x00,
+  0x00, 0x01, 0x01, 0x01, 0x1F, 0x00, 0x00, 0x00,
+  0x00, 0x0A, 0x1F, 0x1F, 0x0A, 0x00, 0x00, 0x00,
+  0x00, 0x04, 0x04, 0x0E, 0x1F, 0x1F, 0x00, 0x00,
+  0x00, 0x1F, 0x1F, 0x0E, 0x04, 0x04, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x04, 0x00,
+  0x0A, 0x0A, 0x0A, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x0A, 0x0A, 0x1F, 0x0A, 0x1F, 0x0A, 0x0A, 0x00,
+  0x04, 0x1E, 0x05, 0x0E, 0x14, 0x0F, 0x04, 0x00,
+  0x03, 0x13, 0x08, 0x04, 0x02, 0x19, 0x18, 0x00,
+  0x02, 0x05, 0x05, 0x02, 0x15, 0x09, 0x16, 0x00,
+  0x0C, 0x0C, 0x04, 0x02, 0x00, 0x00, 0x00, 0x00,
+  0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08, 0x00,
+  0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02, 0x00,
+  0x04, 0x15, 0x0E, 0x1F, 0x0E, 0x15, 0x04, 0x00,
+  0x00, 0x04, 0x04, 0x1F, 0x04, 0x04, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C, 0x04, 0x02,
+  0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C, 0x00,
+  0x00, 0x10, 0x08, 0x04, 0x02, 0x01, 0x00, 0x00,
+  0x0E, 0x11, 0x19, 0x15, 0x13, 0x11, 0x0E, 0x00,
+  0x04, 0x06, 0x04, 0x04, 0x04, 0x04, 0x0E, 0x00,
+  0x0E, 0x11, 0x10, 0x0E, 0x01, 0x01, 0x1F, 0x00,
+  0x1F, 0x10, 0x08, 0x0C, 0x10, 0x11, 0x0E, 0x00,
+  0x08, 0x0C, 0x0A, 0x09, 0x1F, 0x08, 0x08, 0x00,
+  0x1F, 0x01, 0x0F, 0x10, 0x10, 0x11, 0x0E, 0x00,
+  0x1C, 0x02, 0x01, 0x0F, 0x11, 0x11, 0x0E, 0x00,
+  0x1F, 0x10, 0x10, 0x08, 0x04, 0x02, 0x01, 0x00,
+  0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E, 0x00,
+  0x0E, 0x11, 0x11, 0x1E, 0x10, 0x08, 0x07, 0x00,
+  0x00, 0x00, 0x04, 0x00, 0x04, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x04, 0x00, 0x04, 0x04, 0x02, 0x00,
+  0x10, 0x08, 0x04, 0x02, 0x04, 0x08, 0x10, 0x00,
+  0x00, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x00, 0x00,
+  0x02, 0x04, 0x08, 0x10, 0x08, 0x04, 0x02, 0x00,
+  0x0E, 0x11, 0x10, 0x0C, 0x04, 0x00, 0x04, 0x00,
+  0x0E, 0x11, 0x15, 0x1D, 0x0D, 0x01, 0x1E, 0x00,
+  0x04, 0x0A, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x00,
+  0x0F, 0x11, 0x11, 0x0F, 0x11, 0x11, 0x0F, 0x00,
+  0x0E, 0x11, 0x01, 0x01, 0x01, 0x11, 0x0E, 0x00,
+  0x0F, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0F, 0x00,
+  0x1F, 0x01, 0x01, 0x0F, 0x01, 0x01, 0x1F, 0x00,
+  0x1F, 0x01, 0x01, 0x0F, 0x01, 0x01, 0x01, 0x00,
+  0x1E, 0x11, 0x01, 0x01, 0x19, 0x11, 0x1E, 0x00,
+  0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11, 0x00,
+  0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E, 0x00,
+  0x1C, 0x08, 0x08, 0x08, 0x08, 0x09, 0x06, 0x00,
+  0x11, 0x09, 0x05, 0x03, 0x05, 0x09, 0x11, 0x00,
+  0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x1F, 0x00,
+  0x11, 0x1B, 0x15, 0x15, 0x15, 0x11, 0x11, 0x00,
+  0x11, 0x11, 0x13, 0x15, 0x19, 0x11, 0x11, 0x00,
+  0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E, 0x00,
+  0x0F, 0x11, 0x11, 0x0F, 0x01, 0x01, 0x01, 0x00,
+  0x0E, 0x11, 0x11, 0x11, 0x15, 0x09, 0x16, 0x00,
+  0x0F, 0x11, 0x11, 0x0F, 0x05, 0x09, 0x11, 0x00,
+  0x0E, 0x11, 0x01, 0x0E, 0x10, 0x11, 0x0E, 0x00,
+  0x1F, 0x15, 0x04, 0x04, 0x04, 0x04, 0x04, 0x00,
+  0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E, 0x00,
+  0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04, 0x00,
+  0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A, 0x00,
+  0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11, 0x00,
+  0x11, 0x11, 0x0A, 0x04, 0x04, 0x04, 0x04, 0x00,
+  0x1F, 0x10, 0x08, 0x0E, 0x02, 0x01, 0x1F, 0x00,
+  0x1E, 0x02, 0x02, 0x02, 0x02, 0x02, 0x1E, 0x00,
+  0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00, 0x00,
+  0x1E, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1E, 0x00,
+  0x04, 0x0A, 0x11, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F, 0x00,
+  0x06, 0x06, 0x04, 0x08, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x06, 0x08, 0x0E, 0x09, 0x1E, 0x00,
+  0x01, 0x01, 0x0D, 0x13, 0x11, 0x13, 0x0D, 0x00,
+  0x00, 0x00, 0x0E, 0x11, 0x01, 0x11, 0x0E, 0x00,
+  0x10, 0x10, 0x16, 0x19, 0x11, 0x19, 0x16, 0x00,
+  0x00, 0x00, 0x0E, 0x11, 0x1F, 0x01, 0x0E, 0x00,
+  0x08, 0x14, 0x04, 0x0E, 0x04, 0x04, 0x04, 0x00,
+  0x00, 0x00, 0x0E, 0x19, 0x19, 0x16, 0x10, 0x0E,
+  0x01, 0x01, 0x0D, 0x13, 0x11, 0x11, 0x11, 0x00,
+  0x04, 0x00, 0x06, 0x04, 0x04, 0x04, 0x0E, 0x00,
+  0x08, 0x00, 0x08, 0x08, 0x08, 0x09, 0x06, 0x00,
+  0x01, 0x01, 0x09, 0x05, 0x03, 0x05, 0x09, 0x00,
+  0x06, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E, 0x00,
+  0x00, 0x00, 0x0B, 0x15, 0x15, 0x15, 0x15, 0x00,
+  0x00, 0x00, 0x0D, 0x13, 0x11, 0x11, 0x11, 0x00,
+  0x00, 0x00, 0x0E, 0x11, 0x11, 0x11, 0x0E, 0x00,
+  0x00, 0x00, 0x0D, 0x13, 0x13, 0x0D, 0x01, 0x01,
+  0x00, 0x00, 0x16, 0x19, 0x19, 0x16, 0x10, 0x10,
+  0x00, 0x00, 0x0D, 0x13, 0x01, 0x01, 0x01, 0x00,
+  0x00, 0x00, 0x1E, 0x01, 0x0E, 0x10, 0x0F, 0x00,
+  0x04, 0x04, 0x1F, 0x04, 0x04, 0x14, 0x08, 0x00,
+  0x00, 0x00, 0x11, 0x11, 0x11, 0x19, 0x16, 0x00,
+  0x00, 0x00, 0x11, 0x11, 0x11, 0x0A, 0x04, 0x00,
+  0x00, 0x00, 0x11, 0x11, 0x15, 0x15, 0x0A, 0x00,
+  0x00, 0x00, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x00,
+  0x00, 0x00, 0x11, 0x11, 0x1E, 0x10, 0x11, 0x0E,
+  0x00, 0x00, 0x1F, 0x08, 0x04, 0x02, 0x1F, 0x00,
+  0x08, 0x04, 0x04, 0x02, 0x04, 0x04, 0x08, 0x00,
+  0x04, 0x04, 0x04, 0x00, 0x04, 0x04, 0x04, 0x00,
+  0x02, 0x04, 0x04, 0x08, 0x04, 0x04, 0x02, 0x00,
+  0x02, 0x15, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x04, 0x0E, 0x1B, 0x11, 0x11, 0x1F, 0x00, 0x00,
+  0x0E, 0x11, 0x01, 0x01, 0x11, 0x0E, 0x08, 0x06,
+  0x00, 0x11, 0x00, 0x11, 0x11, 0x19, 0x16, 0x00,
+  0x18, 0x00, 0x0E, 0x11, 0x1F, 0x01, 0x1E, 0x00,
+  0x1F, 0x00, 0x06, 0x08, 0x0E, 0x09, 0x1E, 0x00,
+  0x11, 0x00, 0x06, 0x08, 0x0E, 0x09, 0x1E, 0x00,
+  0x03, 0x00, 0x06, 0x08, 0x0E, 0x09, 0x1E, 0x00,
+  0x0C, 0x00, 0x06, 0x08, 0x0E, 0x09, 0x1E, 0x00,
+  0x00, 0x1E, 0x03, 0x03, 0x1E, 0x08, 0x0C, 0x00,
+  0x1F, 0x00, 0x0E, 0x11, 0x1F, 0x01, 0x1E, 0x00,
+  0x11, 0x00, 0x0E, 0x11, 0x1F, 0x01, 0x1E, 0x00,
+  0x03, 0x00, 0x0E, 0x11, 0x1F, 0x01, 0x1E, 0x00,
+  0x14, 0x00, 0x0C, 0x08, 0x08, 0x08, 0x1C, 0x00,
+  0x0C, 0x12, 0x0C, 0x08, 0x08, 0x08, 0x1C, 0x00,
+  0x06, 0x00, 0x0C, 0x08, 0x08, 0x08, 0x1C, 0x00,
+  0x0A, 0x00, 0x04, 0x0A, 0x11, 0x1F, 0x11, 0x11,
+  0x04, 0x00, 0x04, 0x0A, 0x11, 0x1F, 0x11, 0x11,
+  0x0C, 0x00, 0x0F, 0x01, 0x07, 0x01, 0x0F, 0x00,
+  0x00, 0x00, 0x1E, 0x08, 0x1E, 0x09, 0x1E, 0x00,
+  0x1C, 0x0A, 0x09, 0x1F, 0x09, 0x09, 0x19, 0x00,
+  0x0E, 0x11, 0x00, 0x0E, 0x11, 0x11, 0x0E, 0x00,
+  0x00, 0x11, 0x00, 0x0E, 0x11, 0x11, 0x0E, 0x00,
+  0x00, 0x03, 0x00, 0x0E, 0x11, 0x11, 0x0E, 0x00,
+  0x0E, 0x11, 0x00, 0x11, 0x11, 0x19, 0x16, 0x00,
+  0x00, 0x03, 0x00, 0x11, 0x11, 0x19, 0x16, 0x00,
+  0x12, 0x00, 0x12, 0x12, 0x12, 0x1C, 0x10, 0x0E,
+  0x11, 0x00, 0x0E, 0x11, 0x11, 0x11, 0x0E, 0x00,
+  0x11, 0x00, 0x11, 0x11, 0x11, 0x11, 0x0E, 0x00,
+  0x04, 0x04, 0x1F, 0x05, 0x05, 0x1F, 0x04, 0x04,
+  0x0C, 0x1A, 0x12, 0x07, 0x02, 0x12, 0x1F, 0x00,
+  0x1B, 0x1B, 0x0E, 0x1F, 0x04, 0x1F, 0x04, 0x04,
+  0x07, 0x09, 0x09, 0x07, 0x09, 0x1D, 0x09, 0x09,
+  0x18, 0x14, 0x04, 0x0E, 0x04, 0x04, 0x05, 0x03,
+  0x18, 0x00, 0x06, 0x08, 0x0E, 0x09, 0x1E, 0x00,
+  0x18, 0x00, 0x0C, 0x08, 0x08, 0x08, 0x1C, 0x00,
+  0x00, 0x18, 0x00, 0x0E, 0x11, 0x11, 0x0E, 0x00,
+  0x00, 0x18, 0x00, 0x11, 0x11, 0x19, 0x16, 0x00,
+  0x00, 0x1E, 0x00, 0x0E, 0x12, 0x12, 0x12, 0x00,
+  0x1F, 0x00, 0x13, 0x17, 0x1D, 0x19, 0x11, 0x00,
+  0x0E, 0x09, 0x09, 0x1E, 0x00, 0x1F, 0x00, 0x00,
+  0x0E, 0x11, 0x11, 0x0E, 0x00, 0x1F, 0x00, 0x00,
+  0x04, 0x00, 0x04, 0x06, 0x01, 0x11, 0x0E, 0x00,
+  0x00, 0x00, 0x00, 0x1F, 0x01, 0x01, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x1F, 0x10, 0x10, 0x00, 0x00,
+  0x01, 0x11, 0x09, 0x1D, 0x12, 0x19, 0x04, 0x1C,
+  0x01, 0x11, 0x09, 0x15, 0x1A, 0x1D, 0x10, 0x10,
+  0x04, 0x04, 0x00, 0x04, 0x04, 0x04, 0x04, 0x00,
+  0x00, 0x14, 0x0A, 0x05, 0x0A, 0x14, 0x00, 0x00,
+  0x00, 0x05, 0x0A, 0x14, 0x0A, 0x05, 0x00, 0x00,
+  0x04, 0x11, 0x04, 0x11, 0x04, 0x11, 0x04, 0x11,
+  0x0A, 0x15, 0x0A, 0x15, 0x0A, 0x15, 0x0A, 0x15,
+  0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08,
+  0x08, 0x08, 0x08, 0x08, 0x0F, 0x08, 0x08, 0x08,
+  0x08, 0x08, 0x0F, 0x08, 0x0F, 0x08, 0x08, 0x08,
+  0x14, 0x14, 0x14, 0x14, 0x17, 0x14, 0x14, 0x14,
+  0x00, 0x00, 0x00, 0x00, 0x1F, 0x14, 0x14, 0x14,
+  0x00, 0x00, 0x0F, 0x08, 0x0F, 0x08, 0x08, 0x08,
+  0x14, 0x14, 0x17, 0x10, 0x17, 0x14, 0x14, 0x14,
+  0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14,
+  0x00, 0x00, 0x1F, 0x10, 0x17, 0x14, 0x14, 0x14,
+  0x14, 0x14, 0x17, 0x10, 0x1F, 0x00, 0x00, 0x00,
+  0x14, 0x14, 0x14, 0x14, 0x1F, 0x00, 0x00, 0x00,
+  0x08, 0x08, 0x0F, 0x08, 0x0F, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x0F, 0x08, 0x08, 0x08,
+  0x08, 0x08, 0x08, 0x08, 0x18, 0x00, 0x00, 0x00,
+  0x08, 0x08, 0x08, 0x08, 0x1F, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x1F, 0x08, 0x08, 0x08,
+  0x08, 0x08, 0x08, 0x08, 0x18, 0x08, 0x08, 0x08,
+  0x00, 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00,
+  0x08, 0x08, 0x08, 0x08, 0x1F, 0x08, 0x08, 0x08,
+  0x08, 0x08, 0x18, 0x08, 0x18, 0x08, 0x08, 0x08,
+  0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14,
+  0x14, 0x14, 0x14, 0x04, 0x1C, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x1C, 0x04, 0x14, 0x14, 0x14, 0x14,
+  0x14, 0x14, 0x17, 0x00, 0x1F, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x1F, 0x00, 0x17, 0x14, 0x14, 0x14,
+  0x14, 0x14, 0x14, 0x04, 0x14, 0x14, 0x14, 0x14,
+  0x00, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x00, 0x00,
+  0x14, 0x14, 0x17, 0x00, 0x17, 0x14, 0x14, 0x14,
+  0x08, 0x08, 0x1F, 0x00, 0x1F, 0x00, 0x00, 0x00,
+  0x14, 0x14, 0x14, 0x14, 0x1F, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x1F, 0x00, 0x1F, 0x08, 0x08, 0x08,
+  0x00, 0x00, 0x00, 0x00, 0x1F, 0x14, 0x14, 0x14,
+  0x14, 0x14, 0x14, 0x14, 0x1C, 0x00, 0x00, 0x00,
+  0x08, 0x08, 0x18, 0x08, 0x18, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x18, 0x08, 0x18, 0x08, 0x08, 0x08,
+  0x00, 0x00, 0x00, 0x00, 0x1C, 0x14, 0x14, 0x14,
+  0x14, 0x14, 0x14, 0x14, 0x1F, 0x14, 0x14, 0x14,
+  0x08, 0x08, 0x1F, 0x08, 0x1F, 0x08, 0x08, 0x08,
+  0x08, 0x08, 0x08, 0x08, 0x0F, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x18, 0x08, 0x08, 0x08,
+  0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F,
+  0x00, 0x00, 0x00, 0x00, 0x1F, 0x1F, 0x1F, 0x1F,
+  0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07,
+  0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18,
+  0x1F, 0x1F, 0x1F, 0x1F, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x16, 0x09, 0x09, 0x09, 0x16, 0x00,
+  0x00, 0x0E, 0x19, 0x0F, 0x19, 0x0F, 0x01, 0x00,
+  0x00, 0x1F, 0x19, 0x01, 0x01, 0x01, 0x01, 0x00,
+  0x00, 0x1F, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x00,
+  0x1F, 0x11, 0x02, 0x04, 0x02, 0x11, 0x1F, 0x00,
+  0x00, 0x00, 0x1E, 0x09, 0x09, 0x09, 0x06, 0x00,
+  0x00, 0x0A, 0x0A, 0x0A, 0x0A, 0x16, 0x03, 0x00,
+  0x00, 0x1F, 0x05, 0x04, 0x04, 0x04, 0x04, 0x00,
+  0x1F, 0x04, 0x0E, 0x11, 0x11, 0x0E, 0x04, 0x1F,
+  0x04, 0x0A, 0x11, 0x1F, 0x11, 0x0A, 0x04, 0x00,
+  0x04, 0x0A, 0x11, 0x11, 0x0A, 0x0A, 0x1B, 0x00,
+  0x0C, 0x02, 0x0C, 0x0E, 0x11, 0x11, 0x0E, 0x00,
+  0x00, 0x00, 0x00, 0x0E, 0x15, 0x15, 0x0E, 0x00,
+  0x10, 0x0E, 0x19, 0x15, 0x15, 0x13, 0x0E, 0x01,
+  0x0E, 0x01, 0x01, 0x0F, 0x01, 0x01, 0x0E, 0x00,
+  0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x00,
+  0x00, 0x1F, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x00,
+  0x04, 0x04, 0x1F, 0x04, 0x04, 0x00, 0x1F, 0x00,
+  0x02, 0x04, 0x08, 0x04, 0x02, 0x00, 0x1F, 0x00,
+  0x08, 0x04, 0x02, 0x04, 0x08, 0x00, 0x1F, 0x00,
+  0x1C, 0x14, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04,
+  0x04, 0x04, 0x04, 0x04, 0x04, 0x05, 0x05, 0x07,
+  0x0C, 0x0C, 0x00, 0x1F, 0x00, 0x0C, 0x0C, 0x00,
+  0x00, 0x17, 0x1D, 0x00, 0x17, 0x1D, 0x00, 0x00,
+  0x0E, 0x1B, 0x1B, 0x0E, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x0C, 0x0C, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x0C, 0x00, 0x00, 0x00,
+  0x1C, 0x04, 0x04, 0x04, 0x05, 0x05, 0x06, 0x04,
+  0x0E, 0x12, 0x12, 0x12, 0x12, 0x00, 0x00, 0x00,
+  0x0E, 0x18, 0x0C, 0x06, 0x1E, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x1E, 0x1E, 0x1E, 0x1E, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
 };
 
 
@@ -490,6 +591,44 @@ static enum initRFlags TabColor;
 static int16_t _width = ST7735_TFTWIDTH;   // this could probably be a constant, except it is used in Adafruit_GFX and depends on image rotation
 static int16_t _height = ST7735_TFTHEIGHT;
 
+// The selected panel.  The variables above and below describe it;
+// ST7735_SelectPanel() keeps them in the Panel_t of each panel while
+// another one is selected.
+static Panel_t DefaultPanel = {0, 0, 0x40, 0x80};  // SSI0, DC on PA6, RESET on PA7
+static Panel_t *Panel = &DefaultPanel;
+static uint32_t SSIBase = 0x40008000;  // SSI0
+static uint32_t CSAddr = 0x40004020;   // PA3
+static uint32_t DCAddr = 0x40004100;   // PA6
+static uint32_t ResetAddr = 0x40004200;// PA7
+static uint8_t DMAChannel = DMA_CH_SSI0TX;
+
+// SSI modules that can drive a panel, with the pins of SCK, CS (Fss)
+// and MOSI (Tx), all alternate function 2
+static const struct ssiPort{
+  uint32_t base;                   // SSI registers
+  uint32_t gpio;                   // GPIO port of SCK, CS and MOSI
+  uint8_t port;                    // its number, 0 for port A
+  uint8_t pins;                    // SCK, CS and MOSI
+  uint8_t cs;                      // CS
+  uint8_t dmaChannel;              // uDMA channel of the transmitter
+} SSIPorts[2] = {
+  {0x40008000, 0x40004000, 0, 0x2C, 0x08, DMA_CH_SSI0TX}, // SSI0: PA2, PA3, PA5
+  {0x4000A000, 0x40005000, 1, 0xB0, 0x20, DMA_CH_SSI2TX}  // SSI2: PB4, PB5, PB7
+};
+static const uint32_t GPIOPorts[6] = {
+  0x40004000, 0x40005000, 0x40006000, 0x40007000, 0x40024000, 0x40025000
+};                                 // ports A to F
+
+// uDMA pixel transfer state, see ST7735_FillRectAsync()
+static volatile uint8_t DMABusy;   // 1 while a fill or bitmap is streaming
+static uint8_t SSIWide;            // 1 while the SSI is set to 16-bit frames
+static uint8_t Pixel12;            // 1 in 12-bit color mode, see ST7735_SetColorMode()
+static int32_t PixPending = -1;    // 12-bit pixel waiting for its partner, or -1
+static uint32_t TxCount;           // bytes sent to the LCD, see ST7735_GetTxCount()
+static uint16_t WinCols = 0xFFFF;  // last CASET start<<8|end sent, 0xFFFF if unknown
+static uint16_t WinRows = 0xFFFF;  // last RASET start<<8|end sent, 0xFFFF if unknown
+static uint32_t SavedCount;        // CASET/RASET bytes skipped, see ST7735_GetSavedCount()
+static uint32_t WindowCount;       // address windows set, see ST7735_GetWindowCount()
 
 // The Data/Command pin must be valid when the eighth bit is
 // sent.  The SSI module has hardware input and output FIFOs
@@ -499,6 +638,7 @@ static int16_t _height = ST7735_TFTHEIGHT;
 // commands, and they are used when writing data.  This
 // ensures that the Data/Command pin status matches the byte
 // that is actually being transmitted.
+// Pixel data are not sent through writedata(); see pixelStart().
 // The write command operation waits until all data has been
 // sent, configures the Data/Command pin for commands, sends
 // the command, and then waits for the transmission to
@@ -507,22 +647,427 @@ static int16_t _height = ST7735_TFTHEIGHT;
 // transmit FIFO, configures the Data/Command pin for data,
 // and then adds the data to the transmit FIFO.
 // NOTE: These functions will crash or stall indefinitely if
-// the SSI0 module is not initialized and enabled.
+// the SSI module is not initialized and enabled.
+// Both also finish any uDMA pixel transfer first.
 void static writecommand(uint8_t c) {
-                                        // wait until SSI0 not busy/transmit FIFO empty
-  while((SSI0_SR_R&SSI_SR_BSY)==SSI_SR_BSY){};
+  if(DMABusy || SSIWide || (PixPending >= 0)) ST7735_WaitIdle();
+                                        // wait until SSI not busy/transmit FIFO empty
+  while((SSI_SR_R&SSI_SR_BSY)==SSI_SR_BSY){POLL();}
+  TxCount++;
   DC = DC_COMMAND;
-  SSI0_DR_R = c;                        // data out
-                                        // wait until SSI0 not busy/transmit FIFO empty
-  while((SSI0_SR_R&SSI_SR_BSY)==SSI_SR_BSY){};
+  SSI_WRITE(c);                         // data out
+                                        // wait until SSI not busy/transmit FIFO empty
+  while((SSI_SR_R&SSI_SR_BSY)==SSI_SR_BSY){POLL();}
 }
 
 
 void static writedata(uint8_t c) {
-  while((SSI0_SR_R&SSI_SR_TNF)==0){};   // wait until transmit FIFO not full
+  if(DMABusy || SSIWide || (PixPending >= 0)) ST7735_WaitIdle();
+  while((SSI_SR_R&SSI_SR_TNF)==0){POLL();} // wait until transmit FIFO not full
+  TxCount++;
+  DC = DC_DATA;
+  SSI_WRITE(c);                         // data out
+}
+
+// uDMA pixel engine
+// Pixel data are streamed by uDMA channel 11 (SSI0 Tx, or channel
+// 13 for SSI2) so the CPU is free while a fill or bitmap goes out.
+// During a transfer the SSI is switched to 16-bit frames, so one uDMA item is one pixel and
+// the bytes on the wire are the same as two writedata() calls (most
+// significant byte first).  A basic mode transfer moves at most
+// 1024 items, so fills are sent in 1024-pixel pieces from a single
+// non-incrementing source word, and bitmaps are sent one row per
+// piece.  The uDMA raises the SSI interrupt when a piece is done
+// and its handler starts the next one.
+// The uDMA cannot read flash, so rows of a const image are copied
+// into one of two RAM line buffers; the next row is copied while
+// the current one is streaming.
+// In 12-bit color mode the SSI stays in 8-bit frames and every pixel
+// goes through the line buffers, packed two pixels to three bytes;
+// fills resend one buffer of the packed color pattern.
+// Only the primary control structures are used, but the table
+// must be aligned to 1024 bytes.
+#pragma DATA_ALIGN(DMAControlTable, 1024)
+static uint32_t DMAControlTable[256];
+static uint16_t DMALine[2][DMA_LINEMAX];  // staging for rows in flash
+static uint8_t DMALineSel;                // line buffer holding next row
+static uint8_t DMAStaged;                 // 1 if rows go through DMALine
+static int32_t DMAKey;                    // color replaced while staging, or -1
+static uint16_t DMAKeyFill;               // color that replaces DMAKey
+static uint16_t DMAFillColor;             // source word for fills
+static const uint16_t *DMASrc;            // first pixel of next bitmap row
+static int32_t DMARowStride;              // halfwords from one row to the next
+static uint16_t DMARowWidth;              // 0 for fills, else pixels per row
+static uint32_t DMARemaining;             // pixels (fill) or rows (bitmap) left
+static void (*DMADone)(void);             // completion callback, may be null
+static uint16_t DMAPackLen[2];            // 12-bit mode: bytes in each line buffer
+static int32_t DMACarry;                  // 12-bit mode: odd pixel for the next row, or -1
+static uint8_t DMABpp;                    // 4 or 8 for a palette-indexed bitmap, else 0
+static const uint8_t *DMAIndex;           // indexed: first byte of next bitmap row
+static int32_t DMAIndexStride;            // indexed: bytes from one row to the next
+static uint16_t DMAIndexCol;              // indexed: first column sent from each row
+static const uint16_t *DMAPalette;        // indexed: colors for each index
+#define DMA_PATTERNBYTES (sizeof(DMALine)/3*3)  // 12-bit fill pattern length
+
+// Change the SSI frame size, which may only be done while the
+// module is disabled.  Waits for the transmitter to go idle.
+void static ssiFrameSize(uint32_t dss){
+  while((SSI_SR_R&SSI_SR_BSY)==SSI_SR_BSY){POLL();}
+  SSI_CR1_R &= ~SSI_CR1_SSE;            // disable SSI
+  SSI_CR0_R = (SSI_CR0_R&~SSI_CR0_DSS_M)+dss;
+  SSI_CR1_R |= SSI_CR1_SSE;             // enable SSI
+}
+
+// Enter pixel mode after RAMWR: SSI in 16-bit frames with the
+// Data/Command pin high, so each pixel is one FIFO write.  The
+// next writecommand() or writedata() returns to 8-bit frames.
+// In 12-bit color mode the frames stay 8 bits.
+void static pixelStart(void){
+  if((SSIWide == 0) && (Pixel12 == 0)){
+    ssiFrameSize(SSI_CR0_DSS_16);
+    SSIWide = 1;
+  }
   DC = DC_DATA;
-  SSI0_DR_R = c;                        // data out
 }
+
+// RGB565 (as made by ST7735_Color565) to 12-bit color, keeping the
+// top 4 bits of each component in the same order.
+uint16_t static color444(uint16_t c){
+  return ((c>>4)&0x0F00)|((c>>3)&0x00F0)|((c>>1)&0x000F);
+}
+
+// Send one byte of pixel data in 12-bit color mode.
+void static pixelByte(uint8_t b){
+  while((SSI_SR_R&SSI_SR_TNF)==0){POLL();} // wait until transmit FIFO not full
+  TxCount++;
+  SSI_WRITE(b);
+}
+
+// 12-bit color mode pixel: pixels are sent in pairs as three bytes,
+// so the first of a pair waits in PixPending.  ST7735_WaitIdle()
+// sends a lone last pixel as two bytes.
+void static pushPixel12(uint16_t color){
+  uint16_t c = color444(color);
+  if(PixPending < 0){
+    PixPending = c;
+  } else{
+    pixelByte(PixPending>>4);
+    pixelByte(((PixPending&0x0F)<<4)|(c>>8));
+    pixelByte(c);
+    PixPending = -1;
+  }
+}
+
+// Palette-indexed bitmap: color of one column of the current row,
+// with the transparent index (DMAKey) replaced.  4-bit rows hold
+// two pixels per byte, left pixel in the high nibble.
+uint16_t static dmaIndexPixel(uint32_t col){
+  uint8_t v;
+  if(DMABpp == 8){
+    v = DMAIndex[col];
+  } else{
+    v = DMAIndex[col>>1];
+    v = (col&0x01) ? (v&0x0F) : (v>>4);
+  }
+  return (v == DMAKey) ? DMAKeyFill : DMAPalette[v];
+}
+
+// Palette-indexed bitmap: expand one row into a line buffer.  The
+// palette lookup is the only work per pixel, so a 4-bit image
+// streams at the same rate as a 16-bit one from a quarter of the
+// flash.
+void static dmaIndexRow(uint16_t *dst, uint16_t n){
+  const uint8_t *src;
+  uint32_t col = DMAIndexCol;
+  uint8_t v;
+  if((DMABpp == 8) && (DMAKey < 0)){
+    src = &DMAIndex[col];
+    while(n--){
+      *dst++ = DMAPalette[*src++];
+    }
+    return;
+  }
+  if((DMABpp == 4) && (DMAKey < 0)){
+    src = &DMAIndex[col>>1];
+    if(col&0x01){                       // clipped on an odd column
+      *dst++ = DMAPalette[*src++&0x0F];
+      n--;
+    }
+    for(; n>=2; n=n-2){
+      v = *src++;
+      *dst++ = DMAPalette[v>>4];
+      *dst++ = DMAPalette[v&0x0F];
+    }
+    if(n){
+      *dst = DMAPalette[*src>>4];
+    }
+    return;
+  }
+  while(n--){
+    *dst++ = dmaIndexPixel(col++);
+  }
+}
+
+// Move the bitmap source to the next row.
+void static dmaNextRow(void){
+  if(DMABpp){
+    DMAIndex = DMAIndex + DMAIndexStride;
+  } else{
+    DMASrc = DMASrc + DMARowStride;
+  }
+}
+
+// Copy one row of pixels into the line buffer that is not
+// currently being read by the uDMA, replacing the color key.
+void static dmaStageRow(const uint16_t *src, uint16_t n){
+  uint16_t *dst = DMALine[DMALineSel];
+  if(DMABpp){
+    dmaIndexRow(dst, n);
+  } else if(DMAKey < 0){
+    while(n--){
+      *dst++ = *src++;
+    }
+  } else{
+    while(n--){
+      *dst++ = (*src == DMAKey) ? DMAKeyFill : *src;
+      src++;
+    }
+  }
+}
+
+// 12-bit color mode: pack one row into the line buffer that is not
+// currently being read by the uDMA, replacing the color key.  An odd
+// pixel is carried into the next row, so pairs span rows just as
+// the panel sees them; the last row of a transfer sends it alone.
+// A row of one pixel can pack to nothing, so dmaBegin() sends
+// one pixel wide transfers without the uDMA.
+void static dmaPackRow(const uint16_t *src, uint16_t n){
+  uint8_t *dst = (uint8_t *)DMALine[DMALineSel];
+  uint16_t len = 0;
+  uint16_t c;
+  uint32_t col = DMAIndexCol;
+  while(n--){
+    if(DMABpp){
+      c = dmaIndexPixel(col++);
+    } else{
+      c = *src++;
+      if((DMAKey >= 0) && (c == DMAKey)) c = DMAKeyFill;
+    }
+    c = color444(c);
+    if(DMACarry < 0){
+      DMACarry = c;
+    } else{
+      dst[len++] = DMACarry>>4;
+      dst[len++] = ((DMACarry&0x0F)<<4)|(c>>8);
+      dst[len++] = c;
+      DMACarry = -1;
+    }
+  }
+  if((DMARemaining == 1) && (DMACarry >= 0)){
+    dst[len++] = DMACarry>>4;
+    dst[len++] = (DMACarry&0x0F)<<4;
+    DMACarry = -1;
+  }
+  DMAPackLen[DMALineSel] = len;
+}
+
+// 12-bit color mode version of dmaNext(): byte items, fills resend
+// the packed pattern, bitmap rows come from the packed line buffers.
+void static dmaNext12(void){
+  uint32_t n;
+  const uint8_t *src;
+  if(DMARowWidth == 0){                 // fill, DMARemaining counts bytes
+    n = DMARemaining;
+    if(n > DMA_PATTERNBYTES) n = DMA_PATTERNBYTES;
+    DMARemaining -= n;
+    src = (const uint8_t *)DMALine + n - 1;
+  } else{
+    n = DMAPackLen[DMALineSel];
+    DMARemaining--;
+    src = (const uint8_t *)DMALine[DMALineSel] + n - 1;
+    DMALineSel ^= 1;
+    dmaNextRow();
+  }
+  TxCount = TxCount + n;
+  DMAControlTable[4*DMAChannel + 0] = (uint32_t)src;  // source end pointer
+  DMAControlTable[4*DMAChannel + 1] = (uint32_t)&SSI_DR_R;
+  DMAControlTable[4*DMAChannel + 2] = UDMA_CHCTL_SRCINC_8 | UDMA_CHCTL_DSTINC_NONE |
+    UDMA_CHCTL_SRCSIZE_8 | UDMA_CHCTL_DSTSIZE_8 | UDMA_CHCTL_ARBSIZE_4 |
+    ((n - 1)<<UDMA_CHCTL_XFERSIZE_S) | UDMA_CHCTL_XFERMODE_BASIC;
+  DMA_ENABLE(DMAChannel);
+  if(DMARowWidth && DMARemaining){      // prepare the following row
+    dmaPackRow(DMASrc, DMARowWidth);
+  }
+}
+
+// Program and enable the next piece of the current transfer.
+void static dmaNext(void){
+  uint32_t n, control;
+  const uint16_t *src;
+  if(Pixel12){
+    dmaNext12();
+    return;
+  }
+  if(DMARowWidth == 0){                 // fill, source does not move
+    n = DMARemaining;
+    if(n > DMA_MAXITEMS) n = DMA_MAXITEMS;
+    DMARemaining -= n;
+    src = &DMAFillColor;
+    control = UDMA_CHCTL_SRCINC_NONE;
+  } else{                               // bitmap, one row per piece
+    n = DMARowWidth;
+    DMARemaining--;
+    if(DMAStaged){
+      src = &DMALine[DMALineSel][n - 1];
+      DMALineSel ^= 1;
+    } else{
+      src = &DMASrc[n - 1];
+    }
+    dmaNextRow();
+    control = UDMA_CHCTL_SRCINC_16;
+  }
+  TxCount = TxCount + 2*n;
+  DMAControlTable[4*DMAChannel + 0] = (uint32_t)src;  // source end pointer
+  DMAControlTable[4*DMAChannel + 1] = (uint32_t)&SSI_DR_R;
+  DMAControlTable[4*DMAChannel + 2] = control | UDMA_CHCTL_DSTINC_NONE |
+    UDMA_CHCTL_SRCSIZE_16 | UDMA_CHCTL_DSTSIZE_16 | UDMA_CHCTL_ARBSIZE_4 |
+    ((n - 1)<<UDMA_CHCTL_XFERSIZE_S) | UDMA_CHCTL_XFERMODE_BASIC;
+  DMA_ENABLE(DMAChannel);
+  if(DMAStaged && DMARemaining){         // prepare the following row
+    dmaStageRow(DMASrc, DMARowWidth);
+  }
+}
+
+// Start the transfer described by the DMA* variables.  The
+// address window and RAMWR must already have been sent.
+void static dmaBegin(void){
+  uint8_t *pattern;
+  uint16_t c;
+  uint32_t i;
+  void (*done)(void);
+  pixelStart();
+  if(Pixel12){
+    if(DMARowWidth == 0){               // fill: pattern of packed pixel pairs
+      c = color444(DMAFillColor);
+      pattern = (uint8_t *)DMALine;
+      for(i=0; i<DMA_PATTERNBYTES; i=i+3){
+        pattern[i] = c>>4;
+        pattern[i+1] = ((c&0x0F)<<4)|(c>>8);
+        pattern[i+2] = c;
+      }
+      DMARemaining = 3*(DMARemaining/2) + 2*(DMARemaining&0x01);
+    } else if(DMARowWidth == 1){        // too narrow to pack, send by polling
+      for(; DMARemaining; DMARemaining--){
+        if(DMABpp){
+          c = dmaIndexPixel(DMAIndexCol);
+        } else{
+          c = *DMASrc;
+          if((DMAKey >= 0) && (c == DMAKey)) c = DMAKeyFill;
+        }
+        pushPixel12(c);
+        dmaNextRow();
+      }
+      done = DMADone;
+      DMADone = 0;
+      if(done) done();
+      return;
+    } else{
+      DMACarry = -1;
+      DMAStaged = 1;
+      dmaPackRow(DMASrc, DMARowWidth);
+    }
+    DMABusy = 1;
+    dmaNext12();
+    SSI_DMACTL_R |= SSI_DMACTL_TXDMAE; // start requests
+    return;
+  }
+  if(DMAStaged){
+    dmaStageRow(DMASrc, DMARowWidth);
+  }
+  DMABusy = 1;
+  dmaNext();
+  SSI_DMACTL_R |= SSI_DMACTL_TXDMAE;    // start requests
+}
+
+// Turn on the uDMA controller and route channel 11 to SSI0 Tx, or
+// channel 13 to SSI2 Tx for a panel on SSI2.
+void static dmaInit(void){
+  SYSCTL_RCGCDMA_R |= 0x01;             // activate uDMA
+  while((SYSCTL_PRDMA_R&0x01)==0){};    // allow time for clock to start
+  UDMA_CFG_R = UDMA_CFG_MASTEN;
+  UDMA_CTLBASE_R = (uint32_t)DMAControlTable;
+  if(DMAChannel == DMA_CH_SSI0TX){
+    UDMA_CHMAP1_R &= ~UDMA_CHMAP1_CH11SEL_M;  // encoding 0 is SSI0 Tx
+  } else{                                     // encoding 2 is SSI2 Tx
+    UDMA_CHMAP1_R = (UDMA_CHMAP1_R&~UDMA_CHMAP1_CH13SEL_M)|(2<<UDMA_CHMAP1_CH13SEL_S);
+  }
+  UDMA_PRIOCLR_R = (1<<DMAChannel);   // default priority
+  UDMA_ALTCLR_R = (1<<DMAChannel);    // primary control structure
+  UDMA_USEBURSTCLR_R = (1<<DMAChannel);   // single and burst requests
+  UDMA_REQMASKCLR_R = (1<<DMAChannel);
+  DMABusy = 0;
+  SSIWide = 0;
+  if(DMAChannel == DMA_CH_SSI0TX){
+    NVIC_PRI1_R = (NVIC_PRI1_R&0x00FFFFFF)|0x40000000; // SSI0 priority 2
+    NVIC_EN0_R = INT_SSI0_BIT;          // enable interrupt 7 in NVIC
+  } else{
+    NVIC_PRI14_R = (NVIC_PRI14_R&0xFFFF00FF)|0x00004000; // SSI2 priority 2
+    NVIC_EN1_R = INT_SSI2_BIT;          // enable interrupt 57 in NVIC
+  }
+}
+
+// Raised by the uDMA each time a piece of a pixel transfer
+// completes.  Only the selected panel streams, so SSI0 and SSI2
+// share it.
+void static dmaInterrupt(void){
+  void (*done)(void);
+  UDMA_CHIS_R = (1<<DMAChannel);      // acknowledge
+  if(DMARemaining){
+    dmaNext();
+    return;
+  }
+  SSI_DMACTL_R &= ~SSI_DMACTL_TXDMAE;
+  DMABusy = 0;
+  done = DMADone;
+  DMADone = 0;
+  if(done) done();
+}
+
+// Interrupt service routines for SSI0 and SSI2.
+// Must be placed in the vector table as the SSI0 and SSI2 handlers.
+void SSI0Handler(void){
+  dmaInterrupt();
+}
+void SSI2Handler(void){
+  dmaInterrupt();
+}
+
+//------------ST7735_Busy------------
+// Check for a uDMA pixel transfer in progress.
+// Input: none
+// Output: 1 if a transfer is still streaming, 0 if idle
+int ST7735_Busy(void){
+  return DMABusy;
+}
+
+//------------ST7735_WaitIdle------------
+// Wait for any uDMA pixel transfer to finish and put the SSI back
+// into 8-bit frames for commands.
+// Input: none
+// Output: none
+void ST7735_WaitIdle(void){
+  while(DMABusy){POLL();}
+  if(PixPending >= 0){                  // lone last 12-bit pixel
+    pixelByte(PixPending>>4);
+    pixelByte((PixPending&0x0F)<<4);
+    PixPending = -1;
+  }
+  if(SSIWide){
+    ssiFrameSize(SSI_CR0_DSS_8);
+    SSIWide = 0;
+  }
+}
+
 // Subroutine to wait 1 msec
 // Inputs: None
 // Outputs: None
@@ -684,6 +1229,7 @@ void static commandList(const uint8_t *addr) {
   uint16_t ms;
 
   numCommands = *(addr++);               // Number of commands to follow
+  WinCols = WinRows = 0xFFFF;            // lists may set the window
   while(numCommands--) {                 // For each command...
     writecommand(*(addr++));             //   Read, issue command
     numArgs  = *(addr++);                //   Number of args to follow
@@ -702,23 +1248,60 @@ void static commandList(const uint8_t *addr) {
 }
 
 
+// Make pins of a GPIO port digital outputs.
+void static gpioOut(uint32_t port, uint8_t pins){
+  uint32_t i, pctl = 0;
+  for(i=0; i<8; i=i+1){
+    if(pins&(1<<i)) pctl |= 0x0F<<(4*i);
+  }
+  GPIO_REG(port, GPIO_O_DIR) |= pins;   // make out
+  GPIO_REG(port, GPIO_O_AFSEL) &= ~pins;// disable alt funct
+  GPIO_REG(port, GPIO_O_DEN) |= pins;   // enable digital I/O
+  GPIO_REG(port, GPIO_O_PCTL) &= ~pctl; // configure as GPIO
+  GPIO_REG(port, GPIO_O_AMSEL) &= ~pins;// disable analog functionality
+}
+
+// Give pins of a GPIO port to their SSI module (alternate function 2).
+void static gpioSSI(uint32_t port, uint8_t pins){
+  uint32_t i, pctl = 0;
+  for(i=0; i<8; i=i+1){
+    if(pins&(1<<i)) pctl |= 0x0F<<(4*i);
+  }
+  GPIO_REG(port, GPIO_O_AFSEL) |= pins; // enable alt funct
+  GPIO_REG(port, GPIO_O_DEN) |= pins;   // enable digital I/O
+  GPIO_REG(port, GPIO_O_PCTL) = (GPIO_REG(port, GPIO_O_PCTL)&~pctl)+(pctl&0x22222222);
+  GPIO_REG(port, GPIO_O_AMSEL) &= ~pins;// disable analog functionality
+}
+
+// Point the pin and SSI register addresses at a panel.
+void static panelPins(const Panel_t *panel){
+  const struct ssiPort *ssi = &SSIPorts[panel->ssi == 2];
+  SSIBase = ssi->base;
+  CSAddr = ssi->gpio + (ssi->cs<<2);
+  DCAddr = GPIOPorts[panel->port] + (panel->dc<<2);
+  ResetAddr = GPIOPorts[panel->port] + (panel->reset<<2);
+  DMAChannel = ssi->dmaChannel;
+}
+
 // Initialization code common to both 'B' and 'R' type displays
 void static commonInit(const uint8_t *cmdList) {
   volatile uint32_t delay;
+  const struct ssiPort *ssi = &SSIPorts[Panel->ssi == 2];
+  uint32_t ports = (1<<ssi->port)|(1<<Panel->port);
   ColStart  = RowStart = 0; // May be overridden in init func
+  Rotation = 0;
+  _width = ST7735_TFTWIDTH;
+  _height = ST7735_TFTHEIGHT;
+  panelPins(Panel);
 
-  SYSCTL_RCGCSSI_R |= 0x01;  // activate SSI0
-  SYSCTL_RCGCGPIO_R |= 0x01; // activate port A
-  while((SYSCTL_PRGPIO_R&0x01)==0){}; // allow time for clock to start
+  SYSCTL_RCGCSSI_R |= 1<<Panel->ssi;    // activate SSI0 or SSI2
+  SYSCTL_RCGCGPIO_R |= ports;           // activate ports of the pins
+  while((SYSCTL_PRGPIO_R&ports)!=ports){}; // allow time for clock to start
 
   // toggle RST low to reset; CS low so it'll listen to us
-  // SSI0Fss is temporarily used as GPIO
-  GPIO_PORTA_DIR_R |= 0xC8;             // make PA3,6,7 out
-  GPIO_PORTA_AFSEL_R &= ~0xC8;          // disable alt funct on PA3,6,7
-  GPIO_PORTA_DEN_R |= 0xC8;             // enable digital I/O on PA3,6,7
-                                        // configure PA3,6,7 as GPIO
-  GPIO_PORTA_PCTL_R = (GPIO_PORTA_PCTL_R&0x00FF0FFF)+0x00000000;
-  GPIO_PORTA_AMSEL_R &= ~0xC8;          // disable analog functionality on PA3,6,7
+  // Fss is temporarily used as GPIO
+  gpioOut(GPIOPorts[Panel->port], Panel->dc|Panel->reset);
+  gpioOut(ssi->gpio, ssi->cs);
   TFT_CS = TFT_CS_LOW;
   RESET = RESET_HIGH;
   Delay1ms(500);
@@ -727,30 +1310,29 @@ void static commonInit(const uint8_t *cmdList) {
   RESET = RESET_HIGH;
   Delay1ms(500);
 
-  // initialize SSI0
-  GPIO_PORTA_AFSEL_R |= 0x2C;           // enable alt funct on PA2,3,5
-  GPIO_PORTA_DEN_R |= 0x2C;             // enable digital I/O on PA2,3,5
-                                        // configure PA2,3,5 as SSI
-  GPIO_PORTA_PCTL_R = (GPIO_PORTA_PCTL_R&0xFF0F00FF)+0x00202200;
-  GPIO_PORTA_AMSEL_R &= ~0x2C;          // disable analog functionality on PA2,3,5
-  SSI0_CR1_R &= ~SSI_CR1_SSE;           // disable SSI
-  SSI0_CR1_R &= ~SSI_CR1_MS;            // master mode
+  // initialize SSI
+  gpioSSI(ssi->gpio, ssi->pins);        // SCK, CS and MOSI
+  SSI_CR1_R &= ~SSI_CR1_SSE;            // disable SSI
+  SSI_CR1_R &= ~SSI_CR1_MS;             // master mode
                                         // configure for system clock/PLL baud clock source
-  SSI0_CC_R = (SSI0_CC_R&~SSI_CC_CS_M)+SSI_CC_CS_SYSPLL;
+  SSI_CC_R = (SSI_CC_R&~SSI_CC_CS_M)+SSI_CC_CS_SYSPLL;
 //                                        // clock divider for 3.125 MHz SSIClk (50 MHz PIOSC/16)
-//  SSI0_CPSR_R = (SSI0_CPSR_R&~SSI_CPSR_CPSDVSR_M)+16;
+//  SSI_CPSR_R = (SSI_CPSR_R&~SSI_CPSR_CPSDVSR_M)+16;
                                         // clock divider for 8 MHz SSIClk (80 MHz PLL/24)
                                         // SysClk/(CPSDVSR*(1+SCR))
                                         // 80/(10*(1+0)) = 8 MHz (slower than 4 MHz)
-  SSI0_CPSR_R = (SSI0_CPSR_R&~SSI_CPSR_CPSDVSR_M)+10; // must be even number
-  SSI0_CR0_R &= ~(SSI_CR0_SCR_M |       // SCR = 0 (8 Mbps data rate)
-                  SSI_CR0_SPH |         // SPH = 0
-                  SSI_CR0_SPO);         // SPO = 0
+  SSI_CPSR_R = (SSI_CPSR_R&~SSI_CPSR_CPSDVSR_M)+10; // must be even number
+  SSI_CR0_R &= ~(SSI_CR0_SCR_M |        // SCR = 0 (8 Mbps data rate)
+                 SSI_CR0_SPH |          // SPH = 0
+                 SSI_CR0_SPO);          // SPO = 0
                                         // FRF = Freescale format
-  SSI0_CR0_R = (SSI0_CR0_R&~SSI_CR0_FRF_M)+SSI_CR0_FRF_MOTO;
+  SSI_CR0_R = (SSI_CR0_R&~SSI_CR0_FRF_M)+SSI_CR0_FRF_MOTO;
                                         // DSS = 8-bit data
-  SSI0_CR0_R = (SSI0_CR0_R&~SSI_CR0_DSS_M)+SSI_CR0_DSS_8;
-  SSI0_CR1_R |= SSI_CR1_SSE;            // enable SSI
+  SSI_CR0_R = (SSI_CR0_R&~SSI_CR0_DSS_M)+SSI_CR0_DSS_8;
+  SSI_CR1_R |= SSI_CR1_SSE;             // enable SSI
+  dmaInit();
+  Pixel12 = 0;                          // init lists select 16-bit color
+  PixPending = -1;
 
   if(cmdList) commandList(cmdList);
 }
@@ -764,6 +1346,7 @@ void ST7735_InitB(void) {
   commonInit(Bcmd);
   ST7735_SetCursor(0,0);
   StTextColor = ST7735_YELLOW;
+  StTextBgColor = ST7735_BLACK;
   ST7735_FillScreen(0);                 // set screen to black
 }
 
@@ -792,43 +1375,120 @@ void ST7735_InitR(enum initRFlags option) {
   TabColor = option;
   ST7735_SetCursor(0,0);
   StTextColor = ST7735_YELLOW;
+  StTextBgColor = ST7735_BLACK;
   ST7735_FillScreen(0);                 // set screen to black
 }
 
 
+//------------ST7735_SelectPanel------------
+// Make all following calls draw on the given panel.  Any transfer
+// still streaming to the current panel is finished first, so
+// transfers to two panels take turns.  The geometry, rotation,
+// address window, color mode, cursor and text colors of each panel
+// are kept in its Panel_t.  The scrolling console, strip chart and
+// waterfall belong to the panel they were started on, and sprites
+// to the panel they were drawn on; select it before using them.
+// Input: panel  pointer to the panel, its pins set; 0 for the panel
+//               wired as described at the top of this file
+// Output: none
+void ST7735_SelectPanel(Panel_t *panel){
+  if(panel == 0) panel = &DefaultPanel;
+  if(panel == Panel) return;
+  ST7735_TextFlush();                   // pending text is for the old panel
+  ST7735_WaitIdle();
+  Panel->colStart = ColStart;
+  Panel->rowStart = RowStart;
+  Panel->rotation = Rotation;
+  Panel->tabColor = TabColor;
+  Panel->pixel12 = Pixel12;
+  Panel->width = _width;
+  Panel->height = _height;
+  Panel->winCols = WinCols;
+  Panel->winRows = WinRows;
+  Panel->x = StX;
+  Panel->y = StY;
+  Panel->textColor = StTextColor;
+  Panel->textBgColor = StTextBgColor;
+  Panel->textBlank = TextBlank;         // a new line not written yet
+  Panel = panel;
+  ColStart = panel->colStart;
+  RowStart = panel->rowStart;
+  Rotation = panel->rotation;
+  TabColor = (enum initRFlags)panel->tabColor;
+  Pixel12 = panel->pixel12;
+  _width = panel->width;
+  _height = panel->height;
+  WinCols = panel->winCols;
+  WinRows = panel->winRows;
+  StX = panel->x;
+  StY = panel->y;
+  StTextColor = panel->textColor;
+  StTextBgColor = panel->textBgColor;
+  panelPins(panel);
+  textForget();
+  TextBlank = panel->textBlank;
+}
+
+
 // Set the region of the screen RAM to be modified
 // Pixel colors are sent left to right, top to bottom
-// (same as Font table is encoded; different from regular bitmap)
-// Requires 11 bytes of transmission
+// (same as FontRow table is encoded; different from regular bitmap)
+// The panel keeps the last column and row ranges, so CASET or
+// RASET is only sent if its range changed (e.g. a column of
+// pixels only needs RASET).  RAMWR always restarts at the
+// top left corner of the window.
+// Requires 1 to 11 bytes of transmission
+// Leaves SSI in pixel mode, ready for pushColor()
 void static setAddrWindow(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1) {
+  uint16_t cols = ((uint8_t)(x0+ColStart)<<8)|(uint8_t)(x1+ColStart);
+  uint16_t rows = ((uint8_t)(y0+RowStart)<<8)|(uint8_t)(y1+RowStart);
+
+  if(cols != WinCols){
+    writecommand(ST7735_CASET); // Column addr set
+    writedata(0x00);
+    writedata(x0+ColStart);     // XSTART
+    writedata(0x00);
+    writedata(x1+ColStart);     // XEND
+    WinCols = cols;
+  } else{
+    SavedCount = SavedCount + 5;
+  }
 
-  writecommand(ST7735_CASET); // Column addr set
-  writedata(0x00);
-  writedata(x0+ColStart);     // XSTART
-  writedata(0x00);
-  writedata(x1+ColStart);     // XEND
-
-  writecommand(ST7735_RASET); // Row addr set
-  writedata(0x00);
-  writedata(y0+RowStart);     // YSTART
-  writedata(0x00);
-  writedata(y1+RowStart);     // YEND
+  if(rows != WinRows){
+    writecommand(ST7735_RASET); // Row addr set
+    writedata(0x00);
+    writedata(y0+RowStart);     // YSTART
+    writedata(0x00);
+    writedata(y1+RowStart);     // YEND
+    WinRows = rows;
+  } else{
+    SavedCount = SavedCount + 5;
+  }
 
   writecommand(ST7735_RAMWR); // write to RAM
+  WindowCount++;
+  pixelStart();
 }
 
 
-// Send two bytes of data, most significant byte first
+// Send two bytes of data, most significant byte first, as one
+// 16-bit frame.  Only valid in pixel mode (after setAddrWindow()).
 // Requires 2 bytes of transmission
 void static pushColor(uint16_t color) {
-  writedata((uint8_t)(color >> 8));
-  writedata((uint8_t)color);
+  if(Pixel12){
+    pushPixel12(color);
+    return;
+  }
+  while((SSI_SR_R&SSI_SR_TNF)==0){POLL();} // wait until transmit FIFO not full
+  TxCount = TxCount + 2;
+  SSI_WRITE(color);                     // data out
 }
 
 
 //------------ST7735_DrawPixel------------
 // Color the pixel at the given coordinates with the given color.
-// Requires 13 bytes of transmission
+// Requires 13 bytes of transmission (8 if the column or row is the
+// same as the previous window, 3 if both are)
 // Input: x     horizontal position of the pixel, columns from the left edge
 //               must be less than 128
 //               0 is on the left, 126 is near the right
@@ -858,7 +1518,6 @@ void ST7735_DrawPixel(int16_t x, int16_t y, uint16_t color) {
 //        color 16-bit color, which can be produced by ST7735_Color565()
 // Output: none
 void ST7735_DrawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
-  uint8_t hi = color >> 8, lo = color;
 
   // Rudimentary clipping
   if((x >= _width) || (y >= _height)) return;
@@ -866,8 +1525,7 @@ void ST7735_DrawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
   setAddrWindow(x, y, x, y+h-1);
 
   while (h--) {
-    writedata(hi);
-    writedata(lo);
+    pushColor(color);
   }
 }
 
@@ -882,7 +1540,6 @@ void ST7735_DrawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
 //        color 16-bit color, which can be produced by ST7735_Color565()
 // Output: none
 void ST7735_DrawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
-  uint8_t hi = color >> 8, lo = color;
 
   // Rudimentary clipping
   if((x >= _width) || (y >= _height)) return;
@@ -890,8 +1547,7 @@ void ST7735_DrawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
   setAddrWindow(x, y, x+w-1, y);
 
   while (w--) {
-    writedata(hi);
-    writedata(lo);
+    pushColor(color);
   }
 }
 
@@ -903,6 +1559,7 @@ void ST7735_DrawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
 // Output: none
 void ST7735_FillScreen(uint16_t color) {
   ST7735_FillRect(0, 0, _width, _height, color);  // original
+  textReset(color);                     // console cells are all blank now
 //  screen is actually 129 by 161 pixels, x 0 to 128, y goes from 0 to 160
 }
 
@@ -917,20 +1574,203 @@ void ST7735_FillScreen(uint16_t color) {
 //        color 16-bit color, which can be produced by ST7735_Color565()
 // Output: none
 void ST7735_FillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
-  uint8_t hi = color >> 8, lo = color;
+  ST7735_FillRectAsync(x, y, w, h, color, 0);
+  ST7735_WaitIdle();
+}
 
+
+//------------ST7735_FillRectAsync------------
+// Start a uDMA fill of a rectangle and return right away.
+// Requires (11 + 2*w*h) bytes of transmission (assuming image fully on screen)
+// Input: x     horizontal position of the top left corner of the rectangle, columns from the left edge
+//        y     vertical position of the top left corner of the rectangle, rows from the top edge
+//        w     horizontal width of the rectangle
+//        h     vertical height of the rectangle
+//        color 16-bit color, which can be produced by ST7735_Color565()
+//        done  function called from the SSI interrupt when finished, or 0
+// Output: none
+void ST7735_FillRectAsync(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color, void (*done)(void)) {
   // rudimentary clipping (drawChar w/big text requires this)
-  if((x >= _width) || (y >= _height)) return;
+  if((x >= _width) || (y >= _height) || (w <= 0) || (h <= 0)){
+    if(done) done();
+    return;
+  }
   if((x + w - 1) >= _width)  w = _width  - x;
   if((y + h - 1) >= _height) h = _height - y;
 
-  setAddrWindow(x, y, x+w-1, y+h-1);
+  setAddrWindow(x, y, x+w-1, y+h-1);    // also waits for previous transfer
+
+  DMAFillColor = color;
+  DMARowWidth = 0;
+  DMARemaining = w*h;
+  DMAStaged = 0;
+  DMABpp = 0;
+  DMADone = done;
+  dmaBegin();
+}
+
+
+// Damage list
+// Rectangles that must be erased before the next frame is drawn.
+// Overlapping or touching rectangles are merged into their
+// bounding box, so each area is only sent once.  When the list
+// is full the new rectangle is merged with the entry whose
+// bounding box grows the least.
+#define DAMAGE_MAX 8
+struct rect{
+  int16_t x0, y0, x1, y1;   // inclusive corners
+};
+static struct rect Damage[DAMAGE_MAX];
+static uint8_t DamageCount;
+
+// Return the area of the bounding box of a and b.
+int32_t static rectUnionArea(const struct rect *a, const struct rect *b){
+  int32_t x0 = (a->x0 < b->x0) ? a->x0 : b->x0;
+  int32_t y0 = (a->y0 < b->y0) ? a->y0 : b->y0;
+  int32_t x1 = (a->x1 > b->x1) ? a->x1 : b->x1;
+  int32_t y1 = (a->y1 > b->y1) ? a->y1 : b->y1;
+  return (x1 - x0 + 1)*(y1 - y0 + 1);
+}
+
+// Grow a to the bounding box of a and b.
+void static rectMerge(struct rect *a, const struct rect *b){
+  if(b->x0 < a->x0) a->x0 = b->x0;
+  if(b->y0 < a->y0) a->y0 = b->y0;
+  if(b->x1 > a->x1) a->x1 = b->x1;
+  if(b->y1 > a->y1) a->y1 = b->y1;
+}
+
+// Return 1 if a and b overlap or share an edge.
+int static rectTouch(const struct rect *a, const struct rect *b){
+  return (a->x0 <= b->x1 + 1) && (b->x0 <= a->x1 + 1) &&
+         (a->y0 <= b->y1 + 1) && (b->y0 <= a->y1 + 1);
+}
 
-  for(y=h; y>0; y--) {
-    for(x=w; x>0; x--) {
-      writedata(hi);
-      writedata(lo);
+//------------ST7735_Damage------------
+// Mark a rectangle to be erased by the next ST7735_Flush().
+// Input: x     horizontal position of the top left corner of the rectangle, columns from the left edge
+//        y     vertical position of the top left corner of the rectangle, rows from the top edge
+//        w     horizontal width of the rectangle
+//        h     vertical height of the rectangle
+// Output: none
+void ST7735_Damage(int16_t x, int16_t y, int16_t w, int16_t h){
+  struct rect r;
+  int32_t i, best, grow, bestGrow;
+  r.x0 = x; r.y0 = y; r.x1 = x + w - 1; r.y1 = y + h - 1;
+  if(r.x0 < 0) r.x0 = 0;                // clip to the screen
+  if(r.y0 < 0) r.y0 = 0;
+  if(r.x1 >= _width) r.x1 = _width - 1;
+  if(r.y1 >= _height) r.y1 = _height - 1;
+  if((r.x0 > r.x1) || (r.y0 > r.y1)) return;
+  while(1){
+    // absorb every entry the new rectangle touches; merging can make
+    // it touch entries it did not touch before, so start over each time
+    i = 0;
+    while(i < DamageCount){
+      if(rectTouch(&Damage[i], &r)){
+        rectMerge(&r, &Damage[i]);
+        DamageCount--;
+        Damage[i] = Damage[DamageCount];
+        i = 0;
+      } else{
+        i++;
+      }
+    }
+    if(DamageCount < DAMAGE_MAX){
+      Damage[DamageCount] = r;
+      DamageCount++;
+      return;
     }
+    best = 0;                           // full, merge with the cheapest entry
+    bestGrow = 0x7FFFFFFF;
+    for(i=0; i<DamageCount; i=i+1){
+      grow = rectUnionArea(&Damage[i], &r) -
+             (Damage[i].x1 - Damage[i].x0 + 1)*(Damage[i].y1 - Damage[i].y0 + 1);
+      if(grow < bestGrow){
+        bestGrow = grow;
+        best = i;
+      }
+    }
+    // take it out of the list, since the bigger box may now
+    // overlap other entries, and absorb those too
+    rectMerge(&r, &Damage[best]);
+    DamageCount--;
+    Damage[best] = Damage[DamageCount];
+  }
+}
+
+//------------ST7735_Flush------------
+// Erase every rectangle marked by ST7735_Damage() and empty the list.
+// Requires (11 + 2*w*h) bytes of transmission per merged rectangle
+// Input: color 16-bit background color, which can be produced by ST7735_Color565()
+// Output: none
+void ST7735_Flush(uint16_t color){
+  uint32_t i;
+  for(i=0; i<DamageCount; i=i+1){
+    ST7735_FillRect(Damage[i].x0, Damage[i].y0, Damage[i].x1 - Damage[i].x0 + 1,
+                    Damage[i].y1 - Damage[i].y0 + 1, color);
+  }
+  DamageCount = 0;
+}
+
+//------------ST7735_GetTxCount------------
+// Number of bytes sent to the LCD (commands, arguments and pixels)
+// since the last call to ST7735_ClearTxCount().
+// Input: none
+// Output: byte count
+uint32_t ST7735_GetTxCount(void){
+  return TxCount;
+}
+
+//------------ST7735_ClearTxCount------------
+// Reset the counts returned by ST7735_GetTxCount(),
+// ST7735_GetSavedCount() and ST7735_GetWindowCount().
+// Input: none
+// Output: none
+void ST7735_ClearTxCount(void){
+  TxCount = 0;
+  SavedCount = 0;
+  WindowCount = 0;
+}
+
+//------------ST7735_GetSavedCount------------
+// Number of CASET/RASET bytes that did not have to be sent because
+// the address window range was already set, since the last call
+// to ST7735_ClearTxCount().
+// Input: none
+// Output: byte count
+uint32_t ST7735_GetSavedCount(void){
+  return SavedCount;
+}
+
+//------------ST7735_GetWindowCount------------
+// Number of address windows set up (each one a RAMWR command and
+// up to 11 bytes) since the last call to ST7735_ClearTxCount().
+// Input: none
+// Output: window count
+uint32_t ST7735_GetWindowCount(void){
+  return WindowCount;
+}
+
+//------------ST7735_SetColorMode------------
+// Select the number of bits per pixel sent to the panel.  In 12-bit
+// mode two pixels are packed into 3 bytes instead of 4, so fills,
+// bitmaps and text move 25% fewer bytes, at the cost of the lowest
+// bit of red and blue and the two lowest of green.  All functions
+// still take RGB565 colors (e.g. from ST7735_Color565()) and convert
+// them as they are sent.  ST7735_InitB()/ST7735_InitR() select
+// 16-bit mode.
+// Requires 2 bytes of transmission
+// Input: bits  12 or 16
+// Output: none
+void ST7735_SetColorMode(uint8_t bits){
+  writecommand(ST7735_COLMOD);
+  if(bits == 12){
+    writedata(0x03);                    // 12-bit color
+    Pixel12 = 1;
+  } else{
+    writedata(0x05);                    // 16-bit color
+    Pixel12 = 0;
   }
 }
 
@@ -974,65 +1814,817 @@ uint16_t ST7735_SwapColor(uint16_t x) {
 //        w     number of pixels wide
 //        h     number of pixels tall
 // Output: none
-// Must be less than or equal to 128 pixels wide by 160 pixels high
+// Parts of the image off any edge of the screen are not drawn
 void ST7735_DrawBitmap(int16_t x, int16_t y, const uint16_t *image, int16_t w, int16_t h){
-  int16_t skipC = 0;                      // non-zero if columns need to be skipped due to clipping
-  int16_t originalWidth = w;              // save this value; even if not all columns fit on the screen, the image is still this width in ROM
-  int i = w*(h - 1);
-
-  if((x >= _width) || ((y - h + 1) >= _height) || ((x + w) <= 0) || (y < 0)){
-    return;                             // image is totally off the screen, do nothing
-  }
-  if((w > _width) || (h > _height)){    // image is too wide for the screen, do nothing
-    //***This isn't necessarily a fatal error, but it makes the
-    //following logic much more complicated, since you can have
-    //an image that exceeds multiple boundaries and needs to be
-    //clipped on more than one side.
+  ST7735_DrawBitmapAsync(x, y, image, w, h, 0);
+  ST7735_WaitIdle();
+}
+
+
+// Clip and start a uDMA transfer of the w by h pixel rectangle of
+// an atlas whose top left corner is (sx,sy), to the screen with its
+// top left corner at (x,y).  The rectangle is clipped to the atlas,
+// then to the screen, on all four sides.  If key is 0 to 65535,
+// pixels of that color (index for an indexed atlas) are sent as
+// keyFill instead, which draws the image with transparent pixels
+// over a plain background.
+void static blit(const Atlas_t *atlas, const uint16_t *palette, int16_t sx, int16_t sy, int16_t w, int16_t h,
+                 int16_t x, int16_t y, int32_t key, uint16_t keyFill, void (*done)(void)){
+  int32_t row, rowSize;
+  if(sx < 0){ w = w + sx; x = x - sx; sx = 0; }   // source left of the atlas
+  if(sy < 0){ h = h + sy; y = y - sy; sy = 0; }   // source above the atlas
+  if((sx + w) > atlas->w) w = atlas->w - sx;
+  if((sy + h) > atlas->h) h = atlas->h - sy;
+  if(x < 0){ w = w + x; sx = sx - x; x = 0; }     // left of the screen
+  if(y < 0){ h = h + y; sy = sy - y; y = 0; }     // above the screen
+  if((x + w) > _width) w = _width - x;
+  if((y + h) > _height) h = _height - y;
+  if((w <= 0) || (h <= 0)){
+    if(done) done();
+    return;                             // nothing left on the screen
+  }
+
+  setAddrWindow(x, y, x+w-1, y+h-1);    // also waits for previous transfer
+
+  // the first row sent is source row sy; in a bottom up image it
+  // is counted from the end and the rows are walked backwards
+  row = atlas->topDown ? sy : (atlas->h - 1 - sy);
+  if(atlas->bpp == 16){
+    DMABpp = 0;
+    DMASrc = (const uint16_t *)atlas->image + row*atlas->w + sx;
+    DMARowStride = atlas->topDown ? atlas->w : -atlas->w;
+    DMAStaged = ((uint32_t)atlas->image < 0x20000000) || (key >= 0); // below SRAM means flash
+  } else{                               // indexed rows start on a byte
+    rowSize = (atlas->w*atlas->bpp + 7)/8;
+    DMABpp = atlas->bpp;
+    DMAIndex = (const uint8_t *)atlas->image + row*rowSize;
+    DMAIndexStride = atlas->topDown ? rowSize : -rowSize;
+    DMAIndexCol = sx;
+    DMAPalette = palette;
+    DMAStaged = 1;                      // always expanded into DMALine
+  }
+  DMARowWidth = w;
+  DMARemaining = h;
+  DMAKey = key;
+  DMAKeyFill = keyFill;
+  DMALineSel = 0;
+  DMADone = done;
+  dmaBegin();
+}
+
+// Clip and start a uDMA transfer of a whole BMP image with its
+// bottom left corner at (x,y).  bpp is 16 for an array of colors,
+// or 4 or 8 for an array of palette indexes.
+void static drawBitmap(int16_t x, int16_t y, const void *image, uint8_t bpp, const uint16_t *palette,
+                       int16_t w, int16_t h, int32_t key, uint16_t keyFill, void (*done)(void)){
+  Atlas_t bmp;
+  bmp.image = image;
+  bmp.bpp = bpp;
+  bmp.topDown = 0;                      // BMP rows are stored bottom up
+  bmp.w = w;
+  bmp.h = h;
+  blit(&bmp, palette, 0, 0, w, h, x, y - h + 1, key, keyFill, done);
+}
+
+
+//------------ST7735_DrawBitmapAsync------------
+// Start a uDMA transfer of a 16-bit color BMP image and return right
+// away.  The image format and clipping are the same as
+// ST7735_DrawBitmap().  The image must not change until the transfer
+// is done; an image in flash is copied through a RAM line buffer.
+// Requires (11 + 2*w*h) bytes of transmission (assuming image fully on screen)
+// Input: x     horizontal position of the bottom left corner of the image, columns from the left edge
+//        y     vertical position of the bottom left corner of the image, rows from the top edge
+//        image pointer to a 16-bit color BMP image
+//        w     number of pixels wide
+//        h     number of pixels tall
+//        done  function called from the SSI interrupt when finished, or 0
+// Output: none
+void ST7735_DrawBitmapAsync(int16_t x, int16_t y, const uint16_t *image, int16_t w, int16_t h, void (*done)(void)){
+  drawBitmap(x, y, image, 16, 0, w, h, -1, 0, done);
+}
+
+//------------ST7735_DrawBitmapIndexed------------
+// Displays a palette-indexed BMP image.  Each pixel is a 4-bit or
+// 8-bit index into a table of 16-bit colors, which is looked up
+// while the rows are copied to the uDMA line buffers, so the image
+// takes a quarter or half the flash of ST7735_DrawBitmap() and can
+// be recolored by passing another palette.  Rows are stored bottom
+// up like ST7735_DrawBitmap(); each row starts on a byte, and in a
+// 4-bit image the left pixel of each byte is the high nibble.
+// Clipping is the same as ST7735_DrawBitmap().
+// Requires (11 + 2*w*h) bytes of transmission (assuming image fully on screen)
+// Input: x       horizontal position of the bottom left corner of the image, columns from the left edge
+//        y       vertical position of the bottom left corner of the image, rows from the top edge
+//        image   pointer to the indexes
+//        bpp     4 or 8 bits per index
+//        palette pointer to 16 or 256 16-bit colors
+//        w       number of pixels wide
+//        h       number of pixels tall
+// Output: none
+void ST7735_DrawBitmapIndexed(int16_t x, int16_t y, const uint8_t *image, uint8_t bpp,
+                              const uint16_t *palette, int16_t w, int16_t h){
+  if((bpp != 4) && (bpp != 8)) return;
+  drawBitmap(x, y, image, bpp, palette, w, h, -1, 0, 0);
+  ST7735_WaitIdle();
+}
+
+//------------ST7735_DrawAtlas------------
+// Draw a rectangle cut from a larger image (a texture atlas), so
+// the digits, paddles and balls of a game can all be kept in one
+// array.  The atlas may store its rows bottom up, like
+// ST7735_DrawBitmap(), or top down, and may be 16-bit colors or
+// 4-bit or 8-bit palette indexes, like ST7735_DrawBitmapIndexed().
+// The source rectangle is clipped to the atlas and the result to
+// the screen on all four sides, then sent through one window.
+// Requires (11 + 2*w*h) bytes of transmission (assuming image fully on screen)
+// Input: x       horizontal position of the top left corner on the screen, columns from the left edge
+//        y       vertical position of the top left corner on the screen, rows from the top edge
+//        atlas   pointer to the atlas description
+//        palette pointer to 16 or 256 16-bit colors, not used for a 16-bit atlas
+//        sx      left column of the source rectangle in the atlas
+//        sy      top row of the source rectangle in the atlas, counted from the top
+//        w       number of pixels wide
+//        h       number of pixels tall
+// Output: none
+void ST7735_DrawAtlas(int16_t x, int16_t y, const Atlas_t *atlas, const uint16_t *palette,
+                      int16_t sx, int16_t sy, int16_t w, int16_t h){
+  blit(atlas, palette, sx, sy, w, h, x, y, -1, 0, 0);
+  ST7735_WaitIdle();
+}
+
+//------------ST7735_DrawBitmapRLE------------
+// Display a run-length encoded 16-bit color image.  The image is a
+// list of 16-bit words made of two kinds of records:
+//   n, color                 n pixels (1 to 32767) of one color
+//   0x8000+n, c1, c2 ... cn  n pixels (1 to 32767) given one by one
+// Unlike ST7735_DrawBitmap() the rows are stored top row first, so
+// the pixels stream straight into one address window; runs are
+// sent without reading a color from flash per pixel.  Runs and
+// literals may continue from one row into the next.  tools/rleconv.c
+// converts an ordinary bitmap array.  Clipping is the same as
+// ST7735_DrawBitmap().
+// Requires (11 + 2*w*h) bytes of transmission (assuming image fully on screen)
+// Input: x     horizontal position of the bottom left corner of the image, columns from the left edge
+//        y     vertical position of the bottom left corner of the image, rows from the top edge
+//        rle   pointer to the encoded image
+//        w     number of pixels wide
+//        h     number of pixels tall
+// Output: none
+void ST7735_DrawBitmapRLE(int16_t x, int16_t y, const uint16_t *rle, int16_t w, int16_t h){
+  int32_t top = y - h + 1;              // screen row of the top of the image
+  int32_t cx0, cx1, cy0, cy1;           // visible part, in image coordinates
+  int32_t col = 0, row = 0;
+  int32_t n, k, i, lo, hi;
+  uint16_t word, color = 0;
+  uint8_t literal;
+  cx0 = (x < 0) ? -x : 0;
+  cx1 = ((x + w) > _width) ? (_width - x) : w;
+  cy0 = (top < 0) ? -top : 0;
+  cy1 = ((top + h) > _height) ? (_height - top) : h;
+  if((cx0 >= cx1) || (cy0 >= cy1)) return;
+
+  setAddrWindow(x+cx0, top+cy0, x+cx1-1, top+cy1-1);
+
+  while(row < cy1){
+    word = *rle++;
+    literal = (word&0x8000) ? 1 : 0;
+    n = word&0x7FFF;
+    if(!literal){
+      color = *rle++;
+    }
+    while(n > 0){
+      k = w - col;                      // part of the record on this row
+      if(k > n) k = n;
+      if(row >= cy0){
+        lo = (col > cx0) ? col : cx0;
+        hi = ((col + k) < cx1) ? (col + k) : cx1;
+        for(i=lo; i<hi; i=i+1){
+          pushColor(literal ? rle[i - col] : color);
+        }
+      }
+      if(literal) rle = rle + k;
+      n = n - k;
+      col = col + k;
+      if(col == w){
+        col = 0;
+        row = row + 1;
+        if(row >= cy1) break;
+      }
+    }
+  }
+}
+
+
+// Sprites
+// A sprite is a bitmap that moves over a plain background.  The
+// LCD cannot be read back, so the background under a sprite is
+// restored by filling with SpriteBgColor.  When a sprite moves,
+// only the strips of its old rectangle that the new one does not
+// cover are filled, then the new image is drawn, so nothing is
+// erased and redrawn in the same place and there is no flicker.
+static uint16_t SpriteBgColor = ST7735_WHITE;
+
+// Screen rectangle covered by a sprite at (x,y), inclusive corners.
+void static spriteRect(const Sprite_t *sp, int16_t x, int16_t y, int16_t *x0, int16_t *y0, int16_t *x1, int16_t *y1){
+  *x0 = x;
+  *x1 = x + sp->w - 1;
+  *y0 = y - sp->h + 1;                  // (x,y) is the bottom left corner
+  *y1 = y;
+}
+
+// Fill a rectangle given by inclusive corners, clipped to the
+// screen, if not empty.  A sprite may hang off any edge, but
+// ST7735_FillRect() only clips the right and bottom ones.
+void static fillCorners(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color){
+  if(x0 < 0) x0 = 0;
+  if(y0 < 0) y0 = 0;
+  if(x1 >= _width) x1 = _width - 1;
+  if(y1 >= _height) y1 = _height - 1;
+  if((x0 <= x1) && (y0 <= y1)){
+    ST7735_FillRect(x0, y0, x1 - x0 + 1, y1 - y0 + 1, color);
+  }
+}
+
+// Fill the part of the old rectangle (o) not covered by the new
+// one (n) with the background color: up to four strips.
+void static spriteRestore(int16_t ox0, int16_t oy0, int16_t ox1, int16_t oy1,
+                          int16_t nx0, int16_t ny0, int16_t nx1, int16_t ny1){
+  int16_t top, bottom;
+  if((nx0 > ox1) || (nx1 < ox0) || (ny0 > oy1) || (ny1 < oy0)){
+    fillCorners(ox0, oy0, ox1, oy1, SpriteBgColor);   // no overlap
     return;
   }
-  if((x + w - 1) >= _width){            // image exceeds right of screen
-    skipC = (x + w) - _width;           // skip cut off columns
-    w = _width - x;
+  top = (ny0 > oy0) ? ny0 : oy0;        // rows shared by old and new
+  bottom = (ny1 < oy1) ? ny1 : oy1;
+  fillCorners(ox0, oy0, ox1, top - 1, SpriteBgColor);      // above
+  fillCorners(ox0, bottom + 1, ox1, oy1, SpriteBgColor);   // below
+  fillCorners(ox0, top, nx0 - 1, bottom, SpriteBgColor);   // left
+  fillCorners(nx1 + 1, top, ox1, bottom, SpriteBgColor);   // right
+}
+
+//------------ST7735_SpriteBackground------------
+// Set the plain background color that sprites are drawn over.
+// Input: color 16-bit color, which can be produced by ST7735_Color565()
+// Output: none
+void ST7735_SpriteBackground(uint16_t color){
+  SpriteBgColor = color;
+}
+
+//------------ST7735_SpriteInit------------
+// Set up a sprite entry.  It is not shown until the first
+// ST7735_SpriteUpdate() after ST7735_SpriteMove().
+// Input: sp    pointer to the sprite entry
+//        image pointer to a 16-bit color BMP image, same format as ST7735_DrawBitmap()
+//        w     number of pixels wide
+//        h     number of pixels tall
+//        key   color drawn as background (transparent), or -1 for none
+// Output: none
+void ST7735_SpriteInit(Sprite_t *sp, const uint16_t *image, int16_t w, int16_t h, int32_t key){
+  sp->sheet.image = image;
+  sp->sheet.bpp = 16;
+  sp->sheet.topDown = 0;
+  sp->sheet.w = w;
+  sp->sheet.h = h;
+  sp->sx = sp->sy = 0;
+  sp->palette = 0;
+  sp->w = w;
+  sp->h = h;
+  sp->key = key;
+  sp->x = sp->y = 0;
+  sp->visible = 0;
+  sp->drawn = 0;
+  sp->dirty = 0;
+}
+
+//------------ST7735_SpriteInitIndexed------------
+// Set up a sprite entry with a palette-indexed image.  It is not
+// shown until the first ST7735_SpriteUpdate() after ST7735_SpriteMove().
+// Input: sp      pointer to the sprite entry
+//        image   pointer to the indexes, same format as ST7735_DrawBitmapIndexed()
+//        bpp     4 or 8 bits per index
+//        palette pointer to 16 or 256 16-bit colors
+//        w       number of pixels wide
+//        h       number of pixels tall
+//        key     index drawn as background (transparent), or -1 for none
+// Output: none
+void ST7735_SpriteInitIndexed(Sprite_t *sp, const uint8_t *image, uint8_t bpp,
+                              const uint16_t *palette, int16_t w, int16_t h, int32_t key){
+  ST7735_SpriteInit(sp, 0, w, h, key);
+  sp->sheet.image = image;
+  sp->sheet.bpp = bpp;
+  sp->palette = palette;
+}
+
+//------------ST7735_SpriteInitAtlas------------
+// Set up a sprite entry whose image is a rectangle of an atlas,
+// see ST7735_DrawAtlas().  It is not shown until the first
+// ST7735_SpriteUpdate() after ST7735_SpriteMove().
+// Input: sp      pointer to the sprite entry
+//        atlas   pointer to the atlas description, which is copied
+//        palette pointer to 16 or 256 16-bit colors, not used for a 16-bit atlas
+//        sx      left column of the sprite in the atlas
+//        sy      top row of the sprite in the atlas, counted from the top
+//        w       number of pixels wide
+//        h       number of pixels tall
+//        key     color (index for an indexed atlas) drawn as background, or -1 for none
+// Output: none
+void ST7735_SpriteInitAtlas(Sprite_t *sp, const Atlas_t *atlas, const uint16_t *palette,
+                            int16_t sx, int16_t sy, int16_t w, int16_t h, int32_t key){
+  ST7735_SpriteInit(sp, 0, w, h, key);
+  sp->sheet = *atlas;
+  sp->sx = sx;
+  sp->sy = sy;
+  sp->palette = palette;
+}
+
+//------------ST7735_SpritePalette------------
+// Change the palette of an indexed sprite, for color cycling or a
+// flash.  The sprite is redrawn at the next ST7735_SpriteUpdate()
+// even if it did not move; the image itself is not copied.
+// Input: sp      pointer to the sprite entry
+//        palette pointer to 16 or 256 16-bit colors
+// Output: none
+void ST7735_SpritePalette(Sprite_t *sp, const uint16_t *palette){
+  if(sp->palette == palette) return;
+  sp->palette = palette;
+  sp->dirty = 1;
+}
+
+//------------ST7735_SpriteMove------------
+// Set the position a sprite will be drawn at by the next
+// ST7735_SpriteUpdate().  Does not output to the display.
+// Input: sp    pointer to the sprite entry
+//        x     horizontal position of the bottom left corner, columns from the left edge
+//        y     vertical position of the bottom left corner, rows from the top edge
+// Output: none
+void ST7735_SpriteMove(Sprite_t *sp, int16_t x, int16_t y){
+  sp->x = x;
+  sp->y = y;
+  sp->visible = 1;
+}
+
+//------------ST7735_SpriteHide------------
+// Remove a sprite at the next ST7735_SpriteUpdate().
+// Input: sp    pointer to the sprite entry
+// Output: none
+void ST7735_SpriteHide(Sprite_t *sp){
+  sp->visible = 0;
+}
+
+//------------ST7735_SpriteUpdate------------
+// Bring the display up to date with a table of sprites.  Exposed
+// background is restored for every sprite first, then every sprite
+// that moved, appeared, or lost pixels to a restore is drawn.
+// Sprites that did not change cost nothing.
+// Input: table pointer to an array of sprite entries
+//        n     number of entries
+// Output: none
+void ST7735_SpriteUpdate(Sprite_t *table, uint32_t n){
+  uint32_t i, j;
+  int16_t ox0, oy0, ox1, oy1, nx0, ny0, nx1, ny1;
+  uint8_t moved;
+  for(i=0; i<n; i=i+1){                 // pass 1: find what changed
+    Sprite_t *sp = &table[i];
+    moved = !sp->drawn || !sp->visible || (sp->x != sp->lastX) || (sp->y != sp->lastY);
+    sp->dirty = (moved || sp->dirty) && sp->visible;   // keep a palette change
   }
-  if((y - h + 1) < 0){                  // image exceeds top of screen
-    i = i - (h - y - 1)*originalWidth;  // skip the last cut off rows
-    h = y + 1;
+  for(i=0; i<n; i=i+1){                 // pass 2: restore background
+    Sprite_t *sp = &table[i];
+    moved = !sp->visible || (sp->x != sp->lastX) || (sp->y != sp->lastY);
+    if(!moved || !sp->drawn) continue;
+    spriteRect(sp, sp->lastX, sp->lastY, &ox0, &oy0, &ox1, &oy1);
+    if(sp->visible){
+      spriteRect(sp, sp->x, sp->y, &nx0, &ny0, &nx1, &ny1);
+    } else{
+      nx0 = nx1 = ny0 = ny1 = -1000;    // nothing covers the old rectangle
+    }
+    spriteRestore(ox0, oy0, ox1, oy1, nx0, ny0, nx1, ny1);
+    sp->drawn = 0;
+    for(j=0; j<n; j=j+1){               // others showing through get redrawn
+      Sprite_t *other = &table[j];
+      if((j == i) || !other->drawn || !other->visible) continue;
+      spriteRect(other, other->lastX, other->lastY, &nx0, &ny0, &nx1, &ny1);
+      if((nx0 <= ox1) && (nx1 >= ox0) && (ny0 <= oy1) && (ny1 >= oy0)){
+        other->dirty = 1;
+      }
+    }
   }
-  if(x < 0){                            // image exceeds left of screen
-    w = w + x;
-    skipC = -1*x;                       // skip cut off columns
-    i = i - x;                          // skip the first cut off columns
-    x = 0;
+  for(i=0; i<n; i=i+1){                 // pass 3: draw
+    Sprite_t *sp = &table[i];
+    if(!sp->dirty) continue;
+    blit(&sp->sheet, sp->palette, sp->sx, sp->sy, sp->w, sp->h,
+         sp->x, sp->y - sp->h + 1, sp->key, SpriteBgColor, 0);
+    sp->lastX = sp->x;
+    sp->lastY = sp->y;
+    sp->drawn = 1;
+    sp->dirty = 0;
   }
-  if(y >= _height){                     // image exceeds bottom of screen
-    h = h - (y - _height + 1);
-    y = _height - 1;
+  ST7735_WaitIdle();
+}
+
+
+// Scanline compositor
+// A scene is a list of layers (rectangles, bitmaps, text) painted
+// in order into a RAM band of BAND_ROWS rows.  A finished band is
+// streamed by the uDMA while the next one is composed into the
+// other buffer.  The whole region is one address window, so the
+// bands simply continue the same RAMWR.  Every pixel is sent once
+// no matter how many layers cover it.
+// Memory: 2*BAND_ROWS*DMA_LINEMAX*2 bytes = 2560 bytes
+#define BAND_ROWS 4
+static uint16_t Band[2][BAND_ROWS*DMA_LINEMAX];
+
+// Paint the part of one layer on screen row y into line[],
+// where line[0] is screen column x0 and the line is w wide.
+void static composeRow(uint16_t *line, int16_t x0, int16_t w, int16_t y, const Layer_t *ly){
+  int32_t c, c0, c1, k, i, s, size, row;
+  const uint16_t *src;
+  const char *pt;
+  uint8_t bits;
+  switch(ly->type){
+  case LAYER_RECT:
+    if((y < ly->y) || (y >= ly->y + ly->h)) return;
+    c0 = (ly->x > x0) ? ly->x : x0;
+    c1 = ((ly->x + ly->w) < (x0 + w)) ? (ly->x + ly->w) : (x0 + w);
+    for(c=c0; c<c1; c=c+1){
+      line[c - x0] = ly->color;
+    }
+    break;
+  case LAYER_BITMAP:                    // (x,y) is the bottom left corner
+    if((y > ly->y) || (y <= ly->y - ly->h)) return;
+    src = ly->image + (ly->y - y)*ly->w;   // rows are stored bottom up
+    c0 = (ly->x > x0) ? ly->x : x0;
+    c1 = ((ly->x + ly->w) < (x0 + w)) ? (ly->x + ly->w) : (x0 + w);
+    for(c=c0; c<c1; c=c+1){
+      if((ly->key < 0) || (src[c - ly->x] != ly->key)){
+        line[c - x0] = src[c - ly->x];
+      }
+    }
+    break;
+  case LAYER_TEXT:                      // (x,y) is the top left corner
+    size = ly->size;
+    if((y < ly->y) || (y >= ly->y + 8*size)) return;
+    row = (y - ly->y)/size;             // row of the font
+    c = ly->x;
+    for(pt=ly->text; *pt && (c < x0 + w); pt++){
+      bits = FontRow[((uint8_t)*pt)*8 + row];
+      for(i=0; i<6; i=i+1){             // 5 font columns and a blank one
+        for(s=0; s<size; s=s+1){
+          k = c - x0;
+          if((k >= 0) && (k < w)){
+            if(bits&0x01){
+              line[k] = ly->color;
+            } else if(ly->key >= 0){
+              line[k] = ly->key;        // opaque background
+            }
+          }
+          c++;
+        }
+        bits = bits>>1;
+      }
+    }
+    break;
+  }
+}
+
+//------------ST7735_Compose------------
+// Draw a region of the screen from a list of layers in one pass.
+// Each pixel is sent once, through a single address window.
+// Returns while the last band may still be streaming; any other
+// driver call waits for it.
+// Requires (11 + 2*w*h) bytes of transmission
+// Input: layers  array of layers, painted first to last (last on top)
+//        n       number of layers
+//        bgColor color of pixels not covered by any layer
+//        x       horizontal position of the top left corner of the region
+//        y       vertical position of the top left corner of the region
+//        w       width of the region
+//        h       height of the region
+// Output: none
+void ST7735_Compose(const Layer_t *layers, uint32_t n, uint16_t bgColor, int16_t x, int16_t y, int16_t w, int16_t h){
+  int32_t row, r, rows, i;
+  uint16_t *line;
+  uint8_t sel = 0;
+  if(x < 0){ w = w + x; x = 0; }        // clip the region to the screen
+  if(y < 0){ h = h + y; y = 0; }
+  if((x + w) > _width) w = _width - x;
+  if((y + h) > _height) h = _height - y;
+  if((w <= 0) || (h <= 0)) return;
+
+  setAddrWindow(x, y, x+w-1, y+h-1);    // also waits for previous transfer
+
+  for(row=y; row<y+h; row=row+rows){
+    rows = y + h - row;
+    if(rows > BAND_ROWS) rows = BAND_ROWS;
+    for(r=0; r<rows; r=r+1){            // compose into the idle buffer
+      line = &Band[sel][r*w];
+      for(i=0; i<w; i=i+1){
+        line[i] = bgColor;
+      }
+      for(i=0; i<n; i=i+1){
+        composeRow(line, x, w, row + r, &layers[i]);
+      }
+    }
+    while(DMABusy){POLL();}             // previous band done, window stays open
+    DMASrc = Band[sel];                 // one uDMA piece per row
+    DMARowWidth = w;
+    DMARowStride = w;
+    DMARemaining = rows;
+    DMAStaged = 0;
+    DMABpp = 0;
+    DMADone = 0;
+    dmaBegin();
+    sel ^= 1;
+  }
+}
+
+
+// Fill a small rectangle by polling, cheaper than a uDMA transfer
+// for the few pixels in a run of a character.
+void static pushRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color){
+  int32_t i;
+  if(x < 0){ w = w + x; x = 0; }
+  if(y < 0){ h = h + y; y = 0; }
+  if((x + w) > _width) w = _width - x;
+  if((y + h) > _height) h = _height - y;
+  if((w <= 0) || (h <= 0)) return;
+  setAddrWindow(x, y, x+w-1, y+h-1);
+  for(i=w*h; i>0; i=i-1){
+    pushColor(color);
+  }
+}
+
+//------------ST7735_DrawLine------------
+// Draw a line between two points with Bresenham's algorithm.  The
+// pixels of a mostly horizontal line are sent as one window per
+// row it crosses, and those of a mostly vertical line as one window
+// per column, instead of one window per pixel.  Parts off the
+// screen are not drawn.
+// Requires (3 to 11 bytes per run + 2 bytes per pixel) of transmission
+// Input: x0,y0 first end point, columns from the left edge and rows from the top edge
+//        x1,y1 second end point
+//        color 16-bit color, which can be produced by ST7735_Color565()
+// Output: none
+void ST7735_DrawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color){
+  int32_t dx, dy, err, step, t, start;
+  dx = (x1 > x0) ? (x1 - x0) : (x0 - x1);
+  dy = (y1 > y0) ? (y1 - y0) : (y0 - y1);
+  if(dx >= dy){                         // runs along rows
+    if(x0 > x1){                        // always go left to right
+      t = x0; x0 = x1; x1 = t;
+      t = y0; y0 = y1; y1 = t;
+    }
+    step = (y1 > y0) ? 1 : -1;
+    err = dx/2;
+    for(start=t=x0; t<=x1; t++){
+      err = err - dy;
+      if((err < 0) || (t == x1)){       // row changes after this pixel
+        pushRect(start, y0, t - start + 1, 1, color);
+        start = t + 1;
+        y0 = y0 + step;
+        err = err + dx;
+      }
+    }
+  } else{                               // runs along columns
+    if(y0 > y1){                        // always go top to bottom
+      t = x0; x0 = x1; x1 = t;
+      t = y0; y0 = y1; y1 = t;
+    }
+    step = (x1 > x0) ? 1 : -1;
+    err = dy/2;
+    for(start=t=y0; t<=y1; t++){
+      err = err - dx;
+      if((err < 0) || (t == y1)){       // column changes after this pixel
+        pushRect(x0, start, 1, t - start + 1, color);
+        start = t + 1;
+        x0 = x0 + step;
+        err = err + dy;
+      }
+    }
   }
+}
+
+// Half width of a circle of radius r, d rows from its center: the
+// largest x with x*x + d*d <= r*r + r, so edge pixels are within
+// half a pixel of the circle (the midpoint rule).  x is the answer
+// for the row before, which only gets smaller, so rows in order
+// cost no more than r steps in all.
+int32_t static circleHalf(int32_t x, int32_t d, int32_t r){
+  while((x >= 0) && ((x*x + d*d) > (r*r + r))){
+    x = x - 1;
+  }
+  return x;
+}
 
-  setAddrWindow(x, y-h+1, x+w-1, y);
+// Draw the points lo to hi of row d of the outline in all four
+// quadrants of a circle centered at (x0,y0), as horizontal runs;
+// if vertical is 1 the same points with x and y swapped, as
+// vertical runs.  Runs that meet at the axis become one.
+void static circleRuns(int16_t x0, int16_t y0, int32_t lo, int32_t hi, int32_t d, uint8_t vertical, uint16_t color){
+  int32_t n = hi - lo + 1;
+  if(lo == 0){
+    n = 2*hi + 1;
+    lo = -hi;
+  }
+  if(vertical){
+    pushRect(x0 + d, y0 + lo, 1, n, color);
+    if(d) pushRect(x0 - d, y0 + lo, 1, n, color);
+    if(lo > 0){
+      pushRect(x0 + d, y0 - hi, 1, n, color);
+      if(d) pushRect(x0 - d, y0 - hi, 1, n, color);
+    }
+  } else{
+    pushRect(x0 + lo, y0 + d, n, 1, color);
+    if(d) pushRect(x0 + lo, y0 - d, n, 1, color);
+    if(lo > 0){
+      pushRect(x0 - hi, y0 + d, n, 1, color);
+      if(d) pushRect(x0 - hi, y0 - d, n, 1, color);
+    }
+  }
+}
 
-  for(y=0; y<h; y=y+1){
-    for(x=0; x<w; x=x+1){
-                                        // send the top 8 bits
-      writedata((uint8_t)(image[i] >> 8));
-                                        // send the bottom 8 bits
-      writedata((uint8_t)image[i]);
-      i = i + 1;                        // go to the next pixel
+//------------ST7735_DrawCircle------------
+// Draw the outline of a circle with the midpoint rule.  Each row
+// of the flat top and bottom octants is one horizontal run, and
+// each column of the steep side octants one vertical run, so every
+// pixel is sent once and a circle of radius r takes about 2.4*r
+// windows rather than one for each of its 5.7*r pixels.  Parts
+// off the screen are not drawn.
+// Requires (3 to 11 bytes per run + 2 bytes per pixel) of transmission
+// Input: x0,y0 center, columns from the left edge and rows from the top edge
+//        r     radius in pixels
+//        color 16-bit color, which can be produced by ST7735_Color565()
+// Output: none
+void ST7735_DrawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color){
+  int32_t d, x, next, lo;
+  x = r;
+  for(d=0; d<=r; d++){                  // x is the half width of row d
+    next = circleHalf(x, d + 1, r);
+    lo = next + 1;                      // outline of row d is lo to x
+    if(lo > x) lo = x;
+    if(lo <= d){                        // part of it above the diagonal
+      circleRuns(x0, y0, lo, (x < d) ? x : d, d, 0, color);
+      if(lo < d){                       // mirror below it, not the diagonal
+        circleRuns(x0, y0, lo, (x < d - 1) ? x : d - 1, d, 1, color);
+      }
+    }
+    x = next;
+  }
+}
+
+//------------ST7735_FillCircle------------
+// Fill a circle, using the same edge as ST7735_DrawCircle(), as one
+// horizontal span per row.
+// Requires (3 to 11 bytes per row + 2 bytes per pixel) of transmission
+// Input: x0,y0 center, columns from the left edge and rows from the top edge
+//        r     radius in pixels
+//        color 16-bit color, which can be produced by ST7735_Color565()
+// Output: none
+void ST7735_FillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color){
+  int32_t d, x;
+  x = r;
+  for(d=0; d<=r; d++){
+    x = circleHalf(x, d, r);
+    pushRect(x0 - x, y0 + d, 2*x + 1, 1, color);
+    if(d) pushRect(x0 - x, y0 - d, 2*x + 1, 1, color);
+  }
+}
+
+//------------ST7735_FillPolygon------------
+// Fill a convex polygon as one horizontal span per row, from the
+// leftmost to the rightmost edge crossing that row.  Rows off the
+// screen are skipped without visiting the edges.
+// Requires (3 to 11 bytes per row + 2 bytes per pixel) of transmission
+// Input: xy    pointer to n corners as pairs x,y, in order around the polygon
+//        n     number of corners, at least 1
+//        color 16-bit color, which can be produced by ST7735_Color565()
+// Output: none
+void ST7735_FillPolygon(const int16_t *xy, uint32_t n, uint16_t color){
+  int32_t y, ymin, ymax, left, right, x;
+  int32_t xa, ya, xb, yb;
+  uint32_t i, j;
+  ymin = ymax = xy[1];
+  for(i=1; i<n; i++){
+    if(xy[2*i + 1] < ymin) ymin = xy[2*i + 1];
+    if(xy[2*i + 1] > ymax) ymax = xy[2*i + 1];
+  }
+  if(ymin < 0) ymin = 0;
+  if(ymax >= _height) ymax = _height - 1;
+  for(y=ymin; y<=ymax; y++){
+    left = 0x7FFF;
+    right = -0x8000;
+    for(i=0, j=n-1; i<n; j=i, i++){    // edge from corner j to corner i
+      xa = xy[2*j]; ya = xy[2*j + 1];
+      xb = xy[2*i]; yb = xy[2*i + 1];
+      if(((y < ya) && (y < yb)) || ((y > ya) && (y > yb))) continue;
+      if(ya == yb){                     // flat edge on this row
+        x = (xa < xb) ? xa : xb;
+        if(x < left) left = x;
+        x = (xa > xb) ? xa : xb;
+        if(x > right) right = x;
+      } else{
+        x = xa + (y - ya)*(xb - xa)/(yb - ya);
+        if(x < left) left = x;
+        if(x > right) right = x;
+      }
+    }
+    if(left <= right){
+      pushRect(left, y, right - left + 1, 1, color);
     }
-    i = i + skipC;
-    i = i - 2*originalWidth;
   }
 }
 
+//------------ST7735_FillTriangle------------
+// Fill a triangle, see ST7735_FillPolygon().
+// Requires (3 to 11 bytes per row + 2 bytes per pixel) of transmission
+// Input: x0,y0 first corner, columns from the left edge and rows from the top edge
+//        x1,y1 second corner
+//        x2,y2 third corner
+//        color 16-bit color, which can be produced by ST7735_Color565()
+// Output: none
+void ST7735_FillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                         int16_t x2, int16_t y2, uint16_t color){
+  int16_t xy[6];
+  xy[0] = x0; xy[1] = y0;
+  xy[2] = x1; xy[3] = y1;
+  xy[4] = x2; xy[5] = y2;
+  ST7735_FillPolygon(xy, 3, color);
+}
+
+// Draw n characters side by side, top left corner at (x,y), each
+// 6*size wide (the font plus a blank column) and 8*size tall.
+// Opaque text (textColor != bgColor) is one address window for the
+// whole visible part of the string, streamed a font row at a time.
+// Transparent text (textColor == bgColor) skips the clear bits and
+// sends one small window per run of set bits in a font row.
+void static drawText(int16_t x, int16_t y, const char *pt, uint32_t n, uint16_t textColor, uint16_t bgColor, uint8_t size){
+  int32_t x0, y0, x1, y1, px, py, cx, row, col, run, k, s;
+  uint8_t bits;
+  uint16_t color;
+  if((n == 0) || (size == 0)) return;
+  x0 = x; y0 = y;                       // clip the block to the screen
+  x1 = x + 6*size*n - 1; y1 = y + 8*size - 1;
+  if(x0 < 0) x0 = 0;
+  if(y0 < 0) y0 = 0;
+  if(x1 >= _width) x1 = _width - 1;
+  if(y1 >= _height) y1 = _height - 1;
+  if((x0 > x1) || (y0 > y1)) return;
+
+  if(textColor == bgColor){
+    for(k=0; k<n; k=k+1){
+      cx = x + 6*size*k;
+      if(cx > x1) return;
+      if((cx + 5*size - 1) < x0) continue;
+      for(row=0; row<8; row=row+1){
+        bits = FontRow[((uint8_t)pt[k])*8 + row];
+        col = 0;
+        while(bits){
+          if(bits&0x01){
+            for(run=0; bits&0x01; run=run+1){
+              bits = bits>>1;
+            }
+            pushRect(cx + col*size, y + row*size, run*size, size, textColor);
+            col = col + run;
+          } else{
+            bits = bits>>1;
+            col = col + 1;
+          }
+        }
+      }
+    }
+    return;
+  }
+
+  setAddrWindow(x0, y0, x1, y1);
+  for(py=y0; py<=y1; py=py+1){
+    row = (py - y)/size;
+    px = x;
+    for(k=0; (k<n) && (px<=x1); k=k+1){
+      bits = FontRow[((uint8_t)pt[k])*8 + row];
+      for(col=0; col<6; col=col+1){
+        color = (bits&0x01) ? textColor : bgColor;
+        bits = bits>>1;
+        for(s=0; s<size; s=s+1){
+          if((px >= x0) && (px <= x1)){
+            pushColor(color);
+          }
+          px = px + 1;
+        }
+      }
+    }
+  }
+}
 
 //------------ST7735_DrawCharS------------
 // Simple character draw function.  This is the same function from
-// Adafruit_GFX.c but adapted for this processor.  However, each call
-// to ST7735_DrawPixel() calls setAddrWindow(), which needs to send
-// many extra data and commands.  If the background color is the same
-// as the text color, no background will be printed, and text can be
-// drawn right over existing images without covering them with a box.
-// Requires (11 + 2*size*size)*6*8 (image fully on screen; textcolor != bgColor)
+// Adafruit_GFX.c but adapted for this processor.  The character is
+// clipped to the screen and sent through one address window.  If the
+// background color is the same as the text color, no background will
+// be printed, and text can be drawn right over existing images without
+// covering them with a box; then each run of lit pixels in a font row
+// is sent as its own small window.
+// Requires (11 + 2*size*size*6*8) bytes of transmission (image fully on screen; textcolor != bgColor)
 // Input: x         horizontal position of the top left corner of the character, columns from the left edge
 //        y         vertical position of the top left corner of the character, rows from the top edge
 //        c         character to be printed
@@ -1041,36 +2633,7 @@ void ST7735_DrawBitmap(int16_t x, int16_t y, const uint16_t *image, int16_t w, i
 //        size      number of pixels per character pixel (e.g. size==2 prints each pixel of font as 2x2 square)
 // Output: none
 void ST7735_DrawCharS(int16_t x, int16_t y, char c, int16_t textColor, int16_t bgColor, uint8_t size){
-  uint8_t line; // vertical column of pixels of character in font
-  int32_t i, j;
-  if((x >= _width)            || // Clip right
-     (y >= _height)           || // Clip bottom
-     ((x + 5 * size - 1) < 0) || // Clip left
-     ((y + 8 * size - 1) < 0))   // Clip top
-    return;
-
-  for (i=0; i<6; i++ ) {
-    if (i == 5)
-      line = 0x0;
-    else
-      line = Font[(c*5)+i];
-    for (j = 0; j<8; j++) {
-      if (line & 0x1) {
-        if (size == 1) // default size
-          ST7735_DrawPixel(x+i, y+j, textColor);
-        else {  // big size
-          ST7735_FillRect(x+(i*size), y+(j*size), size, size, textColor);
-        }
-      } else if (bgColor != textColor) {
-        if (size == 1) // default size
-          ST7735_DrawPixel(x+i, y+j, bgColor);
-        else {  // big size
-          ST7735_FillRect(x+i*size, y+j*size, size, size, bgColor);
-        }
-      }
-      line >>= 1;
-    }
-  }
+  drawText(x, y, &c, 1, textColor, bgColor, size);
 }
 
 
@@ -1078,8 +2641,9 @@ void ST7735_DrawCharS(int16_t x, int16_t y, char c, int16_t textColor, int16_t b
 // Advanced character draw function.  This is similar to the function
 // from Adafruit_GFX.c but adapted for this processor.  However, this
 // function only uses one call to setAddrWindow(), which allows it to
-// run at least twice as fast.
-// Requires (11 + size*size*6*8) bytes of transmission (assuming image fully on screen)
+// run at least twice as fast.  The character is not drawn at all
+// unless it fits entirely on the screen.
+// Requires (11 + 2*size*size*6*8) bytes of transmission (assuming image fully on screen)
 // Input: x         horizontal position of the top left corner of the character, columns from the left edge
 //        y         vertical position of the top left corner of the character, rows from the top edge
 //        c         character to be printed
@@ -1088,47 +2652,19 @@ void ST7735_DrawCharS(int16_t x, int16_t y, char c, int16_t textColor, int16_t b
 //        size      number of pixels per character pixel (e.g. size==2 prints each pixel of font as 2x2 square)
 // Output: none
 void ST7735_DrawChar(int16_t x, int16_t y, char c, int16_t textColor, int16_t bgColor, uint8_t size){
-  uint8_t line; // horizontal row of pixels of character
-  int32_t col, row, i, j;// loop indices
   if(((x + 5*size - 1) >= _width)  || // Clip right
      ((y + 8*size - 1) >= _height) || // Clip bottom
      ((x + 5*size - 1) < 0)        || // Clip left
      ((y + 8*size - 1) < 0)){         // Clip top
     return;
   }
-
-  setAddrWindow(x, y, x+6*size-1, y+8*size-1);
-
-  line = 0x01;        // print the top row first
-  // print the rows, starting at the top
-  for(row=0; row<8; row=row+1){
-    for(i=0; i<size; i=i+1){
-      // print the columns, starting on the left
-      for(col=0; col<5; col=col+1){
-        if(Font[(c*5)+col]&line){
-          // bit is set in Font, print pixel(s) in text color
-          for(j=0; j<size; j=j+1){
-            pushColor(textColor);
-          }
-        } else{
-          // bit is cleared in Font, print pixel(s) in background color
-          for(j=0; j<size; j=j+1){
-            pushColor(bgColor);
-          }
-        }
-      }
-      // print blank column(s) to the right of character
-      for(j=0; j<size; j=j+1){
-        pushColor(bgColor);
-      }
-    }
-    line = line<<1;   // move up to the next row
-  }
+  drawText(x, y, &c, 1, textColor, bgColor, size);
 }
 //------------ST7735_DrawString------------
 // String draw function.
 // 16 rows (0 to 15) and 21 characters (0 to 20)
-// Requires (11 + size*size*6*8) bytes of transmission for each character
+// The visible characters are sent through one address window.
+// Requires (11 + 2*6*8*n) bytes of transmission for n characters
 // Input: x         columns from the left edge (0 to 20)
 //        y         rows from the top edge (0 to 15)
 //        pt        pointer to a null terminated string to be printed
@@ -1137,17 +2673,84 @@ void ST7735_DrawChar(int16_t x, int16_t y, char c, int16_t textColor, int16_t bg
 // Output: number of characters printed
 uint32_t ST7735_DrawString(uint16_t x, uint16_t y, char *pt, int16_t textColor){
   uint32_t count = 0;
+  uint32_t n = 0;
+  uint16_t x0 = x;
   if(y>15) return 0;
-  while(*pt){
-    ST7735_DrawCharS(x*6, y*10, *pt, textColor, ST7735_BLACK, 1);
-    pt++;
+  while(pt[n]){
+    n++;
     x = x+1;
-    if(x>20) return count;  // number of characters printed
+    if(x>20) break;
     count++;
   }
+  drawText(x0*6, y*10, pt, n, textColor, ST7735_BLACK, 1);
   return count;  // number of characters printed
 }
 
+// "00" to "99", so two digits come from one remainder
+static const char DigitPairs[200] =
+  "0001020304050607080910111213141516171819"
+  "2021222324252627282930313233343536373839"
+  "4041424344454647484950515253545556575859"
+  "6061626364656667686970717273747576777879"
+  "8081828384858687888990919293949596979899";
+
+// Write the decimal digits of n to buf, most significant first,
+// without a divide instruction: n/100 is a multiply by the
+// reciprocal 2^37/100 (exact for every 32-bit n) and each
+// remainder looks up two digits at once.
+// Returns the number of digits, 1 to 10; buf is not terminated.
+uint32_t static udecFormat(char *buf, uint32_t n){
+  char tmp[10];
+  char *p = &tmp[10];
+  uint32_t q, r, len;
+  while(n >= 100){
+    q = (uint32_t)(((uint64_t)n*0x51EB851F)>>37);
+    r = 2*(n - 100*q);
+    p = p - 2;
+    p[0] = DigitPairs[r];
+    p[1] = DigitPairs[r + 1];
+    n = q;
+  }
+  if(n >= 10){
+    p = p - 2;
+    p[0] = DigitPairs[2*n];
+    p[1] = DigitPairs[2*n + 1];
+  } else{
+    p = p - 1;
+    p[0] = '0' + n;
+  }
+  len = &tmp[10] - p;
+  for(r=0; r<len; r=r+1){
+    buf[r] = p[r];
+  }
+  return len;
+}
+
+// Write n/10^decimals in decimal fixed point to buf, with a '-'
+// if negative and at least one digit before the point.
+// Returns the number of characters, at most 12; buf is not
+// terminated.
+uint32_t static fixFormat(char *buf, int32_t n, uint8_t decimals){
+  char digits[10];
+  uint32_t len, zeros, total, i, k = 0;
+  if(decimals > 9) decimals = 9;
+  if(n < 0){
+    buf[k++] = '-';
+    len = udecFormat(digits, -(uint32_t)n);
+  } else{
+    len = udecFormat(digits, n);
+  }
+  zeros = (len <= decimals) ? (decimals + 1 - len) : 0;
+  total = len + zeros;
+  for(i=0; i<total; i=i+1){
+    if(decimals && (i == total - decimals)){
+      buf[k++] = '.';
+    }
+    buf[k++] = (i < zeros) ? '0' : digits[i - zeros];
+  }
+  return k;
+}
+
 //-----------------------fillmessage-----------------------
 // Output a 32-bit number in unsigned decimal format
 // Input: 32-bit number to be transferred
@@ -1157,15 +2760,102 @@ char Message[12];
 uint32_t Messageindex;
 
 void fillmessage(uint32_t n){
-// This function uses recursion to convert decimal number
-//   of unspecified length as an ASCII string
-  if(n >= 10){
-    fillmessage(n/10);
-    n = n%10;
+  Messageindex = Messageindex + udecFormat(&Message[Messageindex], n);
+}
+// Text line of frame memory that holds console line StY.
+// Without scrolling they are the same.
+uint32_t static textLine(void){
+  if(ScrollOn){
+    return (ScrollTop + StY)%ScrollLines;
+  }
+  return StY;
+}
+
+// The panel scrolls along its rows of frame memory, which is the
+// y axis in rotations 0 and 2 and the x axis in rotations 1 and 3.
+// The MY bit (rotations 0 and 1) mirrors rows, so the scroll area is
+// counted from the other end of frame memory and the start address
+// runs backward.  vsa is the length of the scroll area, which starts
+// at screen coordinate 0 of the scrolling axis.
+uint16_t static scrollTFA(uint16_t vsa){
+  uint8_t offset = (Rotation&0x01) ? ColStart : RowStart;
+  if(Rotation < 2){
+    return ST7735_FRAMEROWS - offset - vsa;
+  }
+  return offset;
+}
+
+// Set up a scroll area of vsa rows.
+// Requires 7 bytes of transmission
+void static scrollDefine(uint16_t vsa){
+  uint16_t tfa = scrollTFA(vsa);
+  uint16_t bfa = ST7735_FRAMEROWS - tfa - vsa;
+  writecommand(ST7735_VSCRDEF);
+  writedata(tfa>>8);
+  writedata(tfa);
+  writedata(vsa>>8);
+  writedata(vsa);
+  writedata(bfa>>8);
+  writedata(bfa);
+}
+
+// Scroll so that coordinate top (0 to vsa-1) of the scroll area
+// is shown at screen coordinate 0.
+// Requires 3 bytes of transmission
+void static scrollTo(uint16_t top, uint16_t vsa){
+  uint16_t tfa = scrollTFA(vsa);
+  uint16_t ssa;
+  if(Rotation < 2){
+    ssa = tfa + (vsa - top)%vsa;
+  } else{
+    ssa = tfa + top;
+  }
+  writecommand(ST7735_VSCSAD);
+  writedata(ssa>>8);
+  writedata(ssa);
+}
+
+// Show text line ScrollTop at the top of the screen.
+// Requires 3 bytes of transmission
+void static scrollStart(void){
+  scrollTo(ScrollTop*10, ScrollLines*10);
+}
+
+//------------ST7735_SetScrollConsole------------
+// Select how ST7735_OutChar() handles a newline.  With scrolling
+// off, the cursor wraps to the top line and the next line is
+// repainted with spaces.  With scrolling on, the text lines that fit
+// on the screen become a hardware scroll area: after the last line
+// the screen scrolls up one line by changing the scroll start address,
+// and only the characters already written on the reused line are
+// erased (in the background, by the uDMA).  The screen is cleared
+// and the cursor moved to the top left either way.
+// Only rotations 0 and 2 scroll along the rows of the panel; in
+// rotations 1 and 3 the request is ignored and scrolling stays off.
+// ST7735_SetRotation() turns scrolling off.
+// Requires 11 bytes of transmission plus a screen fill
+// Input: enable  1 to scroll, 0 for the wrap-around console
+// Output: 1 if scrolling is on, 0 if not
+int ST7735_SetScrollConsole(uint8_t enable){
+  if(ScrollOn || StripOn){
+    writecommand(ST7735_NORON);         // leave scroll mode
+    ScrollOn = 0;
+    StripOn = 0;
   }
-  Message[Messageindex] = (n+'0'); /* n is between 0 and 9 */
-  if(Messageindex<11)Messageindex++;
+  if(enable && ((Rotation == 0) || (Rotation == 2))){
+    ScrollLines = _height/10;
+    if(ScrollLines > 16) ScrollLines = 16;
+    scrollDefine(ScrollLines*10);
+    ScrollTop = 0;
+    ScrollOn = 1;
+    scrollStart();
+  }
+  ST7735_FillScreen(ST7735_BLACK);
+  StX = 0;
+  StY = 0;
+  return ScrollOn;
 }
+
 //********ST7735_SetCursor*****************
 // Move the cursor to the desired X- and Y-position.  The
 // next character will be printed here.  X=0 is the leftmost
@@ -1177,6 +2867,9 @@ void ST7735_SetCursor(uint32_t newX, uint32_t newY){
   if((newX > 20) || (newY > 15)){       // bad input
     return;                             // do nothing
   }
+  if(ScrollOn && (newY >= ScrollLines)){
+    return;                             // below the scroll area
+  }
   StX = newX;
   StY = newY;
 }
@@ -1184,6 +2877,7 @@ void ST7735_SetCursor(uint32_t newX, uint32_t newY){
 // Output a 32-bit number in unsigned decimal format
 // Position determined by ST7735_SetCursor command
 // Color set by ST7735_SetTextColor
+// Digits the screen already shows are not sent again.
 // Input: 32-bit number to be transferred
 // Output: none
 // Variable format 1-10 digits with no space before or after
@@ -1191,14 +2885,90 @@ void ST7735_OutUDec(uint32_t n){
   Messageindex = 0;
   fillmessage(n);
   Message[Messageindex] = 0; // terminate
-  ST7735_DrawString(StX,StY,Message,StTextColor);
-  StX = StX+Messageindex;
-  if(StX>20){
-    StX = 20;
-    ST7735_DrawCharS(StX*6,StY*10,'*',ST7735_RED,ST7735_BLACK, 1);
+  ST7735_OutString(Message);
+}
+
+//------------ST7735_HudInit------------
+// Set up a number field for a heads-up display (score, frame rate,
+// latency).  Nothing is drawn until the first ST7735_HudUDec() or
+// ST7735_HudFix(); call this again after the screen is cleared.
+// Input: h       pointer to the field
+//        x       horizontal position of the top left corner, columns from the left edge
+//        y       vertical position of the top left corner, rows from the top edge
+//        width   character cells, 1 to 12; numbers are right aligned
+//        size    pixels per font pixel
+//        color   16-bit text color
+//        bgColor 16-bit background color, different from color
+// Output: none
+void ST7735_HudInit(HudNumber_t *h, int16_t x, int16_t y, uint8_t width, uint8_t size,
+                    uint16_t color, uint16_t bgColor){
+  uint32_t i;
+  if(width > 12) width = 12;
+  h->x = x;
+  h->y = y;
+  h->width = width;
+  h->size = size;
+  h->color = color;
+  h->bgColor = bgColor;
+  for(i=0; i<12; i=i+1){
+    h->shown[i] = 0;                    // nothing shown yet
   }
 }
 
+// Right align len characters of text in a field and draw only the
+// cells that differ from what it shows, one window per run.  Text
+// that does not fit is shown as '*'s.
+void static hudShow(HudNumber_t *h, const char *text, uint32_t len){
+  char cell[12];
+  uint32_t c, n, w = h->width;
+  for(c=0; c<w; c=c+1){
+    if(len > w){
+      cell[c] = '*';
+    } else{
+      cell[c] = (c < w - len) ? ' ' : text[c - (w - len)];
+    }
+  }
+  c = 0;
+  while(c < w){
+    if(cell[c] == h->shown[c]){
+      c = c + 1;
+      continue;
+    }
+    for(n=0; (c + n < w) && (cell[c + n] != h->shown[c + n]); n=n+1){
+      h->shown[c + n] = cell[c + n];
+    }
+    drawText(h->x + 6*h->size*c, h->y, &cell[c], n, h->color, h->bgColor, h->size);
+    c = c + n;
+  }
+}
+
+//------------ST7735_HudUDec------------
+// Show an unsigned number in a heads-up display field.  Only the
+// digits that changed are drawn, so a counter that goes up by one
+// usually costs a single character.
+// Requires (11 + 96*size*size*n) bytes for each run of n changed characters
+// Input: h  pointer to the field, see ST7735_HudInit()
+//        n  number to show
+// Output: none
+void ST7735_HudUDec(HudNumber_t *h, uint32_t n){
+  char text[10];
+  hudShow(h, text, udecFormat(text, n));
+}
+
+//------------ST7735_HudFix------------
+// Show a signed fixed-point number n/10^decimals in a heads-up
+// display field, e.g. 1234 with 2 decimals is 12.34.  Only the
+// characters that changed are drawn.
+// Requires (11 + 96*size*size*n) bytes for each run of n changed characters
+// Input: h         pointer to the field, see ST7735_HudInit()
+//        n         number to show times 10^decimals
+//        decimals  digits after the point, 0 to 9
+// Output: none
+void ST7735_HudFix(HudNumber_t *h, int32_t n, uint8_t decimals){
+  char text[12];
+  hudShow(h, text, fixFormat(text, n, decimals));
+}
+
 
 
 
@@ -1218,6 +2988,11 @@ void ST7735_OutUDec(uint32_t n){
 // Output: none
 void ST7735_SetRotation(uint8_t m) {
 
+  if(ScrollOn || StripOn){              // scroll area depends on rotation
+    writecommand(ST7735_NORON);         // leave scroll mode
+    ScrollOn = 0;
+    StripOn = 0;
+  }
   writecommand(ST7735_MADCTL);
   Rotation = m % 4; // can't be higher than 3
   switch (Rotation) {
@@ -1316,10 +3091,7 @@ void ST7735_PlotPoint(int32_t y){int32_t j;
   j = 32+(127*(Ymax-y))/Yrange;
   if(j<32) j = 32;
   if(j>159) j = 159;
-  ST7735_DrawPixel(X,   j,   ST7735_BLUE);
-  ST7735_DrawPixel(X+1, j,   ST7735_BLUE);
-  ST7735_DrawPixel(X,   j+1, ST7735_BLUE);
-  ST7735_DrawPixel(X+1, j+1, ST7735_BLUE);
+  pushRect(X, j, 2, 2, ST7735_BLUE);    // 2x2 point, one window
 }
 // *************** ST7735_PlotLine ********************
 // Used in the voltage versus time plot, plot line to new point
@@ -1327,7 +3099,7 @@ void ST7735_PlotPoint(int32_t y){int32_t j;
 // Inputs: y is the y coordinate of the point plotted
 // Outputs: none
 int32_t lastj=0;
-void ST7735_PlotLine(int32_t y){int32_t i,j;
+void ST7735_PlotLine(int32_t y){int32_t j;
   if(y<Ymin) y=Ymin;
   if(y>Ymax) y=Ymax;
   // X goes from 0 to 127
@@ -1339,19 +3111,13 @@ void ST7735_PlotLine(int32_t y){int32_t i,j;
   if(j > 159) j = 159;
   if(lastj < 32) lastj = j;
   if(lastj > 159) lastj = j;
+  // one 2-pixel wide span from the last point to this one
   if(lastj < j){
-    for(i = lastj+1; i<=j ; i++){
-      ST7735_DrawPixel(X,   i,   ST7735_BLUE) ;
-      ST7735_DrawPixel(X+1, i,   ST7735_BLUE) ;
-    }
+    pushRect(X, lastj+1, 2, j-lastj, ST7735_BLUE);
   }else if(lastj > j){
-    for(i = j; i<lastj ; i++){
-      ST7735_DrawPixel(X,   i,   ST7735_BLUE) ;
-      ST7735_DrawPixel(X+1, i,   ST7735_BLUE) ;
-    }
+    pushRect(X, j, 2, lastj-j, ST7735_BLUE);
   }else{
-    ST7735_DrawPixel(X,   j,   ST7735_BLUE) ;
-    ST7735_DrawPixel(X+1, j,   ST7735_BLUE) ;
+    pushRect(X, j, 2, 1, ST7735_BLUE);
   }
   lastj = j;
 }
@@ -1476,6 +3242,348 @@ void ST7735_PlotNextErase(void){
   ST7735_DrawFastVLine(X,32,128,ST7735_Color565(228,228,228));
 }
 
+// Scrolling strip chart
+// The whole screen is a chart whose newest sample is the right
+// column.  Each sample rewrites one column of frame memory (the
+// column at the left edge, the oldest) as a single window, composed
+// in RAM and streamed by the uDMA.  The hardware scroll start moves
+// by one column at the next sample, once the column is written, so
+// a column only appears at the right edge complete.  The scroll is
+// not sent from the uDMA interrupt, where the command would wait for
+// the SSI.  Nothing else is redrawn, so a sample costs about 14
+// command bytes plus 2 bytes per row.
+// Memory: 2*DMA_LINEMAX*2 bytes = 640 bytes
+static uint16_t StripLine[2][DMA_LINEMAX]; // column (strip) or row (waterfall)
+static uint8_t StripSel;                // buffer to compose the next line in
+static int16_t StripPos;                // frame memory line of the next sample
+static int16_t StripLast;               // row of the previous sample, -1 for none
+static uint8_t StripScrollDue;          // 1 if the last line sent is not scrolled in
+static int32_t StripMin, StripRange;
+static uint16_t StripColor, StripBgColor;
+
+// Multi-trace chart on the same scrolling strip.  Samples may come
+// much faster than columns (and from an interrupt), so each channel
+// keeps the lowest and highest value since the last column; every
+// TracePerColumn samples the envelopes go into a FIFO that
+// ST7735_TraceUpdate() drains.  If the FIFO is full the current
+// column keeps collecting, so a burst is never lost, the column
+// just covers more time.
+// Memory: about 2*TRACE_FIFO*TRACE_MAX*4 bytes = 512 bytes
+#define TRACE_MAX 4                     // channels
+#define TRACE_FIFO 16                   // finished columns waiting to be drawn
+static uint8_t TraceChannels;           // 0 if no trace chart is running
+static uint32_t TracePerColumn;         // samples per column
+static uint32_t TraceCount;             // samples in the column being collected
+static int32_t TraceMin[TRACE_MAX], TraceMax[TRACE_MAX];
+static int32_t TraceFifoMin[TRACE_FIFO][TRACE_MAX];
+static int32_t TraceFifoMax[TRACE_FIFO][TRACE_MAX];
+static volatile uint8_t TraceHead, TraceTail;
+static uint16_t TraceColor[TRACE_MAX];
+static int16_t TraceTop[TRACE_MAX], TraceBottom[TRACE_MAX]; // rows of the last column, -1 for none
+
+// Set the value range and clear the screen for a chart, and start
+// scrolling the whole screen in a landscape rotation.
+void static stripBegin(int32_t ymin, int32_t ymax, uint16_t bgColor){
+  TraceChannels = 0;
+  if((Rotation&0x01) == 0){
+    ST7735_SetRotation(1);
+  }
+  if(ScrollOn || StripOn){
+    writecommand(ST7735_NORON);         // leave the previous scroll mode
+    ScrollOn = 0;
+  }
+  if(ymax < ymin){
+    StripMin = ymax;
+    StripRange = ymin - ymax;
+  } else{
+    StripMin = ymin;
+    StripRange = ymax - ymin;
+  }
+  if(StripRange == 0) StripRange = 1;
+  StripBgColor = bgColor;
+  StripPos = 0;
+  StripLast = -1;
+  StripScrollDue = 0;
+  ST7735_FillScreen(bgColor);
+  scrollDefine(_width);
+  scrollTo(0, _width);
+  StripOn = 1;
+}
+
+// Row of the screen that shows value y, clipped to the range.
+int32_t static stripRow(int32_t y){
+  if(y < StripMin) y = StripMin;
+  if(y > StripMin + StripRange) y = StripMin + StripRange;
+  return (_height-1) - ((_height-1)*(y - StripMin))/StripRange;
+}
+
+// Send a composed column as the new right edge of the chart and
+// scroll in the one sent before it.  Returns while the column may
+// still be streaming; the next one is composed in the other buffer.
+void static stripSend(uint16_t *col){
+  if(StripScrollDue){
+    scrollTo(StripPos, _width);         // waits for the previous column
+  }
+  setAddrWindow(StripPos, 0, StripPos, _height-1);
+  DMASrc = col;
+  DMARowWidth = _height;
+  DMARowStride = 0;
+  DMARemaining = 1;
+  DMAStaged = 0;
+  DMABpp = 0;
+  DMADone = 0;
+  dmaBegin();
+  StripSel ^= 1;
+  StripPos = (StripPos + 1)%_width;     // where the scroll puts the left edge
+  StripScrollDue = 1;
+}
+
+//------------ST7735_StripInit------------
+// Start a scrolling strip chart that covers the whole screen.  The
+// panel can only scroll along its frame memory rows, which run left
+// to right in the landscape rotations, so rotation 1 is selected
+// unless the display is already in rotation 1 or 3.  Samples are
+// added with ST7735_StripSample(); ST7735_SetRotation() or
+// ST7735_SetScrollConsole() end the chart.
+// Requires 13 bytes of transmission plus a screen fill
+// Input: ymin    sample value shown at the bottom edge
+//        ymax    sample value shown at the top edge
+//        color   16-bit color of the trace
+//        bgColor 16-bit color of the background
+// Output: none
+void ST7735_StripInit(int32_t ymin, int32_t ymax, uint16_t color, uint16_t bgColor){
+  StripColor = color;
+  stripBegin(ymin, ymax, bgColor);
+}
+
+//------------ST7735_StripSample------------
+// Add one sample to the right edge of the strip chart and scroll
+// the older samples one column to the left.  The trace is a vertical
+// span from the previous sample to this one, so fast changes stay
+// connected.  Returns while the column may still be streaming;
+// composing the next column overlaps with it.  The column is
+// scrolled into view by the next call, once it is written, so the
+// chart shows every sample but the newest.
+// Requires (14 + 2*h) bytes of transmission, h the screen height
+// Input: y  sample value, clipped to the range given to ST7735_StripInit()
+// Output: none
+void ST7735_StripSample(int32_t y){
+  uint16_t *col;
+  int32_t j, lo, hi, i;
+  if(!StripOn) return;
+  j = stripRow(y);
+  lo = hi = j;
+  if(StripLast >= 0){
+    if(StripLast < lo) lo = StripLast;
+    if(StripLast > hi) hi = StripLast;
+  }
+  col = StripLine[StripSel];            // the other buffer may be streaming
+  for(i=0; i<_height; i=i+1){
+    col[i] = ((i >= lo) && (i <= hi)) ? StripColor : StripBgColor;
+  }
+  stripSend(col);
+  StripLast = j;
+}
+
+//------------ST7735_TraceInit------------
+// Start a scrolling chart of up to four channels that may be
+// sampled much faster than the screen can scroll.  Every
+// samplesPerColumn samples become one column showing, for each
+// channel, a vertical span from its lowest to its highest value in
+// that time, joined to the span of the column before.  Like
+// ST7735_StripInit() the whole screen scrolls in a landscape
+// rotation; ST7735_SetRotation() or ST7735_SetScrollConsole() end
+// the chart.
+// Requires 13 bytes of transmission plus a screen fill
+// Input: channels         number of traces, 1 to 4
+//        ymin             sample value shown at the bottom edge
+//        ymax             sample value shown at the top edge
+//        samplesPerColumn samples of each channel per column, at least 1
+//        colors           pointer to a 16-bit color for each trace; later traces are drawn over earlier ones
+//        bgColor          16-bit color of the background
+// Output: none
+void ST7735_TraceInit(uint8_t channels, int32_t ymin, int32_t ymax, uint32_t samplesPerColumn,
+                      const uint16_t *colors, uint16_t bgColor){
+  uint32_t c;
+  stripBegin(ymin, ymax, bgColor);
+  if(channels > TRACE_MAX) channels = TRACE_MAX;
+  for(c=0; c<channels; c=c+1){
+    TraceColor[c] = colors[c];
+    TraceTop[c] = -1;
+  }
+  TracePerColumn = samplesPerColumn ? samplesPerColumn : 1;
+  TraceCount = 0;
+  TraceHead = TraceTail = 0;
+  TraceChannels = channels;             // last, samples may already be arriving
+}
+
+//------------ST7735_TraceSample------------
+// Add one sample of every channel to the trace chart.  Only
+// compares a few numbers, nothing is drawn, so it may be called
+// from the interrupt that reads the ADC.
+// Input: y  pointer to one value for each channel
+// Output: none
+void ST7735_TraceSample(const int32_t *y){
+  uint32_t c, next;
+  if(TraceChannels == 0) return;
+  if(TraceCount == 0){
+    for(c=0; c<TraceChannels; c=c+1){
+      TraceMin[c] = TraceMax[c] = y[c];
+    }
+  } else{
+    for(c=0; c<TraceChannels; c=c+1){
+      if(y[c] < TraceMin[c]) TraceMin[c] = y[c];
+      if(y[c] > TraceMax[c]) TraceMax[c] = y[c];
+    }
+  }
+  TraceCount++;
+  if(TraceCount >= TracePerColumn){
+    next = (TraceHead + 1)%TRACE_FIFO;
+    if(next != TraceTail){              // else keep widening this column
+      for(c=0; c<TraceChannels; c=c+1){
+        TraceFifoMin[TraceHead][c] = TraceMin[c];
+        TraceFifoMax[TraceHead][c] = TraceMax[c];
+      }
+      TraceHead = next;
+      TraceCount = 0;
+    }
+  }
+}
+
+//------------ST7735_TraceUpdate------------
+// Draw the columns of the trace chart finished since the last call.
+// Each column, with all of its traces, is composed in RAM and sent
+// as one window.  Like the strip chart, each column is scrolled
+// into view by the next one, once it is written.  Call from the
+// main loop.
+// Requires (14 + 2*h) bytes of transmission per column, h the screen height
+// Input: none
+// Output: number of columns drawn
+uint32_t ST7735_TraceUpdate(void){
+  uint16_t *col;
+  int32_t i, c, top, bottom, lo, hi;
+  uint32_t n = 0;
+  if((TraceChannels == 0) || !StripOn) return 0;
+  while(TraceTail != TraceHead){
+    col = StripLine[StripSel];          // the other buffer may be streaming
+    for(i=0; i<_height; i=i+1){
+      col[i] = StripBgColor;
+    }
+    for(c=0; c<TraceChannels; c=c+1){
+      top = stripRow(TraceFifoMax[TraceTail][c]);
+      bottom = stripRow(TraceFifoMin[TraceTail][c]);
+      lo = top;
+      hi = bottom;
+      if(TraceTop[c] >= 0){             // join the previous column
+        if(lo > TraceBottom[c]) lo = TraceBottom[c];
+        if(hi < TraceTop[c]) hi = TraceTop[c];
+      }
+      for(i=lo; i<=hi; i=i+1){
+        col[i] = TraceColor[c];
+      }
+      TraceTop[c] = top;
+      TraceBottom[c] = bottom;
+    }
+    TraceTail = (TraceTail + 1)%TRACE_FIFO;
+    stripSend(col);
+    n = n + 1;
+  }
+  return n;
+}
+
+// Waterfall
+// Same idea as the strip chart turned on its side: each spectrum
+// becomes one colored row at the top of the screen and the history
+// moves down by hardware scroll.  Levels come from the dBfs table,
+// so colors follow the same log scale as ST7735_PlotdBfs().
+// Palette from black (quiet) through blue, cyan, green, yellow and
+// red to white (full scale), indexed by 0 to 127 above the floor.
+static const uint16_t WaterfallPalette[128] = {
+  0x0000, 0x0800, 0x1800, 0x2000, 0x3000, 0x3800, 0x4800, 0x5000,
+  0x6000, 0x6800, 0x7800, 0x8000, 0x9000, 0x9800, 0xA800, 0xB000,
+  0xC000, 0xC800, 0xD800, 0xE000, 0xF000, 0xF800, 0xF860, 0xF8C0,
+  0xF920, 0xF980, 0xF9E0, 0xFA40, 0xFAA0, 0xFB00, 0xFB60, 0xFBC0,
+  0xFC20, 0xFC80, 0xFCE0, 0xFD40, 0xFDA0, 0xFE00, 0xFE60, 0xFEC0,
+  0xFF20, 0xFF80, 0xFFE0, 0xF7E0, 0xEFE0, 0xDFE0, 0xD7E0, 0xC7E0,
+  0xBFE0, 0xAFE0, 0xA7E0, 0x97E0, 0x8FE0, 0x87E0, 0x77E0, 0x6FE0,
+  0x5FE0, 0x57E0, 0x47E0, 0x3FE0, 0x2FE0, 0x27E0, 0x17E0, 0x0FE0,
+  0x07E0, 0x07E1, 0x07E3, 0x07E4, 0x07E6, 0x07E7, 0x07E9, 0x07EA,
+  0x07EC, 0x07ED, 0x07EF, 0x07F0, 0x07F2, 0x07F3, 0x07F5, 0x07F6,
+  0x07F8, 0x07F9, 0x07FB, 0x07FC, 0x07FE, 0x07FF, 0x079F, 0x073F,
+  0x06DF, 0x067F, 0x061F, 0x05BF, 0x055F, 0x04FF, 0x049F, 0x043F,
+  0x03DF, 0x037F, 0x031F, 0x02BF, 0x025F, 0x01FF, 0x019F, 0x013F,
+  0x00DF, 0x007F, 0x001F, 0x087F, 0x18DF, 0x213F, 0x319F, 0x39FF,
+  0x4A5F, 0x52BF, 0x631F, 0x6B7F, 0x7BDF, 0x843F, 0x949F, 0x9CFF,
+  0xAD5F, 0xB5BF, 0xC61F, 0xCE7F, 0xDEDF, 0xE73F, 0xF79F, 0xFFFF
+};
+
+//------------ST7735_WaterfallInit------------
+// Start a waterfall display that covers the whole screen.  Rows
+// scroll down, so the portrait rotation 0 is selected unless the
+// display is already in rotation 0 or 2.  Rows are added with
+// ST7735_WaterfallRow(); ST7735_SetRotation() or
+// ST7735_SetScrollConsole() end the waterfall.
+// Requires 13 bytes of transmission plus a screen fill
+// Input: none
+// Output: none
+void ST7735_WaterfallInit(void){
+  if(Rotation&0x01){
+    ST7735_SetRotation(0);
+  }
+  if(ScrollOn || StripOn){
+    writecommand(ST7735_NORON);         // leave the previous scroll mode
+    ScrollOn = 0;
+  }
+  StripPos = 0;
+  StripScrollDue = 0;
+  ST7735_FillScreen(ST7735_BLACK);
+  scrollDefine(_height);
+  scrollTo(0, _height);
+  StripOn = 1;
+}
+
+//------------ST7735_WaterfallRow------------
+// Add one spectrum as a new row at the top of the waterfall and
+// move the older rows down one.  Each magnitude is one pixel,
+// colored on the same dB scale as ST7735_PlotdBfs(); pixels past
+// the last magnitude are black.  Returns while the row may still be
+// streaming.  Like the strip chart, the row is scrolled into view
+// by the next call, once it is written.
+// Requires (14 + 2*w) bytes of transmission, w the screen width
+// Input: mag  magnitudes, 0 to 1023 is the range of ST7735_PlotdBfs()
+//        n    number of magnitudes
+// Output: none
+void ST7735_WaterfallRow(const uint16_t *mag, uint32_t n){
+  uint16_t *row;
+  int32_t i, y;
+  if(!StripOn) return;
+  row = StripLine[StripSel];            // the other buffer may be streaming
+  for(i=0; i<_width; i=i+1){
+    if(i < n){
+      y = mag[i]/2;
+      if(y > 511) y = 511;
+      row[i] = WaterfallPalette[159 - dBfs[y]];
+    } else{
+      row[i] = ST7735_BLACK;
+    }
+  }
+  if(StripScrollDue){
+    scrollTo(StripPos, _height);        // waits for the previous row
+  }
+  StripPos = (StripPos + _height - 1)%_height; // the row above the newest
+  setAddrWindow(0, StripPos, _width-1, StripPos);
+  DMASrc = row;
+  DMARowWidth = _width;
+  DMARowStride = 0;
+  DMARemaining = 1;
+  DMAStaged = 0;
+  DMABpp = 0;
+  DMADone = 0;
+  dmaBegin();
+  StripSel ^= 1;
+  StripScrollDue = 1;
+}
+
 // Used in all the plots to write buffer to LCD
 // Example 1 Voltage versus time
 //    ST7735_PlotClear(0,4095);  // range from 0 to 4095
@@ -1519,54 +3627,175 @@ void ST7735_PlotNextErase(void){
 //        ST7735_PlotNext();
 //    }   // called 128 times
 
-// *************** ST7735_OutChar ********************
-// Output one character to the LCD
-// Position determined by ST7735_SetCursor command
-// Color set by ST7735_SetTextColor
-// Inputs: 8-bit ASCII character
-// Outputs: none
-void ST7735_OutChar(char ch){
+// Set one console cell, marking it for ST7735_TextFlush() only if
+// it will look different.  The foreground of a blank does not show.
+void static textPut(uint32_t c, uint32_t line, char ch, uint16_t fg, uint16_t bg){
+  if((TextChar[line][c] == ch) && (TextBg[line][c] == bg) &&
+     ((ch == ' ') || (TextFg[line][c] == fg)) &&
+     ((TextUnknown[line] & (1<<c)) == 0)){
+    return;                             // already shown
+  }
+  TextUnknown[line] &= ~(1<<c);
+  TextChar[line][c] = ch;
+  TextFg[line][c] = fg;
+  TextBg[line][c] = bg;
+  TextDirty[line] |= 1<<c;
+}
+
+// Blank the current console line.  This waits for the first flush
+// after something is written to the line (or the cursor leaves it),
+// so that a line rewritten with the same text is not sent at all.
+void static textClearLine(void){
+  uint32_t line = textLine();
+  TextBlank |= 1<<line;
+  TextFresh[line] = 0;
+}
+
+// Write one character to the console shadow at the cursor and
+// advance it; a newline moves to the next line and blanks it.
+// Nothing is drawn until ST7735_TextFlush().
+void static textChar(char ch){
   if((ch == 10) || (ch == 13) || (ch == 27)){
-    StY++; StX=0;
-    if(StY>15){
-      StY = 0;
+    StX = 0;
+    if(ScrollOn){
+      if(StY < ScrollLines-1){
+        StY++;
+      } else{
+        ScrollTop = (ScrollTop + 1)%ScrollLines; // oldest line becomes the bottom
+        scrollStart();
+      }
+    } else{
+      StY++;
+      if(StY>15){
+        StY = 0;
+      }
     }
-    ST7735_DrawString(0,StY,"                     ",StTextColor);
+    textClearLine();
     return;
   }
-  ST7735_DrawCharS(StX*6,StY*10,ch,ST7735_YELLOW,ST7735_BLACK, 1);
+  textPut(StX, textLine(), ch, StTextColor, StTextBgColor);
+  TextFresh[textLine()] |= 1<<StX;
   StX++;
   if(StX>20){
     StX = 20;
-    ST7735_DrawCharS(StX*6,StY*10,'*',ST7735_RED,ST7735_BLACK, 1);
+    textPut(StX, textLine(), '*', ST7735_RED, StTextBgColor);
   }
-  return;
+}
+
+// *************** ST7735_OutChar ********************
+// Output one character to the LCD
+// Position determined by ST7735_SetCursor command
+// Color set by ST7735_SetTextColor and ST7735_SetTextBgColor
+// Nothing is sent if the cell already shows this character.
+// Inputs: 8-bit ASCII character
+// Outputs: none
+void ST7735_OutChar(char ch){
+  textChar(ch);
+  ST7735_TextFlush();
 }
 //********ST7735_OutString*****************
 // Print a string of characters to the ST7735 LCD.
 // Position determined by ST7735_SetCursor command
-// Color set by ST7735_SetTextColor
+// Color set by ST7735_SetTextColor and ST7735_SetTextBgColor
 // The string will not automatically wrap.
+// Only characters that differ from what the screen already shows
+// are sent, each run of them through one address window.
 // inputs: ptr  pointer to NULL-terminated ASCII string
 // outputs: none
 void ST7735_OutString(char *ptr){
   while(*ptr){
-    ST7735_OutChar(*ptr);
+    textChar(*ptr);
     ptr = ptr + 1;
   }
+  ST7735_TextFlush();
+}
+//********ST7735_TextFlush*****************
+// Draw the console cells that changed since the last flush, one
+// address window for each run of changed cells with the same
+// colors.  ST7735_OutChar() and ST7735_OutString() flush when they
+// are done; printf() output is flushed at the end of each line, so
+// call this to show a partial line.  A line begun by a newline is
+// blanked past its new text at the first flush after something is
+// written to it, or after the cursor leaves it, so reprinting the
+// same lines sends nothing.
+// Requires (11 + 96*n) bytes of transmission for each run of n cells
+// inputs: none
+// outputs: none
+void ST7735_TextFlush(void){
+  uint32_t line, c, n, bits;
+  uint16_t fg, bg;
+  uint32_t cursor = textLine();
+  for(line=0; line<16; line=line+1){
+    if((TextBlank & (1<<line)) &&       // blank what the new line did not write
+       (ScrollOn || (line != cursor) || TextFresh[line])){ // once it has been written
+      TextBlank &= ~(1<<line);
+      for(c=0; c<21; c=c+1){
+        if((TextFresh[line] & (1<<c)) == 0){
+          textPut(c, line, ' ', StTextColor, StTextBgColor);
+        }
+      }
+    }
+    bits = TextDirty[line];
+    TextDirty[line] = 0;
+    c = 0;
+    while(bits){
+      while((bits&0x01) == 0){
+        bits = bits>>1;
+        c = c + 1;
+      }
+      fg = TextFg[line][c];
+      bg = TextBg[line][c];
+      for(n=0; (bits&0x01) && (TextFg[line][c+n] == fg) && (TextBg[line][c+n] == bg); n=n+1){
+        bits = bits>>1;
+      }
+      if(fg == bg){                     // nothing to see but the background
+        pushRect(c*6, line*10, n*6, 8, bg);
+      } else{
+        drawText(c*6, line*10, &TextChar[line][c], n, fg, bg, 1);
+      }
+      c = c + n;
+    }
+  }
+}
+//********ST7735_TextInvalidate*****************
+// Mark every console cell to be redrawn by the next
+// ST7735_TextFlush().  Needed only after drawing over console text
+// with other functions, since the LCD cannot be read back;
+// ST7735_FillScreen() already keeps track.
+// inputs: none
+// outputs: none
+void ST7735_TextInvalidate(void){
+  uint32_t line;
+  for(line=0; line<16; line=line+1){
+    TextDirty[line] = 0x001FFFFF;       // all 21 cells
+  }
 }
 // ************** ST7735_SetTextColor ************************
 // Sets the color in which the characters will be printed
-// Background color is fixed at black
+// Background color is set by ST7735_SetTextBgColor
 // Input:  16-bit packed color
 // Output: none
 // ********************************************************
 void ST7735_SetTextColor(uint16_t color){
   StTextColor = color;
 }
+// ************** ST7735_SetTextBgColor ************************
+// Sets the background color of the characters printed
+// Default is black
+// Input:  16-bit packed color
+// Output: none
+// ********************************************************
+void ST7735_SetTextBgColor(uint16_t color){
+  StTextBgColor = color;
+}
 // Print a character to ST7735 LCD.
+// Output is buffered by line: the changed cells are drawn at the
+// end of each line (see ST7735_TextFlush()).
 int fputc(int ch, FILE *f){
-  ST7735_OutChar(ch);
+  textChar(ch);
+  if((ch == 10) || (ch == 13) || (ch == 27)){
+    ST7735_TextFlush();
+  }
   return 1;
 }
 // No input from Nokia, always return data.
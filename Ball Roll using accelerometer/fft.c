@@ -0,0 +1,185 @@
+// fft.c
+// Runs on LM4F120/TM4C123
+// Fixed-point (Q15) fast Fourier transform for spectrum displays.
+// Mixed radix 4/2, decimation in time, in place.
+// See fft.h for the interface.
+
+#include <stdint.h>
+#include "fft.h"
+
+// sin(2*pi*k/FFT_MAXN) in Q15 for the first quarter wave, k = 0 to FFT_MAXN/4
+static const int16_t Sine[FFT_MAXN/4+1] = {
+      0,   201,   402,   603,   804,  1005,  1206,  1407,
+   1608,  1809,  2009,  2210,  2411,  2611,  2811,  3012,
+   3212,  3412,  3612,  3812,  4011,  4211,  4410,  4609,
+   4808,  5007,  5205,  5404,  5602,  5800,  5998,  6195,
+   6393,  6590,  6787,  6983,  7180,  7376,  7571,  7767,
+   7962,  8157,  8351,  8546,  8740,  8933,  9127,  9319,
+   9512,  9704,  9896, 10088, 10279, 10469, 10660, 10850,
+  11039, 11228, 11417, 11605, 11793, 11980, 12167, 12354,
+  12540, 12725, 12910, 13095, 13279, 13463, 13646, 13828,
+  14010, 14192, 14373, 14553, 14733, 14912, 15091, 15269,
+  15447, 15624, 15800, 15976, 16151, 16326, 16500, 16673,
+  16846, 17018, 17190, 17361, 17531, 17700, 17869, 18037,
+  18205, 18372, 18538, 18703, 18868, 19032, 19195, 19358,
+  19520, 19681, 19841, 20001, 20160, 20318, 20475, 20632,
+  20788, 20943, 21097, 21251, 21403, 21555, 21706, 21856,
+  22006, 22154, 22302, 22449, 22595, 22740, 22884, 23028,
+  23170, 23312, 23453, 23593, 23732, 23870, 24008, 24144,
+  24279, 24414, 24548, 24680, 24812, 24943, 25073, 25202,
+  25330, 25457, 25583, 25708, 25833, 25956, 26078, 26199,
+  26320, 26439, 26557, 26674, 26791, 26906, 27020, 27133,
+  27246, 27357, 27467, 27576, 27684, 27791, 27897, 28002,
+  28106, 28209, 28311, 28411, 28511, 28610, 28707, 28803,
+  28899, 28993, 29086, 29178, 29269, 29359, 29448, 29535,
+  29622, 29707, 29792, 29875, 29957, 30038, 30118, 30196,
+  30274, 30350, 30425, 30499, 30572, 30644, 30715, 30784,
+  30853, 30920, 30986, 31050, 31114, 31177, 31238, 31298,
+  31357, 31415, 31471, 31527, 31581, 31634, 31686, 31737,
+  31786, 31834, 31881, 31927, 31972, 32015, 32058, 32099,
+  32138, 32177, 32214, 32251, 32286, 32319, 32352, 32383,
+  32413, 32442, 32470, 32496, 32522, 32546, 32568, 32590,
+  32610, 32629, 32647, 32664, 32679, 32693, 32706, 32718,
+  32729, 32738, 32746, 32753, 32758, 32762, 32766, 32767,
+  32767
+};
+
+// Twiddle factor angle 2*pi*t/FFT_MAXN for t from 0 to FFT_MAXN/2,
+// as cosine and sine in Q15.
+static void twiddle(uint32_t t, int32_t *c, int32_t *s){
+  if(t <= FFT_MAXN/4){
+    *s = Sine[t];
+    *c = Sine[FFT_MAXN/4 - t];
+  } else{
+    *s = Sine[FFT_MAXN/2 - t];
+    *c = -Sine[t - FFT_MAXN/4];
+  }
+}
+
+// Reorder n complex numbers into bit reversed index order.
+static void bitReverse(int16_t *x, uint32_t n){
+  uint32_t i, j, bit;
+  int16_t t;
+  j = 0;
+  for(i=0; i<n-1; i=i+1){
+    if(i < j){
+      t = x[2*i];   x[2*i] = x[2*j];     x[2*j] = t;
+      t = x[2*i+1]; x[2*i+1] = x[2*j+1]; x[2*j+1] = t;
+    }
+    bit = n>>1;
+    while(j & bit){
+      j = j^bit;
+      bit = bit>>1;
+    }
+    j = j|bit;
+  }
+}
+
+//------------FFT_LoadADC------------
+// Convert 12-bit ADC samples (0 to 4095, 2048 is zero) to Q15,
+// apply a Hann window, and store them as complex numbers with
+// zero imaginary part, ready for FFT_Q15().
+// Input: x    array of 2*n int16_t, filled by this function
+//        adc  array of n samples
+//        n    number of samples, power of 2 from 4 to FFT_MAXN
+// Output: none
+void FFT_LoadADC(int16_t *x, const uint16_t *adc, uint32_t n){
+  uint32_t i;
+  int32_t c, s, w;
+  for(i=0; i<n; i=i+1){
+    twiddle(i*(FFT_MAXN/2)/n, &c, &s);   // s = sin(pi*i/n)
+    w = (s*s)>>15;                       // Hann window sin^2, Q15
+    x[2*i] = (((int32_t)adc[i] - 2048)*16*w)>>15;
+    x[2*i+1] = 0;
+  }
+}
+
+//------------FFT_Q15------------
+// In place forward transform.  Radix-4 butterflies are used for
+// pairs of stages, plus one radix-2 stage when log2(n) is odd.
+// Input: x  array of n interleaved complex Q15 numbers
+//        n  power of 2 from 4 to FFT_MAXN
+// Output: none, x[2k], x[2k+1] hold X[k]/n in natural order
+void FFT_Q15(int16_t *x, uint32_t n){
+  uint32_t m, j, k, i0, i1, i2, i3, bits;
+  int32_t c1, s1, c2, s2;
+  int32_t p0r, p0i, p1r, p1i, p2r, p2i, p3r, p3i, tr, ti;
+  int32_t a0r, a0i, a1r, a1i, a2r, a2i, a3r, a3i;
+  bitReverse(x, n);
+  for(bits=n; bits>2; bits=bits>>2){}  // 2 if log2(n) is odd, else 1
+  m = 1;
+  if(bits == 2){                        // one radix-2 stage, twiddle is 1
+    for(k=0; k<n; k=k+2){
+      p0r = x[2*k];   p0i = x[2*k+1];
+      p1r = x[2*k+2]; p1i = x[2*k+3];
+      x[2*k]   = (p0r + p1r)>>1; x[2*k+1] = (p0i + p1i)>>1;
+      x[2*k+2] = (p0r - p1r)>>1; x[2*k+3] = (p0i - p1i)>>1;
+    }
+    m = 2;
+  }
+  // radix-4 butterflies, each one two radix-2 stages of half size m and 2m
+  for(; m<n; m=m*4){
+    for(j=0; j<m; j=j+1){
+      twiddle(j*(FFT_MAXN/2)/m, &c1, &s1);   // W(2m)^j
+      twiddle(j*(FFT_MAXN/4)/m, &c2, &s2);   // W(4m)^j
+      for(k=0; k<n; k=k+4*m){
+        i0 = k + j; i1 = i0 + m; i2 = i1 + m; i3 = i2 + m;
+        p0r = x[2*i0]; p0i = x[2*i0+1];
+        p1r = x[2*i1]; p1i = x[2*i1+1];
+        p2r = x[2*i2]; p2i = x[2*i2+1];
+        p3r = x[2*i3]; p3i = x[2*i3+1];
+        // first stage: p1 and p3 times W(2m)^j = c1 - j*s1
+        tr = (p1r*c1 + p1i*s1)>>15; ti = (p1i*c1 - p1r*s1)>>15;
+        a0r = (p0r + tr)>>1; a0i = (p0i + ti)>>1;
+        a1r = (p0r - tr)>>1; a1i = (p0i - ti)>>1;
+        tr = (p3r*c1 + p3i*s1)>>15; ti = (p3i*c1 - p3r*s1)>>15;
+        a2r = (p2r + tr)>>1; a2i = (p2i + ti)>>1;
+        a3r = (p2r - tr)>>1; a3i = (p2i - ti)>>1;
+        // second stage: a2 times W(4m)^j, a3 times W(4m)^(j+m) = -j*W(4m)^j
+        tr = (a2r*c2 + a2i*s2)>>15; ti = (a2i*c2 - a2r*s2)>>15;
+        x[2*i0] = (a0r + tr)>>1; x[2*i0+1] = (a0i + ti)>>1;
+        x[2*i2] = (a0r - tr)>>1; x[2*i2+1] = (a0i - ti)>>1;
+        tr = (a3r*c2 + a3i*s2)>>15; ti = (a3i*c2 - a3r*s2)>>15;
+        x[2*i1] = (a1r + ti)>>1; x[2*i1+1] = (a1i - tr)>>1;
+        x[2*i3] = (a1r - ti)>>1; x[2*i3+1] = (a1i + tr)>>1;
+      }
+    }
+  }
+}
+
+// Integer square root, rounded down.
+static uint32_t isqrt(uint32_t v){
+  uint32_t root = 0;
+  uint32_t bit = 1UL<<30;
+  while(bit > v){
+    bit = bit>>2;
+  }
+  while(bit){
+    if(v >= root + bit){
+      v = v - (root + bit);
+      root = (root>>1) + bit;
+    } else{
+      root = root>>1;
+    }
+    bit = bit>>2;
+  }
+  return root;
+}
+
+//------------FFT_Magnitude------------
+// Magnitudes of the first n/2 bins (DC up to just below the
+// Nyquist frequency).  A full scale sine wave loaded by
+// FFT_LoadADC() gives a peak of about 8192.
+// Input: x    transform from FFT_Q15()
+//        mag  array of n/2 results
+//        n    transform size
+// Output: none
+void FFT_Magnitude(const int16_t *x, uint16_t *mag, uint32_t n){
+  uint32_t k;
+  int32_t re, im;
+  for(k=0; k<n/2; k=k+1){
+    re = x[2*k];
+    im = x[2*k+1];
+    mag[k] = isqrt((uint32_t)(re*re) + (uint32_t)(im*im));
+  }
+}
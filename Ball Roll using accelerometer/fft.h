@@ -0,0 +1,39 @@
+// fft.h
+// Runs on LM4F120/TM4C123
+// Fixed-point (Q15) fast Fourier transform for spectrum displays.
+// Mixed radix 4/2, decimation in time, in place.  Samples are
+// interleaved complex numbers {real, imaginary, real, ...}.  Every
+// butterfly halves its results, so the transform never overflows and
+// bin k holds X[k]/n.
+// Needs no hardware; the same file builds on a PC for checking.
+
+// Largest transform size (length of the twiddle table)
+#define FFT_MAXN 1024
+
+//------------FFT_LoadADC------------
+// Convert 12-bit ADC samples (0 to 4095, 2048 is zero) to Q15,
+// apply a Hann window, and store them as complex numbers with
+// zero imaginary part, ready for FFT_Q15().
+// Input: x    array of 2*n int16_t, filled by this function
+//        adc  array of n samples
+//        n    number of samples, power of 2 from 4 to FFT_MAXN
+// Output: none
+void FFT_LoadADC(int16_t *x, const uint16_t *adc, uint32_t n);
+
+//------------FFT_Q15------------
+// In place forward transform.  Radix-4 butterflies are used for
+// pairs of stages, plus one radix-2 stage when log2(n) is odd.
+// Input: x  array of n interleaved complex Q15 numbers
+//        n  power of 2 from 4 to FFT_MAXN
+// Output: none, x[2k], x[2k+1] hold X[k]/n in natural order
+void FFT_Q15(int16_t *x, uint32_t n);
+
+//------------FFT_Magnitude------------
+// Magnitudes of the first n/2 bins (DC up to just below the
+// Nyquist frequency).  A full scale sine wave loaded by
+// FFT_LoadADC() gives a peak of about 8192.
+// Input: x    transform from FFT_Q15()
+//        mag  array of n/2 results
+//        n    transform size
+// Output: none
+void FFT_Magnitude(const int16_t *x, uint16_t *mag, uint32_t n);
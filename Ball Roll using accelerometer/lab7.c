@@ -8,12 +8,15 @@
 #include "inc/hw_types.h"
 #include "driverlib/debug.h"
 #include "driverlib/adc.h"
+#include "driverlib/timer.h"
+#include "driverlib/interrupt.h"
 #include "C:/ti/tivaware_c_series_2_1_4_178/driverlib/uart.h"
 #include "C:/ti/tivaware_c_series_2_1_4_178/utils/uartstdio.h"
 
 #include <stdio.h>
 #include "ST7735.h"
 #include "PLL.h"
+#include "fft.h"
 #include "tm4c123gh6pm.h"
 
 #define LCDHEIGHT 128
@@ -24,6 +27,23 @@
 #define MIN_X 1854
 #define MIN_Y 1797
 
+#define STRIP_CHART 0 // 1 to plot the X axis (CH7) as a 1 kHz strip chart instead,
+                      // 2 to plot both axes sampled at TRACE_FS as min/max traces
+#define SPECTRUM 0    // 1 to show the spectrum of the X axis (CH7) as bars,
+                      // 2 as a scrolling waterfall, instead
+
+#define RASTER 0      // 1 to draw the ball as a filled circle and its path as a
+                      // line in one step, instead of moving the ball sprite a
+                      // pixel at a time; window and byte counts of each
+                      // primitive are printed on UART0 first
+#define PATH_COLOR ST7735_Color565(160, 160, 160)
+
+#define FFT_N 256     // samples per transform, 128 bins across the screen
+#define FS 10240      // sample rate in Hz, 40 Hz per bin
+
+#define TRACE_FS 10000     // samples per second of each axis, STRIP_CHART 2
+#define TRACE_DECIMATE 40  // samples per column, 250 columns per second
+
 const uint16_t circle_3[]= {
      0XFFFF, 0XFFFF, 0XFFFF, 0XFFFF, 0XFFFF,
      0XFFFF, 0X0000, 0X0000, 0X0000, 0XFFFF,
@@ -32,9 +52,6 @@ const uint16_t circle_3[]= {
      0XFFFF, 0XFFFF, 0XFFFF, 0XFFFF, 0XFFFF,
 };
 
- //defining the rate of LCD cleaning
- #define FLIP_FREQ 4
-
  //global values definitions
  uint32_t ui32ADC0Value[8] = {0,0,0,0,0,0,0,0};//ADC values read
  uint32_t ui32ADC0Old[2] = {0,0};//ADC old values read
@@ -45,17 +62,30 @@ const uint16_t circle_3[]= {
  int yf = 0;
  int dx = 0;//steps to move
  int dy = 0;
+ Sprite_t ball;//ball sprite, only the part that moved is redrawn
+
+ uint16_t SpecBuf[2][FFT_N];//ADC samples, one buffer fills while the other is used
+ volatile int SpecFull = -1;//buffer ready for the FFT, -1 for none
+ uint32_t SpecCount = 0;//samples in the buffer being filled
+ uint32_t SpecFill = 0;//buffer being filled
 
  //functions definition
  void DelayWait10ms (uint32_t n);
  void display_init(void);
  void display(void);
  void circle(int x, int y);
+ void stripChart(void);
+ void traceChart(void);
+ void ADC0Seq2Handler(void);
+ void spectrum(void);
+ void ADC0Seq3Handler(void);
+ void ConfigureUART(void);
+ void rasterBench(void);
+ void pathStep(int x0, int y0, int x1, int y1);
 
 int main()
 {
     //Var declaration section
-    int flip = FLIP_FREQ;
     int i = 0;
     int j = 0;
     //Set init value at the middle of LCD
@@ -72,6 +102,9 @@ int main()
     long int difference [2] = {0,0};
     //setting system clock to 80 MHz
     PLL_Init(Bus80MHz);
+    //the LCD driver streams pixels by uDMA and waits for its SSI0
+    //interrupt, this project has no startup file so it is installed here
+    IntRegister(INT_SSI0, SSI0Handler);
         // iniltiaze LCD
     ST7735_InitR(INITR_REDTAB);
     //Startup screen with lab # 4 and authors
@@ -123,7 +156,21 @@ int main()
     // ENABLE THE SEQUENCE 1 FOR ADCO
     ADCSequenceEnable(ADC0_BASE, 0);
 
+#if STRIP_CHART == 2
+    traceChart();
+#elif STRIP_CHART
+    stripChart();
+#endif
+#if SPECTRUM
+    spectrum();
+#endif
+#if RASTER
+    rasterBench();
+#endif
+
     ST7735_FillScreen(0xFFFF);
+    ST7735_SpriteBackground(0xFFFF);
+    ST7735_SpriteInit(&ball, circle_3, 5, 5, -1);
 
     xi = 59;
     yi = 54;
@@ -135,18 +182,15 @@ int main()
     y = yi;
     xf = xi;
     yf = yi;
+#if RASTER
+    ST7735_FillCircle(xi + 2, yi - 2, 2, ST7735_BLACK);
+#else
     circle(xi, yi);
+#endif
 
 while(1)
 {
 
-    if (flip == 0)
-    {
-    ST7735_FillScreen(0xFFFF);
-    flip = FLIP_FREQ;
-    }
-    flip--;
-
     ADCIntClear(ADC0_BASE, 0);
 
     ADCProcessorTrigger(ADC0_BASE, 0);
@@ -177,9 +221,14 @@ while(1)
     yf = (ui32ADC0Value [1] - MIN_Y ) / 2;
     yf = 128 - yf;
 
+#if RASTER
+    pathStep(xi, yi, xf, yf);
+    x = xf;
+    y = yf;
+#else
     if ((xf == xi) && (yf == yi))
     {
-        ST7735_DrawBitmap(xf, yf, circle_3 ,5, 5);
+        circle(xf, yf);
     }
     else if (xf == xi)
     {
@@ -413,6 +462,7 @@ while(1)
             }
         }
     }
+#endif
     ui32ADC0Old[0]=ui32ADC0Value[0];
     ui32ADC0Old[1]=ui32ADC0Value[1];
     xi=x;
@@ -421,7 +471,186 @@ while(1)
     return 0;
   }
 void circle(int x,int y){
-    ST7735_DrawBitmap(x,y,circle_3,5,5);
+    ST7735_SpriteMove(&ball, x, y);
+    ST7735_SpriteUpdate(&ball, 1);
+}
+// Move the ball from (x0,y0) to (x1,y1), given as the bottom left
+// corner of its 5x5 box like circle(), leaving its path drawn as a
+// line.  Each primitive is one window per span, so the whole step
+// is a few dozen windows however far the ball moved.
+void pathStep(int x0, int y0, int x1, int y1){
+    if((x0 == x1) && (y0 == y1))
+    {
+        return;
+    }
+    ST7735_FillCircle(x0 + 2, y0 - 2, 2, ST7735_WHITE);        // erase the ball
+    ST7735_DrawLine(x0 + 2, y0 - 2, x1 + 2, y1 - 2, PATH_COLOR);
+    ST7735_FillCircle(x1 + 2, y1 - 2, 2, ST7735_BLACK);
+}
+// Draw one of each rasterizer primitive and print on UART0 how many
+// address windows and bytes it took.  One window per pixel would
+// cost 13 bytes a pixel; these cost 3 to 11 bytes a span.
+void rasterBench(void){
+    static const int16_t hexagon[12] = {64,20, 100,40, 100,80, 64,100, 28,80, 28,40};
+    ConfigureUART();
+    ST7735_FillScreen(ST7735_WHITE);
+
+    ST7735_ClearTxCount();
+    ST7735_DrawLine(5, 10, 120, 50, ST7735_BLUE);
+    UARTprintf("line 116x41:     %d windows, %d bytes\n", ST7735_GetWindowCount(), ST7735_GetTxCount());
+    ST7735_ClearTxCount();
+    ST7735_DrawLine(10, 5, 30, 120, ST7735_BLUE);
+    UARTprintf("line 21x116:     %d windows, %d bytes\n", ST7735_GetWindowCount(), ST7735_GetTxCount());
+    ST7735_ClearTxCount();
+    ST7735_DrawCircle(64, 64, 40, ST7735_RED);
+    UARTprintf("circle r=40:     %d windows, %d bytes\n", ST7735_GetWindowCount(), ST7735_GetTxCount());
+    ST7735_ClearTxCount();
+    ST7735_FillCircle(64, 64, 20, ST7735_GREEN);
+    UARTprintf("disc r=20:       %d windows, %d bytes\n", ST7735_GetWindowCount(), ST7735_GetTxCount());
+    ST7735_ClearTxCount();
+    ST7735_FillTriangle(10, 120, 64, 70, 118, 110, ST7735_MAGENTA);
+    UARTprintf("triangle:        %d windows, %d bytes\n", ST7735_GetWindowCount(), ST7735_GetTxCount());
+    ST7735_ClearTxCount();
+    ST7735_FillPolygon(hexagon, 6, ST7735_CYAN);
+    UARTprintf("hexagon:         %d windows, %d bytes\n", ST7735_GetWindowCount(), ST7735_GetTxCount());
+
+    DelayWait10ms(300);
+}
+// Scroll the X axis of the accelerometer across the screen, one
+// column per sample, about 1000 samples per second.  Never returns.
+void stripChart(void){
+    ST7735_StripInit(MIN_X, MAX_X, ST7735_YELLOW, ST7735_BLACK);
+    while(1)
+    {
+        ADCIntClear(ADC0_BASE, 0);
+        ADCProcessorTrigger(ADC0_BASE, 0);
+        while (!ADCIntStatus(ADC0_BASE,0,0)){}
+        ADCSequenceDataGet(ADC0_BASE, 0, ui32ADC0Value);
+        ST7735_StripSample(ui32ADC0Value[0]);
+        SysCtlDelay(SysCtlClockGet()/3000 - 1000); // 1 ms less ~40 us to sample and set up the column
+    }
+}
+// Timer 0A starts a conversion of both axes on sequencer 2 every
+// 1/TRACE_FS seconds.  The ADC interrupt only keeps the lowest and
+// highest value of each axis; the main loop draws a column of both
+// envelopes every TRACE_DECIMATE samples, so a tap shorter than a
+// column still shows as a spike.  Never returns.
+void traceChart(void){
+    static const uint16_t colors[2] = {ST7735_YELLOW, ST7735_CYAN};
+    ADCSequenceDisable(ADC0_BASE, 2);
+    ADCSequenceConfigure(ADC0_BASE, 2, ADC_TRIGGER_TIMER, 0);
+    ADCSequenceStepConfigure(ADC0_BASE, 2, 0, ADC_CTL_CH7);
+    ADCSequenceStepConfigure(ADC0_BASE, 2, 1, ADC_CTL_CH6 | ADC_CTL_IE | ADC_CTL_END);
+    ADCSequenceEnable(ADC0_BASE, 2);
+    ADCIntRegister(ADC0_BASE, 2, ADC0Seq2Handler);
+    ADCIntEnable(ADC0_BASE, 2);
+
+    ST7735_TraceInit(2, MIN_Y, MAX_X, TRACE_DECIMATE, colors, ST7735_BLACK);
+
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_TIMER0);
+    TimerConfigure(TIMER0_BASE, TIMER_CFG_PERIODIC);
+    TimerLoadSet(TIMER0_BASE, TIMER_A, SysCtlClockGet()/TRACE_FS - 1);
+    TimerControlTrigger(TIMER0_BASE, TIMER_A, true);
+    IntMasterEnable();
+    TimerEnable(TIMER0_BASE, TIMER_A);
+    while(1)
+    {
+        ST7735_TraceUpdate();
+    }
+}
+void ADC0Seq2Handler(void){
+    uint32_t value[4];
+    int32_t y[2];
+    ADCIntClear(ADC0_BASE, 2);
+    ADCSequenceDataGet(ADC0_BASE, 2, value);
+    y[0] = value[0];
+    y[1] = value[1];
+    ST7735_TraceSample(y);
+}
+// Timer 0A starts a conversion every 1/FS seconds, so the samples are
+// evenly spaced no matter what the main loop is doing.  Samples are
+// collected by the ADC interrupt into two buffers of FFT_N.
+// Each 256-point transform takes well under 1 ms at 80 MHz.  As bars
+// the display dominates, with 128 columns erased and redrawn (about
+// 43 kbytes), so the spectrum updates about 20 times a second.  As a
+// waterfall each spectrum is one 270-byte row and every one of the
+// 40 buffers a second is shown.
+// With bars, the strongest bin (not DC) is shown above the plot;
+// only the digits that change are redrawn.
+// Never returns.
+void spectrum(void){
+    static int16_t x[2*FFT_N];
+    static uint16_t mag[FFT_N/2];
+#if SPECTRUM != 2
+    static HudNumber_t peakHz, peakMag;
+#endif
+    uint32_t k, peak;
+    ADCSequenceDisable(ADC0_BASE, 3);
+    ADCSequenceConfigure(ADC0_BASE, 3, ADC_TRIGGER_TIMER, 0);
+    ADCSequenceStepConfigure(ADC0_BASE, 3, 0, ADC_CTL_CH7 | ADC_CTL_IE | ADC_CTL_END);
+    ADCSequenceEnable(ADC0_BASE, 3);
+    ADCIntRegister(ADC0_BASE, 3, ADC0Seq3Handler);
+    ADCIntEnable(ADC0_BASE, 3);
+
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_TIMER0);
+    TimerConfigure(TIMER0_BASE, TIMER_CFG_PERIODIC);
+    TimerLoadSet(TIMER0_BASE, TIMER_A, SysCtlClockGet()/FS - 1);
+    TimerControlTrigger(TIMER0_BASE, TIMER_A, true);
+    IntMasterEnable();
+    TimerEnable(TIMER0_BASE, TIMER_A);
+
+#if SPECTRUM == 2
+    ST7735_WaterfallInit();
+#else
+    ST7735_FillScreen(ST7735_BLACK);
+    ST7735_PlotClear(0, 4095);
+    ST7735_DrawString(0, 0, "Peak", ST7735_WHITE);
+    ST7735_DrawString(12, 0, "Hz", ST7735_WHITE);
+    ST7735_DrawString(0, 1, "Level", ST7735_WHITE);
+    ST7735_HudInit(&peakHz, 36, 0, 5, 1, ST7735_YELLOW, ST7735_BLACK);
+    ST7735_HudInit(&peakMag, 36, 10, 5, 1, ST7735_YELLOW, ST7735_BLACK);
+#endif
+    while(1)
+    {
+        while(SpecFull < 0){}
+        FFT_LoadADC(x, SpecBuf[SpecFull], FFT_N);
+        SpecFull = -1;
+        FFT_Q15(x, FFT_N);
+        FFT_Magnitude(x, mag, FFT_N);
+        peak = 1;
+        for(k = 0; k < FFT_N/2; k++)
+        {
+            mag[k] = mag[k] >> 3; // full scale sine is about 1024
+            if((k > 0) && (mag[k] > mag[peak]))
+            {
+                peak = k;
+            }
+#if SPECTRUM != 2
+            ST7735_PlotNextErase();
+            ST7735_PlotdBfs(mag[k]);
+#endif
+        }
+#if SPECTRUM != 2
+        ST7735_HudUDec(&peakHz, peak*(FS/FFT_N));
+        ST7735_HudUDec(&peakMag, mag[peak]);
+#endif
+#if SPECTRUM == 2
+        ST7735_WaterfallRow(mag, FFT_N/2);
+#endif
+    }
+}
+void ADC0Seq3Handler(void){
+    uint32_t value;
+    ADCIntClear(ADC0_BASE, 3);
+    ADCSequenceDataGet(ADC0_BASE, 3, &value);
+    SpecBuf[SpecFill][SpecCount] = value;
+    SpecCount++;
+    if(SpecCount == FFT_N)
+    {
+        SpecCount = 0;
+        SpecFull = SpecFill;
+        SpecFill ^= 1;
+    }
 }
 void DelayWait10ms(uint32_t n){
     uint32_t volatile time;
@@ -101,6 +101,25 @@ enum initRFlags{
 #define ST7735_TFTWIDTH  128
 #define ST7735_TFTHEIGHT 128
 
+// One ST7735 and the pins it is wired to.  Fill in the first four
+// fields, call ST7735_SelectPanel() and then ST7735_InitR(); the
+// rest is kept by the driver while another panel is selected.
+// SSI0 uses SCK PA2, CS PA3 and MOSI PA5; SSI2 uses SCK PB4, CS PB5
+// and MOSI PB7.  On the LaunchPad PB7 is tied to PD1 through R10,
+// so PD1 must stay an input (or R10 be removed) with a panel on SSI2.
+typedef struct{
+  uint8_t ssi;         // 0 for SSI0, 2 for SSI2
+  uint8_t port;        // GPIO port of DC and RESET, 0 for port A to 5 for port F
+  uint8_t dc;          // DC pin, as a bit mask (0x40 for PA6)
+  uint8_t reset;       // RESET pin, as a bit mask (0x80 for PA7)
+  uint8_t colStart, rowStart, rotation, tabColor, pixel12;
+  int16_t width, height;
+  uint16_t winCols, winRows;
+  uint32_t x, y;
+  uint16_t textColor, textBgColor;
+  uint16_t textBlank;  // console line still to be blanked, see ST7735_TextFlush()
+} Panel_t;
+
 
 // Color definitions
 #define ST7735_BLACK   0x0000
@@ -126,9 +145,31 @@ void ST7735_InitB(void);
 void ST7735_InitR(enum initRFlags option);
 
 
+//------------ST7735_SelectPanel------------
+// Make all following calls draw on the given panel.  Any transfer
+// still streaming to the current panel is finished first, so
+// transfers to two panels take turns.  The geometry, rotation,
+// address window, color mode, cursor and text colors of each panel
+// are kept in its Panel_t.  The scrolling console, strip chart and
+// waterfall belong to the panel they were started on, and sprites
+// to the panel they were drawn on; select it before using them.
+// Input: panel  pointer to the panel, its pins set; 0 for the panel
+//               wired as described at the top of this file
+// Output: none
+// Example: a second panel on SSI2, DC on PB0 and RESET on PB1
+//    Panel_t Right = {2, 1, 0x01, 0x02};
+//    ST7735_InitR(INITR_REDTAB);          // left panel, SSI0
+//    ST7735_SelectPanel(&Right);
+//    ST7735_InitR(INITR_REDTAB);          // right panel, SSI2
+//    ST7735_DrawString(0, 0, "Player 2", ST7735_YELLOW);
+//    ST7735_SelectPanel(0);               // back to the left panel
+void ST7735_SelectPanel(Panel_t *panel);
+
+
 //------------ST7735_DrawPixel------------
 // Color the pixel at the given coordinates with the given color.
-// Requires 13 bytes of transmission
+// Requires 13 bytes of transmission (8 if the column or row is the
+// same as the previous window, 3 if both are)
 // Input: x     horizontal position of the pixel, columns from the left edge
 //               must be less than 128
 //               0 is on the left, 126 is near the right
@@ -183,6 +224,151 @@ void ST7735_FillScreen(uint16_t color);
 void ST7735_FillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
 
 
+//------------ST7735_FillRectAsync------------
+// Start a uDMA fill of a rectangle and return right away.
+// The CPU is free while the pixels stream out over SSI0.
+// Requires (11 + 2*w*h) bytes of transmission (assuming image fully on screen)
+// Input: x     horizontal position of the top left corner of the rectangle, columns from the left edge
+//        y     vertical position of the top left corner of the rectangle, rows from the top edge
+//        w     horizontal width of the rectangle
+//        h     vertical height of the rectangle
+//        color 16-bit color, which can be produced by ST7735_Color565()
+//        done  function called from the SSI0 interrupt when finished, or 0
+// Output: none
+void ST7735_FillRectAsync(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color, void (*done)(void));
+
+
+//------------ST7735_DrawLine------------
+// Draw a line between two points with Bresenham's algorithm.  The
+// pixels of a mostly horizontal line are sent as one window per
+// row it crosses, and those of a mostly vertical line as one window
+// per column, instead of one window per pixel.  Parts off the
+// screen are not drawn.
+// Requires (3 to 11 bytes per run + 2 bytes per pixel) of transmission
+// Input: x0,y0 first end point, columns from the left edge and rows from the top edge
+//        x1,y1 second end point
+//        color 16-bit color, which can be produced by ST7735_Color565()
+// Output: none
+void ST7735_DrawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+
+
+//------------ST7735_DrawCircle------------
+// Draw the outline of a circle with the midpoint rule.  Each row
+// of the flat top and bottom octants is one horizontal run, and
+// each column of the steep side octants one vertical run, so every
+// pixel is sent once and a circle of radius r takes about 2.4*r
+// windows rather than one for each of its 5.7*r pixels.  Parts
+// off the screen are not drawn.
+// Requires (3 to 11 bytes per run + 2 bytes per pixel) of transmission
+// Input: x0,y0 center, columns from the left edge and rows from the top edge
+//        r     radius in pixels
+//        color 16-bit color, which can be produced by ST7735_Color565()
+// Output: none
+void ST7735_DrawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color);
+
+
+//------------ST7735_FillCircle------------
+// Fill a circle, using the same edge as ST7735_DrawCircle(), as one
+// horizontal span per row.
+// Requires (3 to 11 bytes per row + 2 bytes per pixel) of transmission
+// Input: x0,y0 center, columns from the left edge and rows from the top edge
+//        r     radius in pixels
+//        color 16-bit color, which can be produced by ST7735_Color565()
+// Output: none
+void ST7735_FillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color);
+
+
+//------------ST7735_FillPolygon------------
+// Fill a convex polygon as one horizontal span per row, from the
+// leftmost to the rightmost edge crossing that row.  Rows off the
+// screen are skipped without visiting the edges.
+// Requires (3 to 11 bytes per row + 2 bytes per pixel) of transmission
+// Input: xy    pointer to n corners as pairs x,y, in order around the polygon
+//        n     number of corners, at least 1
+//        color 16-bit color, which can be produced by ST7735_Color565()
+// Output: none
+void ST7735_FillPolygon(const int16_t *xy, uint32_t n, uint16_t color);
+
+
+//------------ST7735_FillTriangle------------
+// Fill a triangle, see ST7735_FillPolygon().
+// Requires (3 to 11 bytes per row + 2 bytes per pixel) of transmission
+// Input: x0,y0 first corner, columns from the left edge and rows from the top edge
+//        x1,y1 second corner
+//        x2,y2 third corner
+//        color 16-bit color, which can be produced by ST7735_Color565()
+// Output: none
+void ST7735_FillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                         int16_t x2, int16_t y2, uint16_t color);
+
+
+//------------ST7735_Damage------------
+// Mark a rectangle to be erased by the next ST7735_Flush(), e.g.
+// the previous position of a moving image.  Overlapping or
+// touching rectangles are merged, so each area is sent once.
+// Input: x     horizontal position of the top left corner of the rectangle, columns from the left edge
+//        y     vertical position of the top left corner of the rectangle, rows from the top edge
+//        w     horizontal width of the rectangle
+//        h     vertical height of the rectangle
+// Output: none
+void ST7735_Damage(int16_t x, int16_t y, int16_t w, int16_t h);
+
+
+//------------ST7735_Flush------------
+// Erase every rectangle marked by ST7735_Damage() and empty the list.
+// Requires (11 + 2*w*h) bytes of transmission per merged rectangle
+// Input: color 16-bit background color, which can be produced by ST7735_Color565()
+// Output: none
+void ST7735_Flush(uint16_t color);
+
+
+//------------ST7735_GetTxCount------------
+// Number of bytes sent to the LCD (commands, arguments and pixels)
+// since the last call to ST7735_ClearTxCount().
+// Input: none
+// Output: byte count
+uint32_t ST7735_GetTxCount(void);
+
+
+//------------ST7735_ClearTxCount------------
+// Reset the counts returned by ST7735_GetTxCount(),
+// ST7735_GetSavedCount() and ST7735_GetWindowCount().
+// Input: none
+// Output: none
+void ST7735_ClearTxCount(void);
+
+
+//------------ST7735_GetSavedCount------------
+// Number of CASET/RASET bytes that did not have to be sent because
+// the address window range was already set, since the last call
+// to ST7735_ClearTxCount().
+// Input: none
+// Output: byte count
+uint32_t ST7735_GetSavedCount(void);
+
+
+//------------ST7735_GetWindowCount------------
+// Number of address windows set up (each one a RAMWR command and
+// up to 11 bytes) since the last call to ST7735_ClearTxCount().
+// Input: none
+// Output: window count
+uint32_t ST7735_GetWindowCount(void);
+
+
+//------------ST7735_SetColorMode------------
+// Select the number of bits per pixel sent to the panel.  In 12-bit
+// mode two pixels are packed into 3 bytes instead of 4, so fills,
+// bitmaps and text move 25% fewer bytes, at the cost of the lowest
+// bit of red and blue and the two lowest of green.  All functions
+// still take RGB565 colors (e.g. from ST7735_Color565()) and convert
+// them as they are sent.  ST7735_InitB()/ST7735_InitR() select
+// 16-bit mode.
+// Requires 2 bytes of transmission
+// Input: bits  12 or 16
+// Output: none
+void ST7735_SetColorMode(uint8_t bits);
+
+
 //------------ST7735_Color565------------
 // Pass 8-bit (each) R,G,B and get back 16-bit packed color.
 // Input: r red value
@@ -217,17 +403,270 @@ uint16_t ST7735_SwapColor(uint16_t x) ;
 //        w     number of pixels wide
 //        h     number of pixels tall
 // Output: none
-// Must be less than or equal to 128 pixels wide by 160 pixels high
+// Parts of the image off any edge of the screen are not drawn
 void ST7735_DrawBitmap(int16_t x, int16_t y, const uint16_t *image, int16_t w, int16_t h);
 
+//------------ST7735_DrawBitmapAsync------------
+// Start a uDMA transfer of a 16-bit color BMP image and return right
+// away.  The image format and clipping are the same as
+// ST7735_DrawBitmap().  The image must not change until the transfer
+// is done; an image in flash is copied through a RAM line buffer.
+// Requires (11 + 2*w*h) bytes of transmission (assuming image fully on screen)
+// Input: x     horizontal position of the bottom left corner of the image, columns from the left edge
+//        y     vertical position of the bottom left corner of the image, rows from the top edge
+//        image pointer to a 16-bit color BMP image
+//        w     number of pixels wide
+//        h     number of pixels tall
+//        done  function called from the SSI0 interrupt when finished, or 0
+// Output: none
+void ST7735_DrawBitmapAsync(int16_t x, int16_t y, const uint16_t *image, int16_t w, int16_t h, void (*done)(void));
+
+//------------ST7735_DrawBitmapIndexed------------
+// Displays a palette-indexed BMP image.  Each pixel is a 4-bit or
+// 8-bit index into a table of 16-bit colors, which is looked up
+// while the rows are copied to the uDMA line buffers, so the image
+// takes a quarter or half the flash of ST7735_DrawBitmap() and can
+// be recolored by passing another palette.  Rows are stored bottom
+// up like ST7735_DrawBitmap(); each row starts on a byte, and in a
+// 4-bit image the left pixel of each byte is the high nibble.
+// Clipping is the same as ST7735_DrawBitmap().
+// Requires (11 + 2*w*h) bytes of transmission (assuming image fully on screen)
+// Input: x       horizontal position of the bottom left corner of the image, columns from the left edge
+//        y       vertical position of the bottom left corner of the image, rows from the top edge
+//        image   pointer to the indexes
+//        bpp     4 or 8 bits per index
+//        palette pointer to 16 or 256 16-bit colors
+//        w       number of pixels wide
+//        h       number of pixels tall
+// Output: none
+void ST7735_DrawBitmapIndexed(int16_t x, int16_t y, const uint8_t *image, uint8_t bpp,
+                              const uint16_t *palette, int16_t w, int16_t h);
+
+// image that ST7735_DrawAtlas() cuts rectangles from
+typedef struct{
+  const void *image;      // 16-bit colors, or 4-bit or 8-bit palette indexes
+  uint8_t bpp;            // 16, 8 or 4 bits per pixel
+  uint8_t topDown;        // 1 if the top row is stored first, 0 for bottom up like a BMP
+  int16_t w, h;           // size of the whole image in pixels
+} Atlas_t;
+
+//------------ST7735_DrawAtlas------------
+// Draw a rectangle cut from a larger image (a texture atlas), so
+// the digits, paddles and balls of a game can all be kept in one
+// array.  The atlas may store its rows bottom up, like
+// ST7735_DrawBitmap(), or top down, and may be 16-bit colors or
+// 4-bit or 8-bit palette indexes, like ST7735_DrawBitmapIndexed().
+// The source rectangle is clipped to the atlas and the result to
+// the screen on all four sides, then sent through one window.
+// Requires (11 + 2*w*h) bytes of transmission (assuming image fully on screen)
+// Input: x       horizontal position of the top left corner on the screen, columns from the left edge
+//        y       vertical position of the top left corner on the screen, rows from the top edge
+//        atlas   pointer to the atlas description
+//        palette pointer to 16 or 256 16-bit colors, not used for a 16-bit atlas
+//        sx      left column of the source rectangle in the atlas
+//        sy      top row of the source rectangle in the atlas, counted from the top
+//        w       number of pixels wide
+//        h       number of pixels tall
+// Output: none
+void ST7735_DrawAtlas(int16_t x, int16_t y, const Atlas_t *atlas, const uint16_t *palette,
+                      int16_t sx, int16_t sy, int16_t w, int16_t h);
+
+//------------ST7735_DrawBitmapRLE------------
+// Display a run-length encoded 16-bit color image.  The image is a
+// list of 16-bit words made of two kinds of records:
+//   n, color                 n pixels (1 to 32767) of one color
+//   0x8000+n, c1, c2 ... cn  n pixels (1 to 32767) given one by one
+// Unlike ST7735_DrawBitmap() the rows are stored top row first, so
+// the pixels stream straight into one address window; runs are
+// sent without reading a color from flash per pixel.  Runs and
+// literals may continue from one row into the next.  tools/rleconv.c
+// converts an ordinary bitmap array.  Clipping is the same as
+// ST7735_DrawBitmap().
+// Requires (11 + 2*w*h) bytes of transmission (assuming image fully on screen)
+// Input: x     horizontal position of the bottom left corner of the image, columns from the left edge
+//        y     vertical position of the bottom left corner of the image, rows from the top edge
+//        rle   pointer to the encoded image
+//        w     number of pixels wide
+//        h     number of pixels tall
+// Output: none
+void ST7735_DrawBitmapRLE(int16_t x, int16_t y, const uint16_t *rle, int16_t w, int16_t h);
+
+//------------ST7735_Busy------------
+// Check for a uDMA pixel transfer in progress.
+// Input: none
+// Output: 1 if a transfer is still streaming, 0 if idle
+int ST7735_Busy(void);
+
+//------------ST7735_WaitIdle------------
+// Wait for any uDMA pixel transfer to finish and put SSI0 back
+// into 8-bit frames for commands.  Every other driver call does
+// this first, so it is only needed before touching the image
+// passed to ST7735_DrawBitmapAsync().
+// Input: none
+// Output: none
+void ST7735_WaitIdle(void);
+
+//------------SSI0Handler------------
+// Interrupt service routine for SSI0, raised by the uDMA each
+// time a piece of a pixel transfer completes.
+// Must be placed in the vector table as the SSI0 handler, or
+// installed with IntRegister(INT_SSI0, SSI0Handler) before
+// ST7735_InitR(); without it the first transfer never finishes.
+void SSI0Handler(void);
+
+//------------SSI2Handler------------
+// Interrupt service routine for SSI2, the same as SSI0Handler() for
+// a panel on SSI2 (see Panel_t).
+// Must be placed in the vector table as the SSI2 handler, or
+// installed with IntRegister(INT_SSI2, SSI2Handler) before that
+// panel's ST7735_InitR().
+void SSI2Handler(void);
+
+// sprite table entry, see ST7735_SpriteUpdate()
+typedef struct{
+  Atlas_t sheet;          // image the sprite is cut from, a whole BMP unless set by ST7735_SpriteInitAtlas()
+  int16_t sx, sy;         // top left corner of the sprite in the sheet
+  const uint16_t *palette;  // colors for an indexed image
+  int16_t w, h;           // size in pixels
+  int32_t key;            // color (or index) drawn as background (transparent), or -1 for none
+  int16_t x, y;           // bottom left corner for the next update
+  int16_t lastX, lastY;   // bottom left corner where it was last drawn
+  uint8_t visible;        // 1 to show at (x,y)
+  uint8_t drawn;          // 1 if on the screen at (lastX,lastY)
+  uint8_t dirty;          // used during ST7735_SpriteUpdate()
+} Sprite_t;
+
+//------------ST7735_SpriteBackground------------
+// Set the plain background color that sprites are drawn over.
+// The LCD cannot be read back, so this color is what is restored
+// where a sprite used to be.  Default is white.
+// Input: color 16-bit color, which can be produced by ST7735_Color565()
+// Output: none
+void ST7735_SpriteBackground(uint16_t color);
+
+//------------ST7735_SpriteInit------------
+// Set up a sprite entry.  It is not shown until the first
+// ST7735_SpriteUpdate() after ST7735_SpriteMove().
+// Input: sp    pointer to the sprite entry
+//        image pointer to a 16-bit color BMP image, same format as ST7735_DrawBitmap()
+//        w     number of pixels wide
+//        h     number of pixels tall
+//        key   color drawn as background (transparent), or -1 for none
+// Output: none
+void ST7735_SpriteInit(Sprite_t *sp, const uint16_t *image, int16_t w, int16_t h, int32_t key);
+
+//------------ST7735_SpriteInitIndexed------------
+// Set up a sprite entry with a palette-indexed image.  It is not
+// shown until the first ST7735_SpriteUpdate() after ST7735_SpriteMove().
+// Input: sp      pointer to the sprite entry
+//        image   pointer to the indexes, same format as ST7735_DrawBitmapIndexed()
+//        bpp     4 or 8 bits per index
+//        palette pointer to 16 or 256 16-bit colors
+//        w       number of pixels wide
+//        h       number of pixels tall
+//        key     index drawn as background (transparent), or -1 for none
+// Output: none
+void ST7735_SpriteInitIndexed(Sprite_t *sp, const uint8_t *image, uint8_t bpp,
+                              const uint16_t *palette, int16_t w, int16_t h, int32_t key);
+
+//------------ST7735_SpritePalette------------
+// Change the palette of an indexed sprite, for color cycling or a
+// flash.  The sprite is redrawn at the next ST7735_SpriteUpdate()
+// even if it did not move; the image itself is not copied.
+// Input: sp      pointer to the sprite entry
+//        palette pointer to 16 or 256 16-bit colors
+// Output: none
+void ST7735_SpritePalette(Sprite_t *sp, const uint16_t *palette);
+
+//------------ST7735_SpriteInitAtlas------------
+// Set up a sprite entry whose image is a rectangle of an atlas,
+// see ST7735_DrawAtlas().  It is not shown until the first
+// ST7735_SpriteUpdate() after ST7735_SpriteMove().
+// Input: sp      pointer to the sprite entry
+//        atlas   pointer to the atlas description, which is copied
+//        palette pointer to 16 or 256 16-bit colors, not used for a 16-bit atlas
+//        sx      left column of the sprite in the atlas
+//        sy      top row of the sprite in the atlas, counted from the top
+//        w       number of pixels wide
+//        h       number of pixels tall
+//        key     color (index for an indexed atlas) drawn as background, or -1 for none
+// Output: none
+void ST7735_SpriteInitAtlas(Sprite_t *sp, const Atlas_t *atlas, const uint16_t *palette,
+                            int16_t sx, int16_t sy, int16_t w, int16_t h, int32_t key);
+
+//------------ST7735_SpriteMove------------
+// Set the position a sprite will be drawn at by the next
+// ST7735_SpriteUpdate().  Does not output to the display.
+// Input: sp    pointer to the sprite entry
+//        x     horizontal position of the bottom left corner, columns from the left edge
+//        y     vertical position of the bottom left corner, rows from the top edge
+// Output: none
+void ST7735_SpriteMove(Sprite_t *sp, int16_t x, int16_t y);
+
+//------------ST7735_SpriteHide------------
+// Remove a sprite at the next ST7735_SpriteUpdate().
+// Input: sp    pointer to the sprite entry
+// Output: none
+void ST7735_SpriteHide(Sprite_t *sp);
+
+//------------ST7735_SpriteUpdate------------
+// Bring the display up to date with a table of sprites.  For each
+// sprite that moved, only the strips of its old rectangle that the
+// new one does not cover are filled with the background color, then
+// the new image is drawn.  Sprites uncovered by a restore are redrawn.
+// Sprites that were not moved or recolored cost nothing.
+// Requires (11 + 2*w*h) bytes for each sprite drawn, plus the strips
+// Input: table pointer to an array of sprite entries
+//        n     number of entries
+// Output: none
+void ST7735_SpriteUpdate(Sprite_t *table, uint32_t n);
+
+// layer types for ST7735_Compose()
+enum layerType{
+  LAYER_RECT,      // filled rectangle, (x,y) is the top left corner
+  LAYER_BITMAP,    // 16-bit BMP image, (x,y) is the bottom left corner
+  LAYER_TEXT       // string in the 5x7 font, (x,y) is the top left corner
+};
+
+// scene layer, see ST7735_Compose()
+typedef struct{
+  enum layerType type;
+  int16_t x, y;           // position, see enum layerType
+  int16_t w, h;           // size in pixels (not used for text)
+  uint16_t color;         // rectangle or text color
+  int32_t key;            // bitmap: transparent color; text: background color; -1 for none
+  const uint16_t *image;  // bitmap, same format as ST7735_DrawBitmap()
+  const char *text;       // null terminated string
+  uint8_t size;           // text: pixels per font pixel
+} Layer_t;
+
+//------------ST7735_Compose------------
+// Draw a region of the screen from a list of layers in one pass.
+// Rows are composed in RAM a few at a time and streamed by the uDMA
+// while the next rows are composed, so each pixel is sent once
+// through a single address window with no overdraw.
+// Returns while the last rows may still be streaming; any other
+// driver call waits for them.
+// Requires (11 + 2*w*h) bytes of transmission
+// Input: layers  array of layers, painted first to last (last on top)
+//        n       number of layers
+//        bgColor color of pixels not covered by any layer
+//        x       horizontal position of the top left corner of the region
+//        y       vertical position of the top left corner of the region
+//        w       width of the region
+//        h       height of the region
+// Output: none
+void ST7735_Compose(const Layer_t *layers, uint32_t n, uint16_t bgColor, int16_t x, int16_t y, int16_t w, int16_t h);
+
 //------------ST7735_DrawCharS------------
 // Simple character draw function.  This is the same function from
-// Adafruit_GFX.c but adapted for this processor.  However, each call
-// to ST7735_DrawPixel() calls setAddrWindow(), which needs to send
-// many extra data and commands.  If the background color is the same
-// as the text color, no background will be printed, and text can be
-// drawn right over existing images without covering them with a box.
-// Requires (11 + 2*size*size)*6*8 (image fully on screen; textcolor != bgColor)
+// Adafruit_GFX.c but adapted for this processor.  The character is
+// clipped to the screen and sent through one address window.  If the
+// background color is the same as the text color, no background will
+// be printed, and text can be drawn right over existing images without
+// covering them with a box; then each run of lit pixels in a font row
+// is sent as its own small window.
+// Requires (11 + 2*size*size*6*8) bytes of transmission (image fully on screen; textcolor != bgColor)
 // Input: x         horizontal position of the top left corner of the character, columns from the left edge
 //        y         vertical position of the top left corner of the character, rows from the top edge
 //        c         character to be printed
@@ -241,8 +680,9 @@ void ST7735_DrawCharS(int16_t x, int16_t y, char c, int16_t textColor, int16_t b
 // Advanced character draw function.  This is similar to the function
 // from Adafruit_GFX.c but adapted for this processor.  However, this
 // function only uses one call to setAddrWindow(), which allows it to
-// run at least twice as fast.
-// Requires (11 + size*size*6*8) bytes of transmission (assuming image fully on screen)
+// run at least twice as fast.  The character is not drawn at all
+// unless it fits entirely on the screen.
+// Requires (11 + 2*size*size*6*8) bytes of transmission (assuming image fully on screen)
 // Input: x         horizontal position of the top left corner of the character, columns from the left edge
 //        y         vertical position of the top left corner of the character, rows from the top edge
 //        c         character to be printed
@@ -255,7 +695,8 @@ void ST7735_DrawChar(int16_t x, int16_t y, char c, int16_t textColor, int16_t bg
 //------------ST7735_DrawString------------
 // String draw function.
 // 16 rows (0 to 15) and 21 characters (0 to 20)
-// Requires (11 + size*size*6*8) bytes of transmission for each character
+// The visible characters are sent through one address window.
+// Requires (11 + 2*6*8*n) bytes of transmission for n characters
 // Input: x         columns from the left edge (0 to 20)
 //        y         rows from the top edge (0 to 15)
 //        pt        pointer to a null terminated string to be printed
@@ -266,6 +707,23 @@ uint32_t ST7735_DrawString(uint16_t x, uint16_t y, char *pt, int16_t textColor);
 
 
 
+//------------ST7735_SetScrollConsole------------
+// Select how ST7735_OutChar() handles a newline.  With scrolling
+// off, the cursor wraps to the top line and the next line is
+// repainted with spaces.  With scrolling on, the text lines that fit
+// on the screen become a hardware scroll area: after the last line
+// the screen scrolls up one line by changing the scroll start address,
+// and only the characters already written on the reused line are
+// erased.  The screen is cleared
+// and the cursor moved to the top left either way.
+// Only rotations 0 and 2 scroll along the rows of the panel; in
+// rotations 1 and 3 the request is ignored and scrolling stays off.
+// ST7735_SetRotation() turns scrolling off.
+// Requires 11 bytes of transmission plus a screen fill
+// Input: enable  1 to scroll, 0 for the wrap-around console
+// Output: 1 if scrolling is on, 0 if not
+int ST7735_SetScrollConsole(uint8_t enable);
+
 //********ST7735_SetCursor*****************
 // Move the cursor to the desired X- and Y-position.  The
 // next character will be printed here.  X=0 is the leftmost
@@ -279,11 +737,57 @@ void ST7735_SetCursor(uint32_t newX, uint32_t newY);
 // Output a 32-bit number in unsigned decimal format
 // Position determined by ST7735_SetCursor command
 // Color set by ST7735_SetTextColor
+// Digits the screen already shows are not sent again.
 // Input: 32-bit number to be transferred
 // Output: none
 // Variable format 1-10 digits with no space before or after
 void ST7735_OutUDec(uint32_t n);
 
+// number field of a heads-up display, see ST7735_HudUDec()
+typedef struct{
+  int16_t x, y;           // top left corner
+  uint8_t width;          // character cells, numbers are right aligned
+  uint8_t size;           // pixels per font pixel
+  uint16_t color, bgColor;
+  char shown[12];         // characters on the screen, 0 if not drawn
+} HudNumber_t;
+
+//------------ST7735_HudInit------------
+// Set up a number field for a heads-up display (score, frame rate,
+// latency).  Nothing is drawn until the first ST7735_HudUDec() or
+// ST7735_HudFix(); call this again after the screen is cleared.
+// Input: h       pointer to the field
+//        x       horizontal position of the top left corner, columns from the left edge
+//        y       vertical position of the top left corner, rows from the top edge
+//        width   character cells, 1 to 12; numbers are right aligned
+//        size    pixels per font pixel
+//        color   16-bit text color
+//        bgColor 16-bit background color, different from color
+// Output: none
+void ST7735_HudInit(HudNumber_t *h, int16_t x, int16_t y, uint8_t width, uint8_t size,
+                    uint16_t color, uint16_t bgColor);
+
+//------------ST7735_HudUDec------------
+// Show an unsigned number in a heads-up display field.  Only the
+// digits that changed are drawn, so a counter that goes up by one
+// usually costs a single character.
+// Requires (11 + 96*size*size*n) bytes for each run of n changed characters
+// Input: h  pointer to the field, see ST7735_HudInit()
+//        n  number to show
+// Output: none
+void ST7735_HudUDec(HudNumber_t *h, uint32_t n);
+
+//------------ST7735_HudFix------------
+// Show a signed fixed-point number n/10^decimals in a heads-up
+// display field, e.g. 1234 with 2 decimals is 12.34.  Only the
+// characters that changed are drawn.
+// Requires (11 + 96*size*size*n) bytes for each run of n changed characters
+// Input: h         pointer to the field, see ST7735_HudInit()
+//        n         number to show times 10^decimals
+//        decimals  digits after the point, 0 to 9
+// Output: none
+void ST7735_HudFix(HudNumber_t *h, int32_t n, uint8_t decimals);
+
 
 //------------ST7735_SetRotation------------
 // Change the image rotation.
@@ -408,10 +912,126 @@ void ST7735_PlotNextErase(void);
 //        ST7735_PlotNext();
 //    }   // called 128 times
 
+//------------ST7735_StripInit------------
+// Start a scrolling strip chart that covers the whole screen.  The
+// panel can only scroll along its frame memory rows, which run left
+// to right in the landscape rotations, so rotation 1 is selected
+// unless the display is already in rotation 1 or 3.  Samples are
+// added with ST7735_StripSample(); ST7735_SetRotation() or
+// ST7735_SetScrollConsole() end the chart.
+// Requires 13 bytes of transmission plus a screen fill
+// Input: ymin    sample value shown at the bottom edge
+//        ymax    sample value shown at the top edge
+//        color   16-bit color of the trace
+//        bgColor 16-bit color of the background
+// Output: none
+void ST7735_StripInit(int32_t ymin, int32_t ymax, uint16_t color, uint16_t bgColor);
+
+//------------ST7735_StripSample------------
+// Add one sample to the right edge of the strip chart and scroll
+// the older samples one column to the left.  The trace is a vertical
+// span from the previous sample to this one, so fast changes stay
+// connected.  Returns while the column may still be streaming;
+// composing the next column overlaps with it.  The column is
+// scrolled into view by the next call, once it is written, so the
+// chart shows every sample but the newest.
+// Requires (14 + 2*h) bytes of transmission, h the screen height
+// Input: y  sample value, clipped to the range given to ST7735_StripInit()
+// Output: none
+void ST7735_StripSample(int32_t y);
+
+//------------ST7735_TraceInit------------
+// Start a scrolling chart of up to four channels that may be
+// sampled much faster than the screen can scroll.  Every
+// samplesPerColumn samples become one column showing, for each
+// channel, a vertical span from its lowest to its highest value in
+// that time, joined to the span of the column before, so spikes
+// between columns still show.  The screen is set up as for
+// ST7735_StripInit().
+// Requires 13 bytes of transmission plus a screen fill
+// Input: channels         number of traces, 1 to 4
+//        ymin             sample value shown at the bottom edge
+//        ymax             sample value shown at the top edge
+//        samplesPerColumn samples of each channel per column, at least 1
+//        colors           pointer to a 16-bit color for each trace; later traces are drawn over earlier ones
+//        bgColor          16-bit color of the background
+// Output: none
+void ST7735_TraceInit(uint8_t channels, int32_t ymin, int32_t ymax, uint32_t samplesPerColumn,
+                      const uint16_t *colors, uint16_t bgColor);
+
+//------------ST7735_TraceSample------------
+// Add one sample of every channel to the trace chart.  Nothing is
+// drawn, so it may be called from the interrupt that reads the ADC.
+// Up to 16 finished columns wait for ST7735_TraceUpdate(); if the
+// main loop falls further behind, the newest column keeps collecting
+// samples, so no sample is ever dropped.
+// Input: y  pointer to one value for each channel
+// Output: none
+void ST7735_TraceSample(const int32_t *y);
+
+//------------ST7735_TraceUpdate------------
+// Draw the columns of the trace chart finished since the last call.
+// Each column, with all of its traces, is sent as one window.  Like
+// the strip chart, each column is scrolled into view by the next
+// one, once it is written.  Call from the main loop.
+// Requires (14 + 2*h) bytes of transmission per column, h the screen height
+// Input: none
+// Output: number of columns drawn
+uint32_t ST7735_TraceUpdate(void);
+
+//------------ST7735_WaterfallInit------------
+// Start a waterfall display that covers the whole screen.  Rows
+// scroll down, so the portrait rotation 0 is selected unless the
+// display is already in rotation 0 or 2.  Rows are added with
+// ST7735_WaterfallRow(); ST7735_SetRotation() or
+// ST7735_SetScrollConsole() end the waterfall.
+// Requires 13 bytes of transmission plus a screen fill
+// Input: none
+// Output: none
+void ST7735_WaterfallInit(void);
+
+//------------ST7735_WaterfallRow------------
+// Add one spectrum as a new row at the top of the waterfall and
+// move the older rows down one.  Each magnitude is one pixel,
+// colored on the same dB scale as ST7735_PlotdBfs(); pixels past
+// the last magnitude are black.  Returns while the row may still be
+// streaming.  Like the strip chart, the row is scrolled into view
+// by the next call, once it is written.
+// Requires (14 + 2*w) bytes of transmission, w the screen width
+// Input: mag  magnitudes, 0 to 1023 is the range of ST7735_PlotdBfs()
+//        n    number of magnitudes
+// Output: none
+void ST7735_WaterfallRow(const uint16_t *mag, uint32_t n);
+
+// Example 5 Scrolling strip chart of an ADC channel, about 1 kHz
+//    ST7735_StripInit(0, 4095, ST7735_YELLOW, ST7735_BLACK);
+//    while(1){
+//      ST7735_StripSample(ADC_In());  // 270 bytes, about 300 us at 8 MHz
+//      wait for the next 1 ms sample time
+//    }
+
+// Example 6 Waterfall of 256-point FFTs
+//    ST7735_WaterfallInit();
+//    while(1){
+//      perform FFT to get 128 magnitudes, mag[i] (0 to 1023)
+//      ST7735_WaterfallRow(mag, 128);  // 270 bytes per spectrum
+//    }
+
+// Example 7 Two ADC channels at 10 kHz, 40 samples per column
+//    const uint16_t colors[2] = {ST7735_YELLOW, ST7735_CYAN};
+//    ST7735_TraceInit(2, 0, 4095, 40, colors, ST7735_BLACK);
+//    ADC interrupt at 10 kHz:
+//      int32_t y[2] = {ADC_CH7, ADC_CH6};
+//      ST7735_TraceSample(y);
+//    while(1){
+//      ST7735_TraceUpdate();          // 250 columns per second
+//    }
+
 // *************** ST7735_OutChar ********************
 // Output one character to the LCD
 // Position determined by ST7735_SetCursor command
-// Color set by ST7735_SetTextColor
+// Color set by ST7735_SetTextColor and ST7735_SetTextBgColor
+// Nothing is sent if the cell already shows this character.
 // Inputs: 8-bit ASCII character
 // Outputs: none
 void ST7735_OutChar(char ch);
@@ -419,20 +1039,53 @@ void ST7735_OutChar(char ch);
 //********ST7735_OutString*****************
 // Print a string of characters to the ST7735 LCD.
 // Position determined by ST7735_SetCursor command
-// Color set by ST7735_SetTextColor
+// Color set by ST7735_SetTextColor and ST7735_SetTextBgColor
 // The string will not automatically wrap.
+// Only characters that differ from what the screen already shows
+// are sent, each run of them through one address window.
 // inputs: ptr  pointer to NULL-terminated ASCII string
 // outputs: none
 void ST7735_OutString(char *ptr);
 
+//********ST7735_TextFlush*****************
+// Draw the console cells that changed since the last flush, one
+// address window for each run of changed cells with the same
+// colors.  ST7735_OutChar() and ST7735_OutString() flush when they
+// are done; printf() output is flushed at the end of each line, so
+// call this to show a partial line.  A line begun by a newline is
+// blanked past its new text at the first flush after something is
+// written to it, or after the cursor leaves it, so reprinting the
+// same lines sends nothing.
+// Requires (11 + 96*n) bytes of transmission for each run of n cells
+// inputs: none
+// outputs: none
+void ST7735_TextFlush(void);
+
+//********ST7735_TextInvalidate*****************
+// Mark every console cell to be redrawn by the next
+// ST7735_TextFlush().  Needed only after drawing over console text
+// with other functions, since the LCD cannot be read back;
+// ST7735_FillScreen() already keeps track.
+// inputs: none
+// outputs: none
+void ST7735_TextInvalidate(void);
+
 // ************** ST7735_SetTextColor ************************
 // Sets the color in which the characters will be printed
-// Background color is fixed at black
+// Background color is set by ST7735_SetTextBgColor
 // Input:  16-bit packed color
 // Output: none
 // ********************************************************
 void ST7735_SetTextColor(uint16_t color);
 
+// ************** ST7735_SetTextBgColor ************************
+// Sets the background color of the characters printed
+// Default is black
+// Input:  16-bit packed color
+// Output: none
+// ********************************************************
+void ST7735_SetTextBgColor(uint16_t color);
+
 // *************** Output_Init ********************
 // Standard device driver initialization function for printf
 // Initialize ST7735 LCD
@@ -31,6 +31,9 @@
 #define START_WALL_TOP_Y_COOR 14
 #define START_WALL_BOTTOM_Y_COOR 122
 #define START_WALL_X_COOR 118
+#define REMOTE_PADDLE_X_COOR 121 // other player's paddle, on the right wall
+#define SPRITE_PADDLE 0
+#define SPRITE_COUNT 1
 
 
 // Functions used
@@ -40,6 +43,7 @@ void initialiaseSys();
 void initialisePortsAndGpios();
 void initialiseADC();
 uint32_t getYCoordinate(uint32_t adcValue, uint32_t in_min, uint32_t in_max);
+void initializeSprites();
 
 // Ball of size 5x5
 // Outer single-pixel wide border of ball is white
@@ -68,6 +72,10 @@ const uint16_t brick[]= {0X0000, 0X0000, 0X0000, 0X0000, 0X0000};
 // changing dy from +ve and -ve, makes this a 34 total pairs of dx-dy
 const uint16_t slope[]= {3, 1, 2, 1, 1, 1, 1, 2, 1, 3, 2, 3, 3, 2};
 
+// The other player's paddle is drawn by the ST7735 sprite engine,
+// which only repaints what moved (this board has no ball to draw)
+Sprite_t sprites[SPRITE_COUNT];
+
 
 //*****************************************************************************
 //
@@ -98,7 +106,7 @@ __error__(char *pcFilename, uint32_t ui32Line)
  *
  */
 void ConfigureUART(void);
-uint32_t  yCoor;
+volatile uint32_t yCoor;        // written by UART5Handler()
 int main(void)
 {
 
@@ -106,13 +114,19 @@ int main(void)
     // Initialize the system - ports, set clock, UART, gpio, etc
     initialiaseSys();
     UARTprintf("initialiaseSys()\n");
+    initializeSprites();
 
 
-    uint8_t updateFrame = 1;
     while(1)
     {
 //        getMappedADCValue(&ui32ADC0Value);
 //        UARTprintf("coor:%d\n", yCoor);
+        if(yCoor != 0)
+        {
+            // paddle position received from the other board over UART5
+            ST7735_SpriteMove(&sprites[SPRITE_PADDLE], REMOTE_PADDLE_X_COOR, yCoor);
+            ST7735_SpriteUpdate(sprites, SPRITE_COUNT);
+        }
 
 
         SysCtlDelay(30000);
@@ -212,6 +226,18 @@ void initialiseADC()
 
 }
 
+/*
+ * Sets up the paddle sprite over the white background
+ *
+ * Input Parameter: Nothing/void
+ * Output/Return Parameter: Nothing/void
+ */
+void initializeSprites()
+{
+    ST7735_SpriteBackground(0xFFFF);
+    ST7735_SpriteInit(&sprites[SPRITE_PADDLE], paddle_2, 2, 16, -1);
+}
+
 uint32_t getYCoordinate(uint32_t adcValue, uint32_t in_min, uint32_t in_max)
 {
     adcValue = adcValue > in_max ? in_max : adcValue;
@@ -0,0 +1,127 @@
+//*****************************************************************************
+/*
+ * Ball kinematics for Pong in Q8.8 fixed point, see Ball.h
+ */
+//*****************************************************************************
+
+#include <stdint.h>
+#include "Ball.h"
+
+// Quarter sine wave, sin(90 degrees * i/64) times 16384 for i = 0 to 64,
+// worked out by the compiler from the odd Taylor series up to x^9 in
+// 16-bit fixed point (error under 1/16384 over the quarter wave).
+// SIN_T is x as a fraction of a quarter turn, 1.0 = 65536.
+#define SIN_T(i) ((int64_t)(i)*1024)
+#define SIN_T2(i) ((SIN_T(i)*SIN_T(i))>>16)
+#define SIN_A1 102944 // pi/2 times 65536
+#define SIN_A3 (-42334) // -(pi/2)^3/3! times 65536
+#define SIN_A5 5223 // (pi/2)^5/5! times 65536
+#define SIN_A7 (-307) // -(pi/2)^7/7! times 65536
+#define SIN_A9 11 // (pi/2)^9/9! times 65536
+#define SIN_P9(i) (SIN_A7 + ((SIN_T2(i)*SIN_A9)>>16))
+#define SIN_P7(i) (SIN_A5 + ((SIN_T2(i)*SIN_P9(i))>>16))
+#define SIN_P5(i) (SIN_A3 + ((SIN_T2(i)*SIN_P7(i))>>16))
+#define SIN_P3(i) (SIN_A1 + ((SIN_T2(i)*SIN_P5(i))>>16))
+#define SIN_Q14(i) ((int16_t)((((SIN_T(i)*SIN_P3(i))>>16) + 2)>>2))
+#define SIN_4(i) SIN_Q14(i), SIN_Q14(i+1), SIN_Q14(i+2), SIN_Q14(i+3)
+#define SIN_16(i) SIN_4(i), SIN_4(i+4), SIN_4(i+8), SIN_4(i+12)
+
+static const int16_t sinQuarter[65] = {
+    SIN_16(0), SIN_16(16), SIN_16(32), SIN_16(48), SIN_Q14(64)
+};
+
+int32_t Ball_Sin(uint8_t angle)
+{
+    uint8_t i = angle & 63;
+    switch(angle >> 6)
+    {
+    case 0:
+        return sinQuarter[i];
+    case 1:
+        return sinQuarter[64 - i];
+    case 2:
+        return -sinQuarter[i];
+    default:
+        return -sinQuarter[64 - i];
+    }
+}
+
+int32_t Ball_Cos(uint8_t angle)
+{
+    return Ball_Sin((uint8_t)(angle + 64));
+}
+
+/*
+ * a*b/16384 rounded half away from zero, the same for +b and -b so
+ * a bounce reverses a velocity exactly
+ */
+static int32_t mulQ14(int32_t a, int32_t b)
+{
+    int32_t p = a * b;
+    return p < 0 ? -((-p + 8192) >> 14) : (p + 8192) >> 14;
+}
+
+/*
+ * Velocity from the speed and angle
+ */
+static void setVelocity(Ball_t *ball)
+{
+    ball->vx = mulQ14(ball->speed, Ball_Cos(ball->angle));
+    ball->vy = mulQ14(ball->speed, Ball_Sin(ball->angle));
+}
+
+void Ball_Launch(Ball_t *ball, int x, int y, uint8_t angle, int32_t speed)
+{
+    ball->x = x * BALL_ONE;
+    ball->y = y * BALL_ONE;
+    ball->angle = angle;
+    ball->speed = speed;
+    setVelocity(ball);
+}
+
+void Ball_SetSpeed(Ball_t *ball, int32_t speed)
+{
+    ball->speed = speed;
+    setVelocity(ball);
+}
+
+void Ball_Accelerate(Ball_t *ball, int32_t step, int32_t max)
+{
+    Ball_SetSpeed(ball, ball->speed + step > max ? max : ball->speed + step);
+}
+
+void Ball_Step(Ball_t *ball)
+{
+    ball->x += ball->vx;
+    ball->y += ball->vy;
+}
+
+void Ball_BounceX(Ball_t *ball)
+{
+    ball->angle = (uint8_t)(BALL_ANGLE_LEFT - ball->angle); // cos changes sign, sin does not
+    ball->vx = -ball->vx;
+}
+
+void Ball_BounceY(Ball_t *ball)
+{
+    ball->angle = (uint8_t)(-ball->angle); // sin changes sign, cos does not
+    ball->vy = -ball->vy;
+}
+
+/*
+ * Q8.8 to the nearest whole pixel, halves away from zero
+ */
+static int roundQ8(int32_t v)
+{
+    return v < 0 ? -((-v + BALL_ONE/2) >> 8) : (v + BALL_ONE/2) >> 8;
+}
+
+int Ball_PixelX(const Ball_t *ball)
+{
+    return roundQ8(ball->x);
+}
+
+int Ball_PixelY(const Ball_t *ball)
+{
+    return roundQ8(ball->y);
+}
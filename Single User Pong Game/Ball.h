@@ -0,0 +1,70 @@
+//*****************************************************************************
+/*
+ * Ball kinematics for Pong in Q8.8 fixed point
+ * Positions are in pixels and velocities in pixels per tick, both with
+ * 8 fraction bits, so the ball moves in steps of 1/256 pixel at any
+ * angle.  Directions are angles of 256 units per turn: 0 is +x (right),
+ * 64 is +y (down the screen).
+ * Only integer arithmetic is used, so the target and a host build give
+ * the same results bit for bit.
+ */
+//*****************************************************************************
+
+#ifndef BALL_H
+#define BALL_H
+
+#include <stdint.h>
+
+#define BALL_ONE 256 // 1.0 in Q8.8
+#define BALL_ANGLE_LEFT 128 // straight towards the paddle
+
+typedef struct{
+    int32_t x, y; // position, Q8.8 pixels
+    int32_t vx, vy; // velocity, Q8.8 pixels per tick
+    int32_t speed; // length of the velocity, Q8.8 pixels per tick
+    uint8_t angle; // direction of travel, 256 per turn
+} Ball_t;
+
+/*
+ * Sine and cosine of an angle of 256 units per turn
+ * Output: value times 16384 (Q2.14), -16384 to 16384
+ */
+int32_t Ball_Sin(uint8_t angle);
+int32_t Ball_Cos(uint8_t angle);
+
+/*
+ * Puts the ball at a pixel, moving at the given angle and speed
+ * Input: x, y in whole pixels, angle 256 per turn, speed in Q8.8 pixels per tick
+ */
+void Ball_Launch(Ball_t *ball, int x, int y, uint8_t angle, int32_t speed);
+
+/*
+ * Changes the speed, keeping the direction
+ * Input: speed in Q8.8 pixels per tick
+ */
+void Ball_SetSpeed(Ball_t *ball, int32_t speed);
+
+/*
+ * Adds step to the speed, up to max (both Q8.8 pixels per tick)
+ */
+void Ball_Accelerate(Ball_t *ball, int32_t step, int32_t max);
+
+/*
+ * Moves the ball by its velocity, one tick
+ */
+void Ball_Step(Ball_t *ball);
+
+/*
+ * Reverses the x (Ball_BounceX) or y (Ball_BounceY) part of the velocity,
+ * as a bounce off a vertical or horizontal surface
+ */
+void Ball_BounceX(Ball_t *ball);
+void Ball_BounceY(Ball_t *ball);
+
+/*
+ * Position rounded to the nearest whole pixel
+ */
+int Ball_PixelX(const Ball_t *ball);
+int Ball_PixelY(const Ball_t *ball);
+
+#endif
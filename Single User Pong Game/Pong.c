@@ -0,0 +1,368 @@
+//*****************************************************************************
+/*
+ * Single user Pong, the game without the hardware, see Pong.h
+ * Nothing here touches a register or the LCD: the firmware in main.c
+ * reads the joystick and draws the commands, a PC can run it headless.
+ */
+//*****************************************************************************
+
+#include <stdint.h>
+#include "Ball.h"
+#include "Pong.h"
+
+#define START_WALL_TOP_Y_COOR 14
+#define START_WALL_BOTTOM_Y_COOR 122
+#define START_WALL_X_COOR 118
+#define MAX_BOUNCES 4 // surfaces the ball can reach in one tick, a corner is two
+#define SURFACE_NONE 0
+#define SURFACE_TOP 1
+#define SURFACE_BOTTOM 2
+#define SURFACE_RIGHT 3
+#define SURFACE_PADDLE 4
+#define BALL_LOST 0 // isColliding() results
+#define BALL_MOVED 1
+#define BALL_HIT 2
+
+/*
+ * Random numbers for the serves, 0 to 32767
+ * The same generator as the C library's example rand(), kept in the
+ * game so a seed gives the same serves everywhere
+ */
+static uint32_t nextRandom(Pong_t *game)
+{
+    game->random = game->random * 1103515245 + 12345;
+    return (game->random >> 16) & 0x7FFF;
+}
+
+/*
+ * Keeps the surface reached first: a time of impact of dist/speed of the
+ * motion is earlier than bestDist/bestSpeed (speed is always positive)
+ */
+static uint8_t isEarlier(int32_t dist, int32_t speed, int32_t *bestDist, int32_t *bestSpeed)
+{
+    if(dist < 0)
+    {
+        dist = 0; // already past it, reached at once
+    }
+    if(dist * (*bestSpeed) >= (*bestDist) * speed)
+    {
+        return 0;
+    }
+    *bestDist = dist;
+    *bestSpeed = speed;
+    return 1;
+}
+
+/*
+ * Moves the ball one tick, bouncing off the walls and the paddle
+ * The whole path of the tick is tested (swept), not only where it ends,
+ * so a fast ball cannot jump over the 2-pixel paddle or through a wall.
+ * The first surface on the path is found from its time of impact, the
+ * ball is moved there, and the rest of the motion is reflected and
+ * tested again, so a ball can bounce more than once in a tick.
+ * The limits are for the ball's bottom left corner (see drawBallAtPos):
+ * the paddle is hit if the ball's rows overlap its rows as the ball's
+ * left edge reaches the paddle's front.
+ *
+ * Input Parameter: ball, paddle position (bottom left corner)
+ * Output/Return Parameter: BALL_LOST if the ball got past the paddle,
+ * BALL_HIT if it bounced off the paddle, else BALL_MOVED
+ */
+static uint8_t isColliding(Ball_t *ball, uint32_t paddleXCoor, uint32_t paddleYCoor)
+{
+    int32_t rx = ball->vx; // motion left in this tick, Q8.8 pixels
+    int32_t ry = ball->vy;
+    int32_t face = (int32_t)(paddleXCoor + PADDLE_WIDTH) * BALL_ONE; // front of the paddle
+    int32_t dist, speed, bestDist, bestSpeed, movedX, movedY;
+    int32_t row;
+    uint8_t surface, bounces;
+    uint8_t result = BALL_MOVED;
+
+    for(bounces = 0; bounces < MAX_BOUNCES; bounces++)
+    {
+        surface = SURFACE_NONE;
+        bestDist = 1; // the end of the motion
+        bestSpeed = 1;
+        if(ry < 0 && isEarlier(ball->y - WALL_TOP_Y * BALL_ONE, -ry, &bestDist, &bestSpeed))
+        {
+            surface = SURFACE_TOP;
+        }
+        if(ry > 0 && isEarlier(WALL_BOTTOM_Y * BALL_ONE - ball->y, ry, &bestDist, &bestSpeed))
+        {
+            surface = SURFACE_BOTTOM;
+        }
+        if(rx > 0 && isEarlier(WALL_RIGHT_X * BALL_ONE - ball->x, rx, &bestDist, &bestSpeed))
+        {
+            surface = SURFACE_RIGHT;
+        }
+        if(rx < 0 && ball->x >= face)
+        {
+            // row of the ball when it gets to the front of the paddle
+            dist = ball->x - face;
+            speed = -rx;
+            row = (ball->y + (dist < speed ? ry * dist / speed : ry) + BALL_ONE/2) / BALL_ONE;
+            if(row > (int32_t)paddleYCoor - PADDLE_HEIGHT && row - BALL_SIZE < (int32_t)paddleYCoor &&
+               isEarlier(dist, speed, &bestDist, &bestSpeed))
+            {
+                surface = SURFACE_PADDLE;
+            }
+        }
+
+        if(surface == SURFACE_NONE)
+        {
+            ball->x += rx;
+            ball->y += ry;
+            break;
+        }
+
+        // move to the surface, then reflect what is left of the motion
+        movedX = rx * bestDist / bestSpeed;
+        movedY = ry * bestDist / bestSpeed;
+        ball->x += movedX;
+        ball->y += movedY;
+        rx -= movedX;
+        ry -= movedY;
+        switch(surface)
+        {
+        case SURFACE_TOP:
+            ball->y = WALL_TOP_Y * BALL_ONE;
+            ry = -ry;
+            Ball_BounceY(ball);
+            break;
+        case SURFACE_BOTTOM:
+            ball->y = WALL_BOTTOM_Y * BALL_ONE;
+            ry = -ry;
+            Ball_BounceY(ball);
+            break;
+        case SURFACE_RIGHT:
+            ball->x = WALL_RIGHT_X * BALL_ONE;
+            rx = -rx;
+            Ball_BounceX(ball);
+            break;
+        default:
+            // bouncing off the paddle, a little faster from the next tick
+            ball->x = face;
+            rx = -rx;
+            Ball_BounceX(ball);
+            Ball_Accelerate(ball, BALL_SPEED_STEP, BALL_MAX_SPEED);
+            result = BALL_HIT;
+            break;
+        }
+    }
+
+    // the ball is lost once its left edge is behind the paddle's front
+    return ball->x < face ? BALL_LOST : result;
+}
+
+/*
+ * Folds a row of the ball's path, with the top and bottom walls unfolded
+ * into a straight line, back between the walls
+ * Sets *flipped to 1 if the ball got there after an odd number of bounces
+ */
+static int32_t foldY(int32_t y, uint8_t *flipped)
+{
+    int32_t span = (WALL_BOTTOM_Y - WALL_TOP_Y) * BALL_ONE;
+    int32_t u = y - WALL_TOP_Y * BALL_ONE;
+    int32_t k = u >= 0 ? u / span : -((span - 1 - u) / span); // rounded down
+    u -= k * span;
+    *flipped = k & 1;
+    return WALL_TOP_Y * BALL_ONE + ((k & 1) ? span - u : u);
+}
+
+/*
+ * Predicts where the ball will cross column xf, without stepping it
+ * The top and bottom walls are unfolded: the path is a straight line
+ * through mirror images of the court, folded back at the end, so the
+ * answer takes the same time however far away the ball is.  A ball
+ * going right comes back off the right wall first.  The speed only
+ * changes at the paddle, so it is constant along the way.
+ *
+ * Input Parameter: ball, column xf (Q8.8, e.g. PADDLE_FACE)
+ * Output/Return Parameter: *yf the row of the ball there (Q8.8),
+ * returns the ticks until it gets there, rounded up
+ */
+static uint32_t calculateDestCoor(const Ball_t *ball, int32_t xf, int32_t *yf)
+{
+    int32_t travel, speed;
+    uint8_t flipped;
+
+    if(ball->vx > 0)
+    {
+        travel = (WALL_RIGHT_X * BALL_ONE - ball->x) + (WALL_RIGHT_X * BALL_ONE - xf);
+        speed = ball->vx;
+    }
+    else if(ball->vx < 0)
+    {
+        travel = ball->x - xf;
+        speed = -ball->vx;
+    }
+    else
+    {
+        *yf = ball->y; // straight up and down, never gets there
+        return UINT32_MAX;
+    }
+    if(travel < 0)
+    {
+        travel = 0;
+    }
+    *yf = foldY(ball->y + ball->vy * travel / speed, &flipped);
+    return (uint32_t)((travel + speed - 1) / speed);
+}
+
+/*
+ * Moves the ball n ticks in one go, bouncing off the walls the same way
+ * as n calls of isColliding(), for n less than calculateDestCoor() gives
+ * for the paddle (the paddle is not tested)
+ */
+static void fastForwardBall(Ball_t *ball, uint32_t n)
+{
+    uint8_t flipped;
+    int32_t x = ball->x + ball->vx * (int32_t)n;
+
+    if(x > WALL_RIGHT_X * BALL_ONE)
+    {
+        x = 2 * WALL_RIGHT_X * BALL_ONE - x;
+        Ball_BounceX(ball);
+    }
+    ball->x = x;
+    ball->y = foldY(ball->y + ball->vy * (int32_t)n, &flipped);
+    if(flipped)
+    {
+        Ball_BounceY(ball);
+    }
+}
+
+/*
+ * Created a Ball at front (right) wall at a random height
+ * 20 pixels from top and bottom are not considered for creating ball's starting height
+ *
+ * Input Parameter: the game, for its random numbers, addresses of the
+ * ball's x and y coordinates
+ * Data type "int"
+ * Output/Return Parameter: Nothing/void
+ */
+static void createBallToStart(Pong_t *game, int *xi, int *yi)
+{
+    // generate height for the ball randomly between given range
+    *yi = (nextRandom(game) % ((START_WALL_BOTTOM_Y_COOR - 20) - (START_WALL_TOP_Y_COOR + 20) + 1)) + START_WALL_TOP_Y_COOR; // 20 pixels buffer from top and bottom walls, for random y-coordinate
+    *xi = START_WALL_X_COOR;
+}
+
+/*
+ * Launches the ball from (xi, yi) towards the paddle at a random angle,
+ * up or down, at the starting speed
+ *
+ * Input Parameter: the game, and the ball's starting pixel
+ * Output/Return Parameter: Nothing/void
+ */
+static void initializeBallStartParams(Pong_t *game, int xi, int yi)
+{
+    int direction = (nextRandom(game) % (1 + 1)) ? 1 : -1; // up or down
+    int angle = LAUNCH_MIN_ANGLE + nextRandom(game) % (LAUNCH_MAX_ANGLE - LAUNCH_MIN_ANGLE + 1);
+    Ball_Launch(&game->ball, xi, yi, (uint8_t)(BALL_ANGLE_LEFT + direction * angle), BALL_START_SPEED);
+}
+
+/*
+ * Serves a new ball from the right wall
+ */
+static void serve(Pong_t *game)
+{
+    int xi, yi;
+
+    createBallToStart(game, &xi, &yi);
+    initializeBallStartParams(game, xi, yi);
+    game->flash = 0;
+    game->rally = 0;
+    calculateDestCoor(&game->ball, PADDLE_FACE, &game->impactY);
+}
+
+/*
+ * Adds a draw command to the list
+ */
+static uint32_t addDraw(PongDraw_t *draw, uint32_t n, uint8_t op, uint8_t arg, int x, int y)
+{
+    draw[n].op = op;
+    draw[n].arg = arg;
+    draw[n].x = (int16_t)x;
+    draw[n].y = (int16_t)y;
+    return n + 1;
+}
+
+void Pong_Init(Pong_t *game, uint32_t seed)
+{
+    game->random = seed;
+    game->countdown = 0;
+    game->lastRally = 0;
+    serve(game);
+}
+
+uint32_t Pong_Tick(Pong_t *game, const PongInput_t *input, PongDraw_t *draw)
+{
+    uint32_t n = 0;
+    uint8_t lastAngle;
+    uint8_t colliding;
+
+    if(game->countdown)
+    {
+        // ball missed: show 3, 2, 1, then serve a new ball
+        game->countdown--;
+        if(game->countdown == 3*COUNTDOWN_TICKS)
+        {
+            n = addDraw(draw, n, PONG_DRAW_DIGIT, '3', 0, 0);
+        }
+        else if(game->countdown == 2*COUNTDOWN_TICKS)
+        {
+            n = addDraw(draw, n, PONG_DRAW_DIGIT, '2', 0, 0);
+        }
+        else if(game->countdown == COUNTDOWN_TICKS)
+        {
+            n = addDraw(draw, n, PONG_DRAW_DIGIT, '1', 0, 0);
+        }
+        else if(game->countdown == 0)
+        {
+            serve(game);
+            n = addDraw(draw, n, PONG_DRAW_SERVE, 0, 0, 0);
+        }
+        return n;
+    }
+
+    // where the ball will cross the paddle's front, shown left of the paddle
+    calculateDestCoor(&game->ball, PADDLE_FACE, &game->impactY);
+    n = addDraw(draw, n, PONG_DRAW_MARKER, 0, 0, (game->impactY + BALL_ONE/2) / BALL_ONE);
+    n = addDraw(draw, n, PONG_DRAW_PADDLE, 0, PADDLE_X, input->paddleY);
+
+    lastAngle = game->ball.angle;
+    colliding = isColliding(&game->ball, PADDLE_X, input->paddleY);
+    if(colliding == BALL_LOST)
+    {
+        game->lastRally = game->rally;
+        game->countdown = 4*COUNTDOWN_TICKS;
+        return addDraw(draw, n, PONG_DRAW_MISS, 0, 0, 0);
+    }
+    if(colliding == BALL_HIT)
+    {
+        game->rally++;
+    }
+
+    // a bounce flashes the ball
+    if(game->ball.angle != lastAngle)
+    {
+        game->flash = FLASH_TICKS;
+        n = addDraw(draw, n, PONG_DRAW_FLASH, 1, 0, 0);
+    }
+    else if(game->flash && --game->flash == 0)
+    {
+        n = addDraw(draw, n, PONG_DRAW_FLASH, 0, 0, 0);
+    }
+    return addDraw(draw, n, PONG_DRAW_BALL, 0, Ball_PixelX(&game->ball), Ball_PixelY(&game->ball));
+}
+
+uint8_t Pong_Skip(Pong_t *game, uint32_t n)
+{
+    if(game->countdown || calculateDestCoor(&game->ball, PADDLE_FACE, &game->impactY) <= n)
+    {
+        return 0;
+    }
+    fastForwardBall(&game->ball, n);
+    return 1;
+}
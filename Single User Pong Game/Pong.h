@@ -0,0 +1,90 @@
+//*****************************************************************************
+/*
+ * Single user Pong, the game without the hardware
+ * The state and rules of the game: the ball, the walls, the paddle, the
+ * rally and the countdown before each serve.  Each tick takes the
+ * paddle position as input and gives back a short list of draw commands
+ * (see PongDraw_t), so the same code runs on the LaunchPad, drawn on the
+ * ST7735, and on a PC with nothing drawn at all.
+ * Positions are Q8.8 pixels (see Ball.h), the limits below are for the
+ * bottom left corner of the ball and of the paddle, as drawn.
+ */
+//*****************************************************************************
+
+#ifndef PONG_H
+#define PONG_H
+
+#include <stdint.h>
+#include "Ball.h"
+
+#define TICK_HZ 120 // simulation ticks per second
+#define WALL_TOP_Y 9 // limits of the ball's bottom left corner
+#define WALL_BOTTOM_Y 122
+#define WALL_RIGHT_X 118
+#define PADDLE_X 5 // paddle column, bottom left corner
+#define PADDLE_WIDTH 2
+#define PADDLE_HEIGHT 16
+#define PADDLE_FACE ((PADDLE_X + PADDLE_WIDTH) * BALL_ONE) // front of the paddle, Q8.8
+#define PADDLE_MIN_Y 16 // paddle rows the joystick gives
+#define PADDLE_MAX_Y 127
+#define BALL_SIZE 5
+#define BALL_START_SPEED BALL_ONE // Q8.8 pixels per tick, 120 pixels per second
+#define BALL_SPEED_STEP (BALL_ONE/16) // added at each paddle hit
+#define BALL_MAX_SPEED (3*BALL_ONE)
+#define LAUNCH_MIN_ANGLE 8 // launch angles either side of straight left, 256 per turn
+#define LAUNCH_MAX_ANGLE 40 // (11 to 56 degrees)
+#define COUNTDOWN_TICKS TICK_HZ // ticks each countdown digit is shown
+#define FLASH_TICKS 12 // ticks the ball stays in its flash colors after a bounce
+
+// draw commands, what changed in a tick
+#define PONG_DRAW_BALL 0 // ball to (x, y)
+#define PONG_DRAW_PADDLE 1 // paddle to (x, y)
+#define PONG_DRAW_MARKER 2 // predicted impact to (x, y), left of the paddle
+#define PONG_DRAW_FLASH 3 // ball flash colors on (arg 1) or off (arg 0)
+#define PONG_DRAW_MISS 4 // ball got past the paddle, nothing to draw
+#define PONG_DRAW_DIGIT 5 // countdown screen showing the character arg
+#define PONG_DRAW_SERVE 6 // countdown over, clear it and draw the court
+#define PONG_MAX_DRAWS 4 // most commands one tick gives
+
+typedef struct{
+    uint8_t op; // PONG_DRAW_...
+    uint8_t arg;
+    int16_t x, y; // whole pixels
+} PongDraw_t;
+
+typedef struct{
+    uint32_t paddleY; // paddle row, PADDLE_MIN_Y to PADDLE_MAX_Y
+} PongInput_t;
+
+typedef struct{
+    Ball_t ball;
+    int32_t impactY; // row where the ball will reach the paddle's front, Q8.8
+    uint32_t countdown; // ticks left before a new ball, 0 while playing
+    uint32_t rally; // paddle hits since the serve
+    uint32_t lastRally; // paddle hits before the last miss
+    uint32_t random; // state of the game's own random numbers
+    uint8_t flash; // ticks left in the flash colors
+} Pong_t;
+
+/*
+ * Starts a game with a ball served from the right wall
+ * The same seed gives the same game, on the target or a PC
+ */
+void Pong_Init(Pong_t *game, uint32_t seed);
+
+/*
+ * Runs the game one tick
+ * Input: the paddle position, draw[] room for PONG_MAX_DRAWS commands
+ * Output: number of commands put in draw[]
+ */
+uint32_t Pong_Tick(Pong_t *game, const PongInput_t *input, PongDraw_t *draw);
+
+/*
+ * Moves the game n ticks at once, with no input and nothing drawn
+ * Only done while the ball is in play and cannot reach the paddle in
+ * the n ticks (the ball's flight is worked out in closed form).
+ * Output: 1 if done, 0 if the n ticks have to be stepped or dropped
+ */
+uint8_t Pong_Skip(Pong_t *game, uint32_t n);
+
+#endif
@@ -18,19 +18,27 @@
 #include "driverlib/debug.h"
 #include "driverlib/fpu.h"
 #include "driverlib/gpio.h"
+#include "driverlib/interrupt.h"
 #include "driverlib/pin_map.h"
 #include "driverlib/sysctl.h"
 #include "driverlib/uart.h"
 #include "utils/uartstdio.h"
 #include "driverlib/adc.h"
+#include "driverlib/systick.h"
 
 // Include Booster Pack libraries
 #include "ST7735.h"
 #include "PLL.h"
+#include "Ball.h"
+#include "Pong.h" // the game itself, this file reads the joystick and draws it
 
-#define START_WALL_TOP_Y_COOR 14
-#define START_WALL_BOTTOM_Y_COOR 122
-#define START_WALL_X_COOR 118
+#define AUTOPLAY 0 // 1 to move the paddle to the predicted impact instead of the joystick
+#define MAX_CATCHUP 8 // most ticks simulated before a render, later ones are dropped
+#define REPORT_TICKS (2*TICK_HZ) // ticks between rate reports on UART0
+#define SPRITE_BALL 0
+#define SPRITE_PADDLE 1
+#define SPRITE_MARKER 2
+#define SPRITE_COUNT 3
 
 
 // Functions used
@@ -42,39 +50,57 @@ void drawPaddleAtPos(int x, int y);
 void drawBallAtPos(int x,int y);
 void drawWalls();
 uint32_t getYCoordinate(uint32_t adcValue, uint32_t in_min, uint32_t in_max);
-void calculateDestCoor(uint8_t xi, uint8_t yi, uint8_t aoi, uint8_t wallNumber, uint8_t *xf, uint8_t *yf);
-void getRandomSlope(uint8_t index, int dir, int *dx, int *dy);
-void drawBallAtNextPos(int *x, int *y, int dx, int dy);
-uint8_t isColliding(int ballXCoor, int ballYCoor, int *dx, int *dy, uint32_t paddleXCoor, uint32_t paddleYCoor);
-void createBallToStart(int *xi, int *yi);
-void initializeBallStartParams(int *direction, uint8_t *index, int *dx, int *dy);
-
-// Ball of size 5x5
+void drawBallAtNextPos(Ball_t *ball);
+void drawCommands(const PongDraw_t *draw, uint32_t n, char *digit, uint8_t *erase);
+void initializeSprites();
+void drawCountdown(char digit);
+void SysTickHandler(void);
+void initialiseTicks();
+
+// Ball and paddle share one 8x16 atlas, 4 bits per pixel, top row first
+// (index 0 white, 1 black), each sprite is a rectangle of it
+//
+// Paddle is 16x2 array of black pixels, columns 0 and 1
+// Ball of size 5x5, columns 3 to 7 of the top 5 rows
 // Outer single-pixel wide border of ball is white
 // Inner 3x3 is the black ball
 // Outer white wall helps to clean the trail left behind (at certain angles only)
-const uint16_t circle_5[]= {
-    0XFFFF, 0XFFFF, 0XFFFF, 0XFFFF, 0XFFFF,
-    0XFFFF, 0X0000, 0X0000, 0X0000, 0XFFFF,
-    0XFFFF, 0X0000, 0X0000, 0X0000, 0XFFFF,
-    0XFFFF, 0X0000, 0X0000, 0X0000, 0XFFFF,
-    0XFFFF, 0XFFFF, 0XFFFF, 0XFFFF, 0XFFFF
+// The sprite engine restores whatever the border does not cover
+const uint8_t pongPixels[]= {
+    0X11, 0X00, 0X00, 0X00,
+    0X11, 0X00, 0X11, 0X10,
+    0X11, 0X00, 0X11, 0X10,
+    0X11, 0X00, 0X11, 0X10,
+    0X11, 0X00, 0X00, 0X00,
+    0X11, 0X00, 0X00, 0X00,
+    0X11, 0X00, 0X00, 0X00,
+    0X11, 0X00, 0X00, 0X00,
+    0X11, 0X00, 0X00, 0X00,
+    0X11, 0X00, 0X00, 0X00,
+    0X11, 0X00, 0X00, 0X00,
+    0X11, 0X00, 0X00, 0X00,
+    0X11, 0X00, 0X00, 0X00,
+    0X11, 0X00, 0X00, 0X00,
+    0X11, 0X00, 0X00, 0X00,
+    0X11, 0X00, 0X00, 0X00
 };
+const Atlas_t pongAtlas= {pongPixels, 4, 1, 8, 16};
+const uint16_t pongPalette[16]= {0XFFFF, 0X0000};
+const uint16_t ballFlashPalette[16]= {0XFFFF, ST7735_RED}; // ball after a bounce
 
-// Paddle is 16x2 arrayof black pixels
-// Width is 2 and height is 16 pixels
-const uint16_t paddle_2[]= {
-    0X0000, 0X0000,0X0000, 0X0000,0X0000, 0X0000,0X0000, 0X0000,0X0000, 0X0000,0X0000, 0X0000,0X0000, 0X0000,0X0000, 0X0000,
-     0X0000, 0X0000,0X0000, 0X0000,0X0000, 0X0000,0X0000, 0X0000,0X0000, 0X0000,0X0000, 0X0000,0X0000, 0X0000,0X0000, 0X0000
-};
+// walls are one color, so run-length encoded each is a single run
+// (4 bytes instead of 1210 or 1180 bytes as bitmaps)
+// The top and bottom walls start right of the paddle, which moves
+// over the full height of the screen
+const uint16_t wall_horizontal[]= {121*5, 0X0000}; // 121x5
+const uint16_t wall_vertical[]= {5*118, 0X0000};   // 5x118
 
-// Brick array is used to create a wall inside a loop
-// Better than having huge wall array
-const uint16_t brick[]= {0X0000, 0X0000, 0X0000, 0X0000, 0X0000};
+// Ball and paddle are drawn by the ST7735 sprite engine,
+// which only repaints what moved
+Sprite_t sprites[SPRITE_COUNT];
 
-//17 different pairs of slopes to start the game with
-// changing dy from +ve and -ve, makes this a 34 total pairs of dx-dy
-const uint16_t slope[]= {3, 1, 2, 1, 1, 1, 1, 2, 1, 3, 2, 3, 3, 2};
+// SysTick count, the simulation runs one step for each
+volatile uint32_t ticks = 0;
 
 
 //*****************************************************************************
@@ -138,12 +164,9 @@ int main(void)
     uint32_t seed = 0;
     uint32_t ui32ADC0Value[3];
     uint32_t xCoor, yCoor;
-    int xi = 0; // initial location
-    int yi = 0;
-    int dx = 0; //steps to in x-dir
-    int dy = 0; //steps to in y-dir
-    int direction;
-    uint8_t index;
+    Pong_t game; // ball, rally and countdown
+    PongInput_t input;
+    PongDraw_t draw[PONG_MAX_DRAWS];
 
     ST7735_FillScreen(0xFFFF);
 
@@ -157,21 +180,17 @@ int main(void)
     }
     seed = ui32ADC0Value[2];
     ST7735_FillScreen(0xFFFF);
+    drawWalls();
+    initializeSprites();
 
-    srand(seed);
     UARTprintf("seed: %d\n", seed);
-    createBallToStart(&xi, &yi);
-
-    initializeBallStartParams(&direction, &index, &dx, &dy);
+    Pong_Init(&game, seed);
 
 
-//    UARTprintf("index: %d\n", index);
-//    UARTprintf("direction: %d\n", direction);
-//    UARTprintf("dx: %d\n", dx);
-//    UARTprintf("dy: %d\n", dy);
-//    UARTprintf("xi, yi: %d, %d\n", xi, yi);
+//    UARTprintf("angle: %d\n", game.ball.angle);
 
-    drawBallAtPos(xi, yi);
+    drawBallAtNextPos(&game.ball);
+    ST7735_SpriteUpdate(sprites, SPRITE_COUNT);
 
 
     while(getYCoordinate(ui32ADC0Value[1], 0, 3800) > 30)
@@ -181,53 +200,138 @@ int main(void)
         SysCtlDelay(300);
     }
 
-    uint8_t updateFrame = 1;
+    // The game is simulated in fixed steps of 1/TICK_HZ seconds, so the
+    // ball speed does not depend on how long drawing takes.  After the
+    // ticks that came due are simulated, one frame is rendered; under
+    // load frames are skipped, and past MAX_CATCHUP ticks the game
+    // slows down rather than freezing to catch up.  Between ticks the
+    // processor sleeps.
+    // Only the moved parts of the ball and paddle are redrawn each frame
+    // (see ST7735_SpriteUpdate)
+    uint32_t simTicks;
+    uint32_t reportTicks;
+    uint32_t simulated = 0; // ticks simulated since the last report
+    uint32_t frames = 0; // frames rendered since the last report
+    uint32_t overruns = 0; // ticks dropped since the last report
+    uint32_t txBytes = 0;
+    uint32_t behind;
+    uint32_t skip;
+    char digit = 0; // countdown digit to draw at the next render, 0 for none
+    uint8_t erase = 0; // 1 to erase the countdown at the next render
+
+    initialiseTicks();
+    simTicks = ticks;
+    reportTicks = simTicks;
     while(1)
     {
-        if(updateFrame == 0)
+        // masked, so a tick between the test and the sleep cannot be
+        // missed: a pending SysTick still wakes the sleep, and its
+        // handler runs once interrupts are enabled again
+        IntMasterDisable();
+        while(simTicks == ticks)
         {
-            updateFrame = 1;
-            ST7735_FillScreen(0xFFFF);
+            SysCtlSleep(); // wait for interrupt, SysTick wakes it up
+            IntMasterEnable();
+            IntMasterDisable();
+        }
+        IntMasterEnable();
+        behind = ticks - simTicks;
+        if(behind > MAX_CATCHUP)
+        {
+            // too far behind to step every tick: if the ball stays clear
+            // of the paddle its flight is worked out in one go, else the
+            // ticks are dropped
+            skip = behind - MAX_CATCHUP;
+            if(Pong_Skip(&game, skip))
+            {
+                simulated += skip; // simulated, just not one by one
+            }
+            else
+            {
+                overruns += skip;
+            }
+            simTicks += skip;
         }
-        updateFrame--;
-        getMappedADCValue(&ui32ADC0Value);
 
-//        UARTprintf("xADC0Value: %d    yADC0Value: %d\n", ui32ADC0Value[0], ui32ADC0Value[1]);
+        // simulate every tick that came due
+        while(simTicks != ticks)
+        {
+            simTicks++;
+            simulated++;
+            if(game.countdown == 0)
+            {
+                getMappedADCValue(&ui32ADC0Value);
+                yCoor = getYCoordinate(ui32ADC0Value[1], 0, 3800);
+#if AUTOPLAY
+                // center the paddle (rows yCoor-15 to yCoor) on the ball (rows y-4 to y)
+                yCoor = (game.impactY + BALL_ONE/2) / BALL_ONE + (PADDLE_HEIGHT - BALL_SIZE) / 2;
+                yCoor = yCoor < PADDLE_MIN_Y ? PADDLE_MIN_Y : yCoor > PADDLE_MAX_Y ? PADDLE_MAX_Y : yCoor;
+#endif
+                input.paddleY = yCoor;
+            }
+            drawCommands(draw, Pong_Tick(&game, &input, draw), &digit, &erase);
+        }
 
-        yCoor = getYCoordinate(ui32ADC0Value[1], 0, 3800);
-//        UARTprintf("xCoor: %d    yCoor: %d\n", xCoor, yCoor);
-        drawPaddleAtPos(5, yCoor);
-        if(isColliding(xi, yi, &dx, &dy, 5, yCoor) == 1)
+        // render the state after the last tick
+        ST7735_ClearTxCount();
+        if(digit)
         {
-            drawBallAtNextPos(&xi, &yi, dx, dy);
+            drawCountdown(digit);
+            digit = 0;
         }
-        else
+        else if(erase)
         {
-
-            SysCtlDelay(30000000);
-            ST7735_FillScreen(0xFFFF);
-            ST7735_DrawCharS (60, 60, '3', ST7735_Color565(255, 0, 0), 0, 3);
-            SysCtlDelay(30000000);
-
-            ST7735_FillScreen(0xFFFF);
-            ST7735_DrawCharS (60, 60, '2', ST7735_Color565(255, 0, 0), 0, 3);
-            SysCtlDelay(30000000);
-
-            ST7735_FillScreen(0xFFFF);
-            ST7735_DrawCharS (60, 60, '1', ST7735_Color565(255, 0, 0), 0, 3);
-            SysCtlDelay(30000000);
-
-            createBallToStart(&xi, &yi);
-            initializeBallStartParams(&direction, &index, &dx, &dy);
-
-
-            drawBallAtPos(xi, yi);
+            ST7735_FillRect(60, 60, 18, 24, 0xFFFF); // erase the '1'
+            drawWalls(); // the countdown screen covered them
+            initializeSprites(); // screen was cleared, nothing is drawn
+            drawBallAtNextPos(&game.ball);
+            drawPaddleAtPos(PADDLE_X, yCoor);
+            erase = 0;
         }
+        if(game.countdown == 0)
+        {
+            ST7735_SpriteUpdate(sprites, SPRITE_COUNT);
+        }
+        txBytes += ST7735_GetTxCount();
+        frames++;
 
-        SysCtlDelay(500000);
+        if(simTicks - reportTicks >= REPORT_TICKS)
+        {
+            UARTprintf("ticks/s: %d  frames/s: %d  overruns: %d  LCD bytes/frame: %d\n",
+                       simulated*TICK_HZ/(simTicks - reportTicks),
+                       frames*TICK_HZ/(simTicks - reportTicks),
+                       overruns, txBytes/frames);
+            reportTicks = simTicks;
+            simulated = 0;
+            frames = 0;
+            overruns = 0;
+            txBytes = 0;
+        }
     }
 }
 
+/*
+ * SysTick interrupt, TICK_HZ times a second
+ * Must be placed in the vector table as the SysTick handler
+ */
+void SysTickHandler(void)
+{
+    ticks++;
+}
+
+/*
+ * Starts SysTick interrupts at TICK_HZ, the clock must already be set
+ *
+ * Input Parameter: Nothing/void
+ * Output/Return Parameter: Nothing/void
+ */
+void initialiseTicks()
+{
+    SysTickPeriodSet(SysCtlClockGet() / TICK_HZ); // 666,667 cycles at 80 MHz, fits in 24 bits
+    SysTickIntEnable();
+    SysTickEnable();
+}
+
 
 void getMappedADCValue(uint32_t *ui32ADC0Value)
 {
@@ -322,34 +426,28 @@ void initialiseADC()
 
 }
 
+/*
+ * Draws the top, right and bottom walls around the court, just
+ * outside where the ball can go (see WALL_TOP_Y and friends in Pong.h)
+ * The screen is cleared by the countdown, so they are drawn again at
+ * each serve
+ *
+ * Input Parameter: Nothing/void
+ * Output/Return Parameter: Nothing/void
+ */
 void drawWalls()
 {
-    // loop is better since array size is stupidly big
-
-    // top
-    uint8_t i = 0;
-    for(i = 0; i < 128; ++i)
-    {
-        ST7735_DrawBitmap(i, 9, brick, 1, 5);
-    }
+    // top, columns 7 to 127, rows 0 to 4
+    ST7735_DrawBitmapRLE(PADDLE_X + PADDLE_WIDTH, 4, wall_horizontal, 121, 5);
 
-    // right
-    for(i = 5; i < 123; ++i)
-    {
-        ST7735_DrawBitmap(123, i, brick, 5, 1);
-    }
+    // right, columns 123 to 127, rows 5 to 122
+    ST7735_DrawBitmapRLE(123, 122, wall_vertical, 5, 118);
 
-    // bottom
-    for(i = 0; i < 128; ++i)
-    {
-        ST7735_DrawBitmap(i, 127, brick, 1, 5);
-    }
+    // bottom, columns 7 to 127, rows 123 to 127
+    ST7735_DrawBitmapRLE(PADDLE_X + PADDLE_WIDTH, 127, wall_horizontal, 121, 5);
 
     // left
-//    for(i = 5; i < 123; ++i)
-//    {
-//        ST7735_DrawBitmap(0, i, brick, 5, 1);
-//    }
+//    ST7735_DrawBitmapRLE(0, 122, wall_vertical, 5, 118);
 }
 
 uint32_t getYCoordinate(uint32_t adcValue, uint32_t in_min, uint32_t in_max)
@@ -362,85 +460,112 @@ uint32_t getYCoordinate(uint32_t adcValue, uint32_t in_min, uint32_t in_max)
     return 128 - value;
 }
 
-void drawBallAtPos(int x, int y)
+/*
+ * Draws a countdown screen: the digit in red on a black box over a white screen
+ * The whole screen is composed in one pass, so the old frame is replaced
+ * without first flashing white
+ *
+ * Input Parameter: digit to show
+ * Output/Return Parameter: Nothing/void
+ */
+void drawCountdown(char digit)
 {
-//    UARTprintf("x, y: %d, %d\n", x, y);
-    ST7735_DrawBitmap(x, y, circle_5, 5, 5);
+    char text[2];
+    Layer_t layer;
+
+    text[0] = digit;
+    text[1] = 0;
+    layer.type = LAYER_TEXT;
+    layer.x = 60;
+    layer.y = 60;
+    layer.color = ST7735_Color565(255, 0, 0);
+    layer.key = 0; // black background box
+    layer.text = text;
+    layer.size = 3;
+    ST7735_Compose(&layer, 1, 0xFFFF, 0, 0, 128, 128);
 }
 
-
-void getRandomSlope(uint8_t index, int dir, int *dx, int *dy)
+/*
+ * Places the ball sprite, it is drawn by the next ST7735_SpriteUpdate()
+ */
+void drawBallAtPos(int x, int y)
 {
-    index = index * 2;
-//    UARTprintf("slope[%d] = %d\n", index, slope[index]);
-    *dx = slope[index] * (-1);
-    dir = dir == 0 ? -1 : dir;
-    *dy = slope[index + 1] * dir;
+//    UARTprintf("x, y: %d, %d\n", x, y);
+    ST7735_SpriteMove(&sprites[SPRITE_BALL], x, y);
 }
 
-void drawBallAtNextPos(int *x, int *y, int dx, int dy)
+
+/*
+ * Places the ball sprite at the nearest pixel to where the ball is now,
+ * after isColliding() has moved it
+ */
+void drawBallAtNextPos(Ball_t *ball)
 {
-    *x = *x + dx;
-    *y = *y + dy;
-    drawBallAtPos(*x, *y);
+    drawBallAtPos(Ball_PixelX(ball), Ball_PixelY(ball));
 }
 
-uint8_t isColliding(int ballXCoor, int ballYCoor, int *dx, int *dy, uint32_t paddleXCoor, uint32_t paddleYCoor)
+/*
+ * Carries out the draw commands of a tick (see Pong.h)
+ * The sprites are only placed here and drawn at the next render, the
+ * countdown screens are left for the render through digit and erase
+ *
+ * Input Parameter: the commands, how many, where to note a countdown
+ * Output/Return Parameter: Nothing/void
+ */
+void drawCommands(const PongDraw_t *draw, uint32_t n, char *digit, uint8_t *erase)
 {
-    int nextX, nextY;
-    nextX = ballXCoor + *dx;
-    nextY = ballYCoor + *dy;
-//int xr = 118, yr = 66, xb = 61, yb = 122, xl = 5, yl = 66, xt = 61, yt = 14;
-
-    if(ballXCoor < (paddleXCoor + 2) && (ballYCoor <= paddleYCoor || (ballYCoor >= paddleYCoor - 16)))
-    {
-        // if balls passes the left wall/paddle area
-        return 0;
-    }
+    uint32_t i;
 
-    if(nextY >= 122 || nextY <= 9)
+    for(i = 0; i < n; i++)
     {
-        // bouncing off the top and bottom walls
-        *dy = (-1) * (*dy);
-    }
-
-    if(nextX >= 118)
-    {
-        // bouncing off the right wall
-        *dx = (-1) * (*dx);
-    }
-
-    if(((nextY <= (paddleYCoor)  && nextY > paddleYCoor - 16) && (nextX <= paddleXCoor + 2)) || ((ballYCoor <= (paddleYCoor)  && ballYCoor > paddleYCoor - 16) && (ballXCoor <= paddleXCoor + 2)))
-    {
-        //bouncing off the paddle
-        *dx = (-1) * (*dx);
+        switch(draw[i].op)
+        {
+        case PONG_DRAW_BALL:
+            drawBallAtPos(draw[i].x, draw[i].y);
+            break;
+        case PONG_DRAW_PADDLE:
+            drawPaddleAtPos(draw[i].x, draw[i].y);
+            break;
+        case PONG_DRAW_MARKER:
+            ST7735_SpriteMove(&sprites[SPRITE_MARKER], draw[i].x, draw[i].y);
+            break;
+        case PONG_DRAW_FLASH:
+            // a bounce flashes the ball by swapping its palette, the image is unchanged
+            ST7735_SpritePalette(&sprites[SPRITE_BALL], draw[i].arg ? ballFlashPalette : pongPalette);
+            break;
+        case PONG_DRAW_DIGIT:
+            *digit = (char)draw[i].arg;
+            break;
+        case PONG_DRAW_SERVE:
+            *erase = 1;
+            break;
+        default:
+            break; // a miss shows as the countdown
+        }
     }
-    return 1;
 }
 
+/*
+ * Places the paddle sprite, it is drawn by the next ST7735_SpriteUpdate()
+ */
 void drawPaddleAtPos(int x,int y)
 {
-    ST7735_DrawBitmap(x, y, paddle_2, 2, 16);
+    ST7735_SpriteMove(&sprites[SPRITE_PADDLE], x, y);
 }
 
 /*
- * Created a Ball at front (right) wall at a random height
- * 20 pixels from top and bottom are not considered for creating ball's starting height
+ * Sets up the ball and paddle sprites over the white background
+ * Called again whenever the screen is cleared, so nothing is marked as drawn
  *
- * Input Parameter: Addresses of the ball's x and y coordinates
- * Data type "int"
+ * Input Parameter: Nothing/void
  * Output/Return Parameter: Nothing/void
  */
-void createBallToStart(int *xi, int *yi)
+void initializeSprites()
 {
-    // generate height for the ball randomly between given range
-    *yi = (rand() % ((START_WALL_BOTTOM_Y_COOR - 20) - (START_WALL_TOP_Y_COOR + 20) + 1)) + START_WALL_TOP_Y_COOR; // 20 pixels buffer from top and bottom walls, for random y-coordinate
-    *xi = START_WALL_X_COOR;
+    ST7735_SpriteBackground(0xFFFF);
+    ST7735_SpriteInitAtlas(&sprites[SPRITE_BALL], &pongAtlas, pongPalette, 3, 0, 5, 5, -1);
+    ST7735_SpriteInitAtlas(&sprites[SPRITE_PADDLE], &pongAtlas, pongPalette, 0, 0, 2, 16, -1);
+    // impact marker, a red 2x5 piece of the paddle
+    ST7735_SpriteInitAtlas(&sprites[SPRITE_MARKER], &pongAtlas, ballFlashPalette, 0, 0, 2, BALL_SIZE, -1);
 }
 
-void initializeBallStartParams(int *direction, uint8_t *index, int *dx, int *dy)
-{
-    *direction = (rand() % (1 + 1)); // generate direction either 0 or 1
-    *index = (rand() % (6 + 1)); // create random index for the dx-dy slop array, between 0 and 16 (17 pairs used)
-    getRandomSlope(*index, *direction, dx, dy);
-}
@@ -0,0 +1,153 @@
+// atlastest.c
+// Runs on a PC (Linux), not on the LaunchPad.
+// Random check of ST7735_DrawAtlas() (Single User Pong Game driver)
+// using the SSI/uDMA model in st7735shim.c.  Each trial makes an
+// atlas of random size, format (16-bit colors, 8-bit or 4-bit
+// palette indexes) and row order, then draws a random source
+// rectangle at a random screen position, both often hanging off
+// the edges.  The screen is read back from the wire and compared
+// with a per-pixel reference that only draws atlas pixels that
+// exist and land on the screen.
+// It fails on the first different screen, or if the shim finds a
+// handshake error.
+//
+// build: gcc -O1 -no-pie -w -DST7735_SHIM -I. -I"../Single User Pong Game"
+//          -I"../Ball Roll using accelerometer" -o atlastest atlastest.c
+//          st7735shim.c "../Single User Pong Game/ST7735.c"
+// usage: ./atlastest [trials]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "ST7735.h"
+#include "st7735shim.h"
+
+#define ST7735_CASET   0x2A
+#define ST7735_RASET   0x2B
+#define ST7735_RAMWR   0x2C
+#define SIZE 128                        // screen of the Single User Pong Game driver
+#define MAXATLAS 64                     // largest atlas side tried
+
+static uint16_t Screen[SIZE*SIZE], Expect[SIZE*SIZE];
+static uint16_t Image16[MAXATLAS*MAXATLAS];
+static uint8_t Image8[MAXATLAS*MAXATLAS];
+static uint16_t Palette[256];
+
+// Replay the wire since the last Shim_Clear() into Screen.  The
+// window is kept between calls, since the driver does not resend
+// an address window that is already set.
+static void replay(void){
+  static int x0 = 0, x1 = SIZE-1, y0 = 0, x = 0, y = 0;
+  const ShimWire_t *w = &Shim_Wire[SHIM_SSI0];
+  uint32_t i, cmd = 0, arg = 0;
+  uint8_t a[4];
+  int hi = -1;
+  for(i=0; i<w->count; i++){
+    if((w->data[i]&SHIM_DATA) == 0){
+      cmd = w->data[i];
+      arg = 0;
+      if(cmd == ST7735_RAMWR){
+        x = x0;
+        y = y0;
+        hi = -1;
+      }
+      continue;
+    }
+    if((cmd == ST7735_CASET) || (cmd == ST7735_RASET)){
+      a[arg++&3] = w->data[i];
+      if(arg == 4){
+        if(cmd == ST7735_CASET){
+          x0 = a[1]; x1 = a[3];
+        } else{
+          y0 = a[1];
+        }
+      }
+    } else if(cmd == ST7735_RAMWR){
+      if(hi < 0){
+        hi = w->data[i]&0xFF;
+        continue;
+      }
+      if((x < SIZE) && (y < SIZE)) Screen[SIZE*y + x] = (hi<<8) | (w->data[i]&0xFF);
+      hi = -1;
+      if(++x > x1){
+        x = x0;
+        y++;
+      }
+    }
+  }
+}
+
+// Color of atlas pixel (col,row), row counted from the top.
+static uint16_t pixel(const Atlas_t *atlas, int col, int row){
+  int rowSize = (atlas->w*atlas->bpp + 7)/8;
+  int r = atlas->topDown ? row : (atlas->h - 1 - row);
+  uint8_t b;
+  if(atlas->bpp == 16) return Image16[r*atlas->w + col];
+  if(atlas->bpp == 8) return Palette[Image8[r*rowSize + col]];
+  b = Image8[r*rowSize + col/2];
+  return Palette[(col&1) ? (b&0x0F) : (b>>4)];
+}
+
+static int rnd(int lo, int hi){
+  return lo + rand()%(hi - lo + 1);
+}
+
+int main(int argc, char **argv){
+  static const uint8_t bpps[3] = {16, 8, 4};
+  long trials = (argc > 1) ? atol(argv[1]) : 200000;
+  long t, drawn = 0;
+  uint64_t pixels = 0;
+  Atlas_t atlas;
+  int i, x, y, sx, sy, w, h, c, r;
+  srand(1);
+  Shim_Init();
+  ST7735_InitR(INITR_REDTAB);
+  ST7735_FillScreen(0);
+  ST7735_WaitIdle();
+  Shim_Drain();
+  replay();
+  Shim_Clear();
+  memcpy(Expect, Screen, sizeof(Screen));
+  for(t=0; t<trials; t++){
+    atlas.bpp = bpps[t%3];
+    atlas.topDown = (t/3)&1;
+    atlas.w = rnd(1, MAXATLAS);
+    atlas.h = rnd(1, MAXATLAS);
+    atlas.image = (atlas.bpp == 16) ? (const void *)Image16 : (const void *)Image8;
+    for(i=0; i<MAXATLAS*MAXATLAS; i++){
+      Image16[i] = rand();
+      Image8[i] = rand();
+    }
+    for(i=0; i<256; i++) Palette[i] = rand();
+    sx = rnd(-20, atlas.w + 4);
+    sy = rnd(-20, atlas.h + 4);
+    w = rnd(-2, MAXATLAS + 8);
+    h = rnd(-2, MAXATLAS + 8);
+    x = rnd(-MAXATLAS, SIZE + 4);
+    y = rnd(-MAXATLAS, SIZE + 4);
+    ST7735_DrawAtlas(x, y, &atlas, Palette, sx, sy, w, h);
+    ST7735_WaitIdle();
+    Shim_Drain();
+    replay();
+    if(Shim_Wire[SHIM_SSI0].count) drawn++;
+    Shim_Clear();
+    for(r=0; r<h; r++){
+      for(c=0; c<w; c++){
+        if((sx+c < 0) || (sx+c >= atlas.w) || (sy+r < 0) || (sy+r >= atlas.h)) continue;
+        if((x+c < 0) || (x+c >= SIZE) || (y+r < 0) || (y+r >= SIZE)) continue;
+        Expect[SIZE*(y+r) + x+c] = pixel(&atlas, sx+c, sy+r);
+        pixels++;
+      }
+    }
+    if(memcmp(Expect, Screen, sizeof(Screen)) || Shim_Errors){
+      printf("FAIL: trial %ld, %d-bit %s atlas %dx%d, source (%d,%d) %dx%d at (%d,%d), %u handshake errors\n",
+             t, atlas.bpp, atlas.topDown ? "top down" : "bottom up", atlas.w, atlas.h,
+             sx, sy, w, h, x, y, Shim_Errors);
+      return 1;
+    }
+  }
+  printf("PASS: %ld trials, %ld drew something, %llu pixels\n", trials, drawn,
+         (unsigned long long)pixels);
+  return 0;
+}
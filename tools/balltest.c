@@ -0,0 +1,117 @@
+// balltest.c
+// Runs on a PC (any C compiler), not on the LaunchPad.
+// Checks the Q8.8 ball kinematics of Ball.c (Single User Pong Game)
+// against double precision:
+//  - Ball_Sin() and Ball_Cos() for all 256 angles
+//  - the velocity Ball_Launch() sets, at every angle and speed the
+//    game uses (1 to 3 pixels per tick in steps of 1/16)
+//  - the position after each Ball_Step(), for 2 seconds of ticks,
+//    which may drift by at most the rounding of the velocity
+//  - Ball_BounceX() and Ball_BounceY(): the reflected angle, and the
+//    velocity recomputed from it by Ball_SetSpeed() must equal the
+//    negated one exactly, so a speed change after a bounce does not
+//    bend the path
+//  - Ball_Accelerate() stops at the maximum, and Ball_PixelX() and
+//    Ball_PixelY() round halves away from zero
+// It prints the worst errors and fails if any limit is passed.
+//
+// build: gcc -O2 -I"../Single User Pong Game" -o balltest balltest.c
+//          "../Single User Pong Game/Ball.c" -lm
+// usage: ./balltest
+
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+#include "Ball.h"
+
+#define TICKS 240                       // 2 seconds at TICK_HZ
+#define MIN_SPEED BALL_ONE
+#define MAX_SPEED (3*BALL_ONE)
+#define SPEED_STEP (BALL_ONE/16)
+
+static int Fail;
+
+static void check(int ok, const char *what, int angle, int32_t speed){
+  if(!ok && (Fail < 10)){
+    printf("FAIL: %s, angle %d, speed %d\n", what, angle, speed);
+  }
+  Fail += !ok;
+}
+
+static double radians(int angle){
+  return 2*M_PI*angle/256;
+}
+
+int main(void){
+  Ball_t ball, again;
+  int angle, t, x, y;
+  int32_t speed;
+  double e, sinError = 0, velError = 0, posError = 0, limit, rx, ry;
+  for(angle=0; angle<256; angle++){
+    e = fabs(Ball_Sin(angle) - 16384*sin(radians(angle)));
+    if(e > sinError) sinError = e;
+    e = fabs(Ball_Cos(angle) - 16384*cos(radians(angle)));
+    if(e > sinError) sinError = e;
+  }
+  check(sinError <= 1, "sine table", -1, 0);
+  for(speed=MIN_SPEED; speed<=MAX_SPEED; speed=speed+SPEED_STEP){
+    for(angle=0; angle<256; angle++){
+      x = 10 + angle%100;
+      y = 20 + angle%90;
+      Ball_Launch(&ball, x, y, angle, speed);
+      e = fabs(ball.vx - speed*cos(radians(angle)));
+      if(e > velError) velError = e;
+      e = fabs(ball.vy - speed*sin(radians(angle)));
+      if(e > velError) velError = e;
+      // each tick moves by exactly the velocity, so the position can
+      // only drift by the velocity's rounding, 0.5 plus the table's
+      // 1/16384 of the speed per tick
+      limit = 0.5 + speed/16384.0 + 1e-9;
+      for(t=1; t<=TICKS; t++){
+        Ball_Step(&ball);
+        rx = x*BALL_ONE + t*speed*cos(radians(angle));
+        ry = y*BALL_ONE + t*speed*sin(radians(angle));
+        e = fmax(fabs(ball.x - rx), fabs(ball.y - ry))/t;
+        if(e > posError) posError = e;
+        check(e <= limit, "position drifts", angle, speed);
+      }
+      // bounces
+      Ball_Launch(&ball, x, y, angle, speed);
+      again = ball;
+      Ball_BounceX(&ball);
+      check(ball.vx == -again.vx && ball.vy == again.vy, "BounceX velocity", angle, speed);
+      check(fabs(remainder(radians(ball.angle) - (M_PI - radians(angle)), 2*M_PI)) < 1e-9,
+            "BounceX angle", angle, speed);
+      again = ball;
+      Ball_SetSpeed(&again, speed);
+      check(again.vx == ball.vx && again.vy == ball.vy, "BounceX then SetSpeed", angle, speed);
+      Ball_BounceY(&ball);
+      check(ball.vx == again.vx && ball.vy == -again.vy, "BounceY velocity", angle, speed);
+      check(fabs(remainder(radians(ball.angle) + (M_PI - radians(angle)), 2*M_PI)) < 1e-9,
+            "BounceY angle", angle, speed);
+      again = ball;
+      Ball_SetSpeed(&again, speed);
+      check(again.vx == ball.vx && again.vy == ball.vy, "BounceY then SetSpeed", angle, speed);
+      // speeding up keeps the direction and stops at the maximum
+      Ball_Accelerate(&ball, SPEED_STEP, MAX_SPEED);
+      check(ball.speed == (speed + SPEED_STEP > MAX_SPEED ? MAX_SPEED : speed + SPEED_STEP),
+            "Accelerate", angle, speed);
+    }
+  }
+  check(velError <= 0.5 + MAX_SPEED/16384.0, "velocity", -1, 0);
+  // rounding to pixels, halves away from zero
+  ball.x = 3*BALL_ONE + BALL_ONE/2;     // 3.5
+  ball.y = -(3*BALL_ONE + BALL_ONE/2);  // -3.5
+  check(Ball_PixelX(&ball) == 4 && Ball_PixelY(&ball) == -4, "PixelX/Y halves", -1, 0);
+  ball.x = 3*BALL_ONE + BALL_ONE/2 - 1;
+  ball.y = -(3*BALL_ONE + BALL_ONE/2 - 1);
+  check(Ball_PixelX(&ball) == 3 && Ball_PixelY(&ball) == -3, "PixelX/Y below halves", -1, 0);
+  printf("sine/cosine error %.2f/16384, velocity error %.3f/256 px per tick\n", sinError, velError);
+  printf("position drift over %d ticks: at most %.3f/256 px per tick\n", TICKS, posError);
+  if(Fail){
+    printf("FAIL: %d checks\n", Fail);
+    return 1;
+  }
+  printf("PASS\n");
+  return 0;
+}
@@ -0,0 +1,230 @@
+// color12test.c
+// Runs on a PC (Linux), not on the LaunchPad.
+// Check of 12-bit color mode (ST7735_SetColorMode() in the Single
+// User Pong Game driver) using the SSI/uDMA model in st7735shim.c.
+// Each step makes 1 to 4 random calls (fills, sometimes left
+// streaming, bitmaps, atlas blits, characters and strings, Compose
+// regions, circles, lines and single pixels, of odd and even sizes,
+// often hanging off the screen) in 16-bit mode, then the same calls
+// again in 12-bit mode.  The wire is decoded the way the panel reads
+// it, two pixels in three bytes after COLMOD 0x03, into one screen
+// per mode.  After every step each pixel of the 12-bit screen must
+// be the 16-bit one with its components cut to 4 bits, so pairs
+// carried across windows and rows, lone last pixels, and fills
+// longer than the packed pattern all land where 16-bit mode puts
+// them.  It also prints the bytes each mode sent.
+// It fails on the first different screen, or if the shim finds a
+// handshake error.
+//
+// build: gcc -O1 -no-pie -w -DST7735_SHIM -I. -I"../Single User Pong Game"
+//          -I"../Ball Roll using accelerometer" -o color12test color12test.c
+//          st7735shim.c "../Single User Pong Game/ST7735.c"
+// usage: ./color12test [steps]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "ST7735.h"
+#include "st7735shim.h"
+
+#define ST7735_CASET   0x2A
+#define ST7735_RASET   0x2B
+#define ST7735_RAMWR   0x2C
+#define ST7735_COLMOD  0x3A
+#define SIZE 128                        // screen of the Single User Pong Game driver
+#define MAXIMAGE 48                     // largest bitmap side tried
+
+static uint16_t Screen16[SIZE*SIZE], Screen12[SIZE*SIZE];
+static uint16_t Image16[MAXIMAGE*MAXIMAGE];
+static uint8_t Image8[MAXIMAGE*MAXIMAGE];
+static uint16_t Palette[256];
+static char Text[4][16];
+static Layer_t Layers[4];
+
+// 16-bit color cut to 4 bits per component, as the 12-bit panel
+// stores it.
+static uint16_t color444(uint16_t c){
+  return ((c>>4)&0x0F00)|((c>>3)&0x00F0)|((c>>1)&0x000F);
+}
+
+// Replay the wire since the last Shim_Clear() into the screen of
+// the color mode set by COLMOD.  The window and the mode are kept
+// between calls.
+static void replay(void){
+  static int x0 = 0, x1 = SIZE-1, y0 = 0, x = 0, y = 0, bits = 16;
+  const ShimWire_t *w = &Shim_Wire[SHIM_SSI0];
+  uint32_t i, cmd = 0, arg = 0, acc = 0, nibbles = 0, need;
+  uint8_t a[4];
+  for(i=0; i<w->count; i++){
+    if((w->data[i]&SHIM_DATA) == 0){
+      cmd = w->data[i];
+      arg = 0;
+      if(cmd == ST7735_RAMWR){
+        x = x0;
+        y = y0;
+        acc = nibbles = 0;
+      }
+      continue;
+    }
+    if((cmd == ST7735_CASET) || (cmd == ST7735_RASET)){
+      a[arg++&3] = w->data[i];
+      if(arg == 4){
+        if(cmd == ST7735_CASET){
+          x0 = a[1]; x1 = a[3];
+        } else{
+          y0 = a[1];
+        }
+      }
+    } else if(cmd == ST7735_COLMOD){
+      bits = ((w->data[i]&0x07) == 0x03) ? 12 : 16;
+    } else if(cmd == ST7735_RAMWR){
+      acc = (acc<<8) | (w->data[i]&0xFF);
+      nibbles = nibbles + 2;
+      need = bits/4;
+      if(nibbles < need) continue;
+      nibbles = nibbles - need;         // a pixel is complete
+      if((x < SIZE) && (y < SIZE)){
+        if(bits == 12){
+          Screen12[SIZE*y + x] = (acc>>(4*nibbles))&0x0FFF;
+        } else{
+          Screen16[SIZE*y + x] = acc&0xFFFF;
+        }
+      }
+      acc = acc&((1<<(4*nibbles)) - 1);
+      if(++x > x1){
+        x = x0;
+        y++;
+      }
+    }
+  }
+}
+
+static int rnd(int lo, int hi){
+  return lo + rand()%(hi - lo + 1);
+}
+
+// One random call, the same for the same state of rand().
+static void call(void){
+  Atlas_t atlas;
+  int x = rnd(-30, SIZE + 4), y = rnd(-30, SIZE + 4), w = rnd(0, MAXIMAGE), h = rnd(0, MAXIMAGE);
+  int i, n;
+  uint16_t c = rand();
+  switch(rand()%10){
+  case 0:
+    ST7735_FillRect(rnd(0, SIZE), rnd(0, SIZE), rnd(0, SIZE + 8), rnd(0, SIZE + 8), c);
+    break;
+  case 1:                               // left streaming, maybe past the pattern
+    ST7735_FillRectAsync(rnd(0, SIZE), rnd(0, SIZE), rnd(0, SIZE + 8), rnd(0, SIZE + 8), c, 0);
+    Shim_Work(rnd(0, 20000));
+    break;
+  case 2:
+    ST7735_DrawBitmapAsync(x, y, Image16, w, h, 0);
+    break;
+  case 3:
+    atlas.bpp = (rand()%3 == 0) ? 16 : (rand()%2) ? 8 : 4;
+    atlas.topDown = rand()%2;
+    atlas.w = rnd(1, MAXIMAGE);
+    atlas.h = rnd(1, MAXIMAGE);
+    atlas.image = (atlas.bpp == 16) ? (const void *)Image16 : (const void *)Image8;
+    ST7735_DrawAtlas(x, y, &atlas, Palette, rnd(-4, atlas.w), rnd(-4, atlas.h), w, h);
+    break;
+  case 4:
+    ST7735_DrawChar(x, y, rnd(32, 126), c, rand(), rnd(1, 3));
+    break;
+  case 5:
+    n = rnd(0, 15);
+    for(i=0; i<n; i++) Text[0][i] = rnd(32, 126);
+    Text[0][n] = 0;
+    ST7735_DrawString(rnd(0, 22), rnd(0, 16), Text[0], c);
+    break;
+  case 6:
+    n = rnd(1, 4);
+    for(i=0; i<n; i++){
+      Layers[i].type = (enum layerType)(rand()%3);
+      Layers[i].x = rnd(x - 20, x + w);
+      Layers[i].y = rnd(y - 20, y + h + 20);
+      Layers[i].w = rnd(0, MAXIMAGE);
+      Layers[i].h = rnd(0, MAXIMAGE);
+      Layers[i].color = rand();
+      Layers[i].key = (rand()%2) ? -1 : rand()%4;
+      Layers[i].image = Image16;
+      Layers[i].text = Text[i];
+      Layers[i].size = rnd(1, 2);
+      sprintf(Text[i], "%d", rand());
+    }
+    ST7735_Compose(Layers, n, rand(), x, y, w, h);
+    break;
+  case 7:
+    if(rand()%2){
+      ST7735_FillCircle(x + 15, y + 15, rnd(0, 30), c);
+    } else{
+      ST7735_DrawCircle(x + 15, y + 15, rnd(0, 30), c);
+    }
+    break;
+  case 8:
+    ST7735_DrawLine(x, y, rnd(-30, SIZE + 30), rnd(-30, SIZE + 30), c);
+    break;
+  default:
+    n = rnd(1, 5);                      // odd or even numbers of pixels
+    for(i=0; i<n; i++) ST7735_DrawPixel(rnd(0, SIZE-1), rnd(0, SIZE-1), rand());
+    break;
+  }
+}
+
+// The calls of a step in one color mode.  Returns the bytes sent.
+static uint32_t calls(unsigned seed, int n, uint8_t bits){
+  int i;
+  ST7735_SetColorMode(bits);
+  ST7735_ClearTxCount();
+  srand(seed);
+  for(i=0; i<n; i++) call();
+  ST7735_WaitIdle();
+  Shim_Drain();
+  replay();
+  Shim_Clear();
+  return ST7735_GetTxCount();
+}
+
+int main(int argc, char **argv){
+  long steps = (argc > 1) ? atol(argv[1]) : 20000;
+  long s;
+  uint64_t bytes16 = 0, bytes12 = 0;
+  unsigned seed;
+  int i, n;
+  srand(1);
+  for(i=0; i<MAXIMAGE*MAXIMAGE; i++){
+    Image16[i] = rand();
+    Image8[i] = rand();
+  }
+  for(i=0; i<256; i++) Palette[i] = rand();
+  Shim_Init();
+  ST7735_InitR(INITR_REDTAB);
+  for(n=16; n>=12; n=n-4){
+    ST7735_SetColorMode(n);
+    ST7735_FillScreen(0);
+  }
+  ST7735_WaitIdle();
+  Shim_Drain();
+  replay();
+  Shim_Clear();
+  for(s=0; s<steps; s++){
+    srand(s + 2);
+    seed = rand();
+    n = rnd(1, 4);
+    bytes16 += calls(seed, n, 16);
+    bytes12 += calls(seed, n, 12);
+    for(i=0; i<SIZE*SIZE; i++){
+      if(Screen12[i] != color444(Screen16[i])) break;
+    }
+    if((i < SIZE*SIZE) || Shim_Errors){
+      printf("FAIL: step %ld, pixel (%d,%d) is %03X in 12-bit mode, %04X in 16-bit mode, %u handshake errors\n",
+             s, i%SIZE, i/SIZE, Screen12[i%(SIZE*SIZE)], Screen16[i%(SIZE*SIZE)], Shim_Errors);
+      return 1;
+    }
+  }
+  printf("bytes sent: 16-bit %llu, 12-bit %llu (%.1f%%)\n", (unsigned long long)bytes16,
+         (unsigned long long)bytes12, 100.0*bytes12/bytes16);
+  printf("PASS: %ld steps, the 12-bit screen matched every time\n", steps);
+  return 0;
+}
@@ -0,0 +1,210 @@
+// composetest.c
+// Runs on a PC (Linux), not on the LaunchPad.
+// Random check of the scanline compositor (ST7735_Compose() in the
+// Single User Pong Game driver) using the SSI/uDMA model in
+// st7735shim.c.  The driver is included here so the font can be
+// read.  Each trial composes 1 to 8 random layers (rectangles,
+// bitmaps with or without a key color, text of size 1 to 3 with or
+// without a background) into a random region, often hanging off the
+// screen, with the layers often hanging out of the region.  Regions
+// of every height are tried, so the last band is often short.
+// Calls follow each other without waiting, so a band is composed
+// while the one before is still streaming.  The screen read back
+// from the wire must match painting the layers one at a time, pixel
+// by pixel, clipped to the region, with the rest of the screen
+// unchanged.
+// It fails on the first different screen, or if the shim finds a
+// handshake error.
+//
+// build: gcc -O1 -no-pie -w -DST7735_SHIM -I. -I"../Single User Pong Game"
+//          -I"../Ball Roll using accelerometer" -o composetest composetest.c
+//          st7735shim.c
+// usage: ./composetest [trials]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "ST7735.c"
+
+#define SIZE 128                        // screen of the Single User Pong Game driver
+#define LAYERS 8
+#define MAXBITMAP 40                    // largest bitmap side tried
+
+static uint16_t Screen[SIZE*SIZE], Expect[SIZE*SIZE];
+static uint16_t Image[LAYERS][MAXBITMAP*MAXBITMAP];
+static char Text[LAYERS][12];
+static Layer_t Layers[LAYERS];
+
+// Replay the wire since the last Shim_Clear() into Screen.  The
+// window is kept between calls, since the driver does not resend
+// an address window that is already set.
+static void replay(void){
+  static int x0 = 0, x1 = SIZE-1, y0 = 0, x = 0, y = 0;
+  const ShimWire_t *w = &Shim_Wire[SHIM_SSI0];
+  uint32_t i, cmd = 0, arg = 0;
+  uint8_t a[4];
+  int hi = -1;
+  for(i=0; i<w->count; i++){
+    if((w->data[i]&SHIM_DATA) == 0){
+      cmd = w->data[i];
+      arg = 0;
+      if(cmd == ST7735_RAMWR){
+        x = x0;
+        y = y0;
+        hi = -1;
+      }
+      continue;
+    }
+    if((cmd == ST7735_CASET) || (cmd == ST7735_RASET)){
+      a[arg++&3] = w->data[i];
+      if(arg == 4){
+        if(cmd == ST7735_CASET){
+          x0 = a[1]; x1 = a[3];
+        } else{
+          y0 = a[1];
+        }
+      }
+    } else if(cmd == ST7735_RAMWR){
+      if(hi < 0){
+        hi = w->data[i]&0xFF;
+        continue;
+      }
+      if((x < SIZE) && (y < SIZE)) Screen[SIZE*y + x] = (hi<<8) | (w->data[i]&0xFF);
+      hi = -1;
+      if(++x > x1){
+        x = x0;
+        y++;
+      }
+    }
+  }
+}
+
+// Set pixel (x,y) of Expect if it is in the region.
+static void plot(int x, int y, uint16_t color, int rx, int ry, int rw, int rh){
+  if((x >= rx) && (x < rx + rw) && (y >= ry) && (y < ry + rh) &&
+     (x >= 0) && (x < SIZE) && (y >= 0) && (y < SIZE)) Expect[SIZE*y + x] = color;
+}
+
+// Paint one layer into Expect, clipped to the region.
+static void paint(const Layer_t *ly, int rx, int ry, int rw, int rh){
+  int c, r, k, i, s, t;
+  uint8_t bits;
+  uint16_t v;
+  switch(ly->type){
+  case LAYER_RECT:
+    for(r=0; r<ly->h; r++){
+      for(c=0; c<ly->w; c++) plot(ly->x + c, ly->y + r, ly->color, rx, ry, rw, rh);
+    }
+    break;
+  case LAYER_BITMAP:                    // bottom up, (x,y) bottom left
+    for(r=0; r<ly->h; r++){
+      for(c=0; c<ly->w; c++){
+        v = ly->image[r*ly->w + c];
+        if((ly->key < 0) || (v != ly->key)) plot(ly->x + c, ly->y - r, v, rx, ry, rw, rh);
+      }
+    }
+    break;
+  case LAYER_TEXT:
+    for(k=0; ly->text[k]; k++){
+      for(r=0; r<8; r++){
+        bits = FontRow[((uint8_t)ly->text[k])*8 + r];
+        for(c=0; c<6; c++){
+          for(s=0; s<ly->size; s++){
+            for(t=0; t<ly->size; t++){
+              if((bits>>c)&1){
+                plot(ly->x + (6*k + c)*ly->size + t, ly->y + r*ly->size + s, ly->color, rx, ry, rw, rh);
+              } else if(ly->key >= 0){
+                plot(ly->x + (6*k + c)*ly->size + t, ly->y + r*ly->size + s, ly->key, rx, ry, rw, rh);
+              }
+            }
+          }
+        }
+      }
+    }
+    break;
+  }
+}
+
+static int rnd(int lo, int hi){
+  return lo + rand()%(hi - lo + 1);
+}
+
+// A random layer in entry k, near the region.
+static void newLayer(int k, int rx, int ry, int rw, int rh){
+  Layer_t *ly = &Layers[k];
+  int i, n;
+  ly->x = rnd(rx - MAXBITMAP, rx + rw + 2);
+  ly->y = rnd(ry - MAXBITMAP, ry + rh + MAXBITMAP);
+  ly->w = rnd(0, MAXBITMAP);
+  ly->h = rnd(0, MAXBITMAP);
+  ly->color = rand();
+  ly->key = -1;
+  switch(rand()%3){
+  case 0:
+    ly->type = LAYER_RECT;
+    break;
+  case 1:
+    ly->type = LAYER_BITMAP;
+    for(i=0; i<MAXBITMAP*MAXBITMAP; i++) Image[k][i] = rand()%4;
+    ly->image = Image[k];
+    if(rand()%2) ly->key = rand()%4;
+    break;
+  default:
+    ly->type = LAYER_TEXT;
+    n = rnd(0, 11);
+    for(i=0; i<n; i++) Text[k][i] = rnd(1, 255);
+    Text[k][n] = 0;
+    ly->text = Text[k];
+    ly->size = rnd(1, 3);
+    if(rand()%2) ly->key = rand()&0xFFFF;
+    break;
+  }
+}
+
+int main(int argc, char **argv){
+  long trials = (argc > 1) ? atol(argv[1]) : 20000;
+  long t;
+  uint64_t pixels = 0;
+  int n, k, i, x, y, w, h, bg, cx0, cy0, cx1, cy1;
+  srand(1);
+  Shim_Init();
+  ST7735_InitR(INITR_REDTAB);
+  ST7735_FillScreen(0);
+  ST7735_WaitIdle();
+  Shim_Drain();
+  replay();
+  Shim_Clear();
+  memcpy(Expect, Screen, sizeof(Screen));
+  for(t=0; t<trials; t++){
+    x = rnd(-20, SIZE);
+    y = rnd(-20, SIZE);
+    w = rnd(-1, SIZE + 20);
+    h = rnd(-1, SIZE + 20);
+    bg = rand()&0xFFFF;
+    n = rnd(1, LAYERS);
+    for(k=0; k<n; k++) newLayer(k, x, y, w, h);
+    ST7735_Compose(Layers, n, bg, x, y, w, h);
+    for(i=0; i<w*h; i++) plot(x + i%w, y + i/w, bg, x, y, w, h);
+    for(k=0; k<n; k++) paint(&Layers[k], x, y, w, h);
+    if(t%8 == 7){                       // most calls go on while streaming
+      ST7735_WaitIdle();
+      Shim_Drain();
+      replay();
+      Shim_Clear();
+      if(memcmp(Expect, Screen, sizeof(Screen)) || Shim_Errors){
+        for(i=0; (i<SIZE*SIZE) && (Expect[i] == Screen[i]); i++){}
+        printf("FAIL: trials %ld to %ld, pixel (%d,%d) is %04X not %04X, %u handshake errors\n",
+               t - 7, t, i%SIZE, i/SIZE, Screen[i%(SIZE*SIZE)], Expect[i%(SIZE*SIZE)], Shim_Errors);
+        return 1;
+      }
+    }
+    cx0 = (x < 0) ? 0 : x;              // part of the region on the screen
+    cy0 = (y < 0) ? 0 : y;
+    cx1 = (x + w > SIZE) ? SIZE : x + w;
+    cy1 = (y + h > SIZE) ? SIZE : y + h;
+    if((cx1 > cx0) && (cy1 > cy0)) pixels += (cx1 - cx0)*(cy1 - cy0);
+  }
+  printf("PASS: %ld trials, %llu pixels composed\n", trials, (unsigned long long)pixels);
+  return 0;
+}
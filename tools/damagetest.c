@@ -0,0 +1,238 @@
+// damagetest.c
+// Runs on a PC (Linux), not on the LaunchPad.
+// Random check of the damage list (ST7735_Damage() and ST7735_Flush()
+// in the Single User Pong Game driver) using the SSI/uDMA model in
+// st7735shim.c.  Each trial marks 1 to 20 random rectangles, often
+// hanging off the screen, entirely off it, or empty, then flushes.
+// The wire is read back into a count of how many times each pixel
+// was erased, and:
+//  - every damaged pixel on the screen is erased, and no pixel twice
+//  - there are at most 8 windows (the size of the list), and each is
+//    the bounding box of damage: every edge of it has a damaged pixel
+//  - rectangles that are apart from each other (a pixel or more
+//    between them) and fit in the list are erased exactly
+//  - when a ninth apart 1x1 rectangle overflows a list of eight, it
+//    is merged with the one whose bounding box is smallest
+// It fails on the first wrong flush, or if the shim finds a
+// handshake error.
+//
+// build: gcc -O1 -no-pie -w -DST7735_SHIM -I. -I"../Single User Pong Game"
+//          -I"../Ball Roll using accelerometer" -o damagetest damagetest.c
+//          st7735shim.c "../Single User Pong Game/ST7735.c"
+// usage: ./damagetest [trials]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "ST7735.h"
+#include "st7735shim.h"
+
+#define ST7735_CASET   0x2A
+#define ST7735_RASET   0x2B
+#define ST7735_RAMWR   0x2C
+#define SIZE 128                        // screen of the Single User Pong Game driver
+#define DAMAGE_MAX 8                    // as the driver
+#define RECTS 20                        // most rectangles in a trial
+
+static uint8_t Count[SIZE*SIZE];        // erases of each pixel
+static uint8_t Ref[SIZE*SIZE];          // 1 if the pixel was damaged
+static int WinX0[64], WinY0[64], WinX1[64], WinY1[64];
+static uint32_t Windows;
+
+// Replay the wire since the last Shim_Clear() into Count, and list
+// the windows.  The window is kept between calls, since the driver
+// does not resend an address window that is already set.
+static void replay(void){
+  static int x0 = 0, x1 = SIZE-1, y0 = 0, y1 = SIZE-1, x = 0, y = 0;
+  const ShimWire_t *w = &Shim_Wire[SHIM_SSI0];
+  uint32_t i, cmd = 0, arg = 0;
+  uint8_t a[4];
+  int hi = -1;
+  for(i=0; i<w->count; i++){
+    if((w->data[i]&SHIM_DATA) == 0){
+      cmd = w->data[i];
+      arg = 0;
+      if(cmd == ST7735_RAMWR){
+        if(Windows < 64){
+          WinX0[Windows] = x0; WinY0[Windows] = y0;
+          WinX1[Windows] = x1; WinY1[Windows] = y1;
+        }
+        Windows++;
+        x = x0;
+        y = y0;
+        hi = -1;
+      }
+      continue;
+    }
+    if((cmd == ST7735_CASET) || (cmd == ST7735_RASET)){
+      a[arg++&3] = w->data[i];
+      if(arg == 4){
+        if(cmd == ST7735_CASET){
+          x0 = a[1]; x1 = a[3];
+        } else{
+          y0 = a[1]; y1 = a[3];
+        }
+      }
+    } else if(cmd == ST7735_RAMWR){
+      if(hi < 0){
+        hi = w->data[i]&0xFF;
+        continue;
+      }
+      if((x < SIZE) && (y < SIZE)) Count[SIZE*y + x]++;
+      hi = -1;
+      if(++x > x1){
+        x = x0;
+        y++;
+      }
+    }
+  }
+}
+
+static int rnd(int lo, int hi){
+  return lo + rand()%(hi - lo + 1);
+}
+
+// Mark a rectangle in the driver and in Ref.
+static void damage(int x, int y, int w, int h){
+  int i, j;
+  ST7735_Damage(x, y, w, h);
+  for(j=y; j<y+h; j++){
+    for(i=x; i<x+w; i++){
+      if((i >= 0) && (i < SIZE) && (j >= 0) && (j < SIZE)) Ref[SIZE*j + i] = 1;
+    }
+  }
+}
+
+static void flush(void){
+  memset(Count, 0, sizeof(Count));
+  Windows = 0;
+  Shim_Clear();
+  ST7735_Flush(ST7735_BLACK);
+  Shim_Drain();
+  replay();
+}
+
+// 1 if rectangles a and b (x0,y0,x1,y1) overlap or touch.
+static int touch(const int *a, const int *b){
+  return (a[0] <= b[2] + 1) && (b[0] <= a[2] + 1) && (a[1] <= b[3] + 1) && (b[1] <= a[3] + 1);
+}
+
+// Check the flush against Ref; exact if the damage was only
+// rectangles apart from each other.  Returns 0 if right.
+static int check(int exact){
+  uint32_t k;
+  int i, x, y, edges;
+  for(i=0; i<SIZE*SIZE; i++){
+    if((Ref[i] && !Count[i]) || (Count[i] > 1) || (exact && (Count[i] != Ref[i]))) return 1;
+  }
+  if(Windows > DAMAGE_MAX) return 1;
+  for(k=0; k<Windows; k++){
+    edges = 0;
+    for(x=WinX0[k]; x<=WinX1[k]; x++){
+      if(Ref[SIZE*WinY0[k] + x]) edges |= 1;
+      if(Ref[SIZE*WinY1[k] + x]) edges |= 2;
+    }
+    for(y=WinY0[k]; y<=WinY1[k]; y++){
+      if(Ref[SIZE*y + WinX0[k]]) edges |= 4;
+      if(Ref[SIZE*y + WinX1[k]]) edges |= 8;
+    }
+    if(edges != 15) return 1;
+  }
+  return 0;
+}
+
+// Eight 1x1 rectangles apart from each other, then a ninth.  Returns
+// 0 if right, or if the merge would touch another entry (not judged).
+static int overflow(long *judged){
+  int r[DAMAGE_MAX + 1][4], i, j, k = 0, best = 0x7FFFFFFF, area, merged[4], expect, total;
+  for(i=0; i<=DAMAGE_MAX; i++){
+    do{
+      r[i][0] = r[i][2] = rnd(0, SIZE-1);
+      r[i][1] = r[i][3] = rnd(0, SIZE-1);
+      for(j=0; (j<i) && !touch(r[i], r[j]); j++){}
+    } while(j < i);
+  }
+  for(i=0; i<DAMAGE_MAX; i++){          // smallest box with the ninth
+    area = (abs(r[i][0] - r[DAMAGE_MAX][0]) + 1)*(abs(r[i][1] - r[DAMAGE_MAX][1]) + 1);
+    if(area < best){
+      best = area;
+      k = i;
+    }
+  }
+  merged[0] = (r[k][0] < r[DAMAGE_MAX][0]) ? r[k][0] : r[DAMAGE_MAX][0];
+  merged[1] = (r[k][1] < r[DAMAGE_MAX][1]) ? r[k][1] : r[DAMAGE_MAX][1];
+  merged[2] = (r[k][0] > r[DAMAGE_MAX][0]) ? r[k][0] : r[DAMAGE_MAX][0];
+  merged[3] = (r[k][1] > r[DAMAGE_MAX][1]) ? r[k][1] : r[DAMAGE_MAX][1];
+  for(i=0; i<DAMAGE_MAX; i++){
+    if((i != k) && touch(merged, r[i])) return 0;
+  }
+  memset(Ref, 0, sizeof(Ref));
+  for(i=0; i<=DAMAGE_MAX; i++) damage(r[i][0], r[i][1], 1, 1);
+  flush();
+  for(i=total=0; i<SIZE*SIZE; i++) total += Count[i];
+  expect = (DAMAGE_MAX - 1) + best;
+  (*judged)++;
+  if(total != expect){
+    printf("FAIL: overflow erased %d pixels, the smallest merge erases %d\n", total, expect);
+    return 1;
+  }
+  return check(0);
+}
+
+int main(int argc, char **argv){
+  long trials = (argc > 1) ? atol(argv[1]) : 20000;
+  long t, exact = 0, judged = 0, windows = 0;
+  int n, i, j, r[RECTS][4], apart;
+  srand(1);
+  Shim_Init();
+  ST7735_InitR(INITR_REDTAB);
+  ST7735_Flush(ST7735_BLACK);           // empty list
+  Shim_Drain();
+  replay();
+  for(t=0; t<trials; t++){
+    if(t%4 == 3){
+      if(overflow(&judged)){
+        printf("FAIL: trial %ld, overflow\n", t);
+        return 1;
+      }
+      continue;
+    }
+    memset(Ref, 0, sizeof(Ref));
+    n = rnd(1, RECTS);
+    apart = (n <= DAMAGE_MAX);
+    for(i=0; i<n; i++){
+      if(rand()%4){                     // small, like a sprite
+        r[i][0] = rnd(-10, SIZE + 2);
+        r[i][1] = rnd(-10, SIZE + 2);
+        r[i][2] = rnd(-1, 12);
+        r[i][3] = rnd(-1, 12);
+      } else{
+        r[i][0] = rnd(-SIZE/2, SIZE + 2);
+        r[i][1] = rnd(-SIZE/2, SIZE + 2);
+        r[i][2] = rnd(-1, SIZE);
+        r[i][3] = rnd(-1, SIZE);
+      }
+      damage(r[i][0], r[i][1], r[i][2], r[i][3]);
+      for(j=0; j<i; j++){               // apart from the others, on the screen
+        int a[4] = {r[i][0], r[i][1], r[i][0] + r[i][2] - 1, r[i][1] + r[i][3] - 1};
+        int b[4] = {r[j][0], r[j][1], r[j][0] + r[j][2] - 1, r[j][1] + r[j][3] - 1};
+        if(touch(a, b)) apart = 0;
+      }
+      if((r[i][0] < 0) || (r[i][1] < 0) || (r[i][2] <= 0) || (r[i][3] <= 0) ||
+         (r[i][0] + r[i][2] > SIZE) || (r[i][1] + r[i][3] > SIZE)) apart = 0;
+    }
+    flush();
+    exact += apart;
+    windows += Windows;
+    if(check(apart) || Shim_Errors){
+      printf("FAIL: trial %ld, %d rectangles, %u windows, %u handshake errors\n",
+             t, n, Windows, Shim_Errors);
+      for(i=0; i<n; i++) printf("  %d %d %d %d\n", r[i][0], r[i][1], r[i][2], r[i][3]);
+      return 1;
+    }
+  }
+  printf("PASS: %ld trials, %ld windows, %ld judged exactly, %ld overflows judged\n",
+         trials, windows, exact, judged);
+  return 0;
+}
@@ -0,0 +1,141 @@
+// dmabench.c
+// Runs on a PC (Linux), not on the LaunchPad.
+// How long the CPU is held by the LCD for a few typical frames,
+// using the SSI/uDMA model in st7735shim.c (80 MHz bus, SSI0 at
+// 8 Mbps as set by the driver).  For each frame it prints:
+//   bytes   bytes sent to the panel
+//   wire    bus cycles from the first call until the last byte is out
+//   polled  CPU cycles held if every byte went through writedata(),
+//           one FIFO write and status poll per byte, as the driver
+//           did before the uDMA engine
+//   block   CPU cycles held by the blocking calls (start the uDMA
+//           and wait for it)
+//   async   CPU cycles held by the Async calls when the CPU has
+//           200000 cycles (2.5 ms) of game logic to run meanwhile
+//   cpu/dma FIFO writes by the CPU and items moved by the uDMA
+// It fails if the shim finds a handshake error.
+//
+// build: gcc -O1 -no-pie -w -DST7735_SHIM -I. -I"../Single User Pong Game"
+//          -I"../Ball Roll using accelerometer" -o dmabench dmabench.c
+//          st7735shim.c "../Single User Pong Game/ST7735.c"
+// usage: ./dmabench
+
+#include <stdio.h>
+#include <stdint.h>
+#include "ST7735.h"
+#include "st7735shim.h"
+
+#define WORK 200000                     // game logic per frame, bus cycles
+#define SSI0_BASE 0x40008000
+
+static uint16_t Image[128*128];         // stands for a full screen bitmap
+static uint16_t Paddle[2*16];
+
+typedef struct{
+  uint64_t wire, wait;
+  uint32_t bytes, cpu, dma;
+} Result_t;
+
+// Draw one frame: 0 fill, 1 bitmap, 2 Pong (ball erase and draw,
+// paddle, score box).  async 1 uses the Async calls where there are.
+static void frame(int which, int async){
+  int i;
+  switch(which){
+  case 0:
+    if(async){
+      ST7735_FillRectAsync(0, 0, 128, 128, ST7735_BLUE, 0);
+    } else{
+      ST7735_FillScreen(ST7735_BLUE);
+    }
+    break;
+  case 1:
+    if(async){
+      ST7735_DrawBitmapAsync(0, 127, Image, 128, 128, 0);
+    } else{
+      ST7735_DrawBitmap(0, 127, Image, 128, 128);
+    }
+    break;
+  default:
+    for(i=0; i<8; i++){
+      ST7735_FillRect(10 + 12*i, 20 + 9*i, 5, 5, ST7735_WHITE);
+      ST7735_FillRect(12 + 12*i, 21 + 9*i, 5, 5, ST7735_BLACK);
+    }
+    ST7735_DrawBitmap(5, 80, Paddle, 2, 16);
+    if(async){
+      ST7735_FillRectAsync(40, 0, 48, 10, ST7735_BLACK, 0);
+    } else{
+      ST7735_FillRect(40, 0, 48, 10, ST7735_BLACK);
+    }
+    break;
+  }
+}
+
+static Result_t measure(int which, int async){
+  Result_t r;
+  uint64_t start;
+  ST7735_WaitIdle();
+  Shim_Drain();
+  Shim_Clear();
+  start = Shim_Cycles;
+  frame(which, async);
+  if(async){
+    Shim_Work(WORK);                    // the game runs while pixels stream
+  }
+  ST7735_WaitIdle();
+  r.wait = Shim_WaitCycles;
+  Shim_Drain();                         // only to time the wire
+  r.wire = Shim_Cycles - start;
+  if(async){
+    r.wire = (r.wire > WORK) ? r.wire : WORK;
+  }
+  r.bytes = Shim_Wire[SHIM_SSI0].count;
+  r.cpu = Shim_CPUWrites;
+  r.dma = Shim_DMAItems;
+  return r;
+}
+
+// The same bytes written by the CPU, one 8-bit frame at a time,
+// waiting for room in the FIFO before each.
+static uint64_t polled(uint32_t bytes){
+  uint32_t i;
+  ST7735_WaitIdle();
+  Shim_Drain();
+  Shim_Clear();
+  for(i=0; i<bytes; i++){
+    while((*(volatile uint32_t *)(SSI0_BASE + 0x0C)&0x02) == 0){
+      Shim_Poll();
+    }
+    Shim_SSIWrite(SSI0_BASE, 0);
+  }
+  Shim_Drain();
+  return Shim_WaitCycles;
+}
+
+int main(void){
+  static const char *names[3] = {"fill 128x128", "bitmap 128x128", "pong frame"};
+  Result_t b, a;
+  uint64_t p;
+  uint32_t errors = 0;
+  int i;
+  for(i=0; i<128*128; i++) Image[i] = i*37;
+  for(i=0; i<2*16; i++) Paddle[i] = ST7735_BLACK;
+  Shim_Init();
+  ST7735_InitR(INITR_REDTAB);
+  printf("%-15s %6s %9s %9s %9s %9s %6s %6s\n",
+         "frame", "bytes", "wire", "polled", "block", "async", "cpu", "dma");
+  for(i=0; i<3; i++){
+    b = measure(i, 0);
+    errors += Shim_Errors;
+    a = measure(i, 1);
+    errors += Shim_Errors;
+    p = polled(b.bytes);
+    printf("%-15s %6u %9llu %9llu %9llu %9llu %6u %6u\n", names[i], b.bytes,
+           (unsigned long long)b.wire, (unsigned long long)p,
+           (unsigned long long)b.wait, (unsigned long long)a.wait, b.cpu, b.dma);
+  }
+  if(errors){
+    printf("%u handshake errors\n", errors);
+    return 1;
+  }
+  return 0;
+}
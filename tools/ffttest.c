@@ -0,0 +1,181 @@
+// ffttest.c
+// Runs on a PC (Linux), not on the LaunchPad.
+// Accuracy and speed check of the Q15 FFT in fft.c.
+// For every size from 4 to FFT_MAXN, three kinds of input (a full
+// scale sine, half scale noise and an impulse) go through FFT_Q15()
+// and through a double precision DFT of the same Q15 numbers, scaled
+// by 1/n as fft.h promises.  It prints the worst difference of any
+// real or imaginary part in LSB, and the time per transform in host
+// TSC cycles, next to a plain radix-2 Q15 transform with the same
+// scaling as a baseline.  The host cycles are only a comparison
+// between the two kernels; they are not Cortex-M4 cycles.
+// It also loads a full scale sine with FFT_LoadADC() and prints the
+// Hann window peak from FFT_Magnitude(), which should be about 8192.
+// It fails if any error is larger than MAXERROR.
+//
+// build: gcc -O2 -I"../Ball Roll using accelerometer" -o ffttest ffttest.c
+//          "../Ball Roll using accelerometer/fft.c" -lm
+// usage: ./ffttest
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include "fft.h"
+#ifdef __x86_64__
+#include <x86intrin.h>
+#define CYCLES() __rdtsc()
+#else
+#include <time.h>
+#define CYCLES() ((uint64_t)clock())
+#endif
+
+#define MAXERROR 16                     // LSB
+#define REPEAT 2000                     // transforms timed per size
+
+static int16_t Input[2*FFT_MAXN];
+static int16_t X[2*FFT_MAXN];
+static double Ref[2*FFT_MAXN];
+
+// X[k]/n of Input, in double precision.
+static void dft(uint32_t n){
+  uint32_t j, k;
+  double re, im, a;
+  for(k=0; k<n; k++){
+    re = 0;
+    im = 0;
+    for(j=0; j<n; j++){
+      a = -2*M_PI*(double)((j*k)%n)/n;
+      re += Input[2*j]*cos(a) - Input[2*j+1]*sin(a);
+      im += Input[2*j]*sin(a) + Input[2*j+1]*cos(a);
+    }
+    Ref[2*k] = re/n;
+    Ref[2*k+1] = im/n;
+  }
+}
+
+// Baseline: radix-2 decimation in time, halving at every stage,
+// twiddles computed with the same Q15 rounding as fft.c.
+static int16_t Cos2[FFT_MAXN/2], Sin2[FFT_MAXN/2];
+static void radix2(int16_t *x, uint32_t n){
+  uint32_t i, j, k, m, bit, t;
+  int32_t c, s, tr, ti, ur, ui;
+  int16_t v;
+  j = 0;
+  for(i=0; i<n-1; i++){
+    if(i < j){
+      v = x[2*i];   x[2*i] = x[2*j];     x[2*j] = v;
+      v = x[2*i+1]; x[2*i+1] = x[2*j+1]; x[2*j+1] = v;
+    }
+    bit = n>>1;
+    while(j & bit){
+      j = j^bit;
+      bit = bit>>1;
+    }
+    j = j|bit;
+  }
+  for(m=1; m<n; m=m*2){
+    for(j=0; j<m; j++){
+      t = j*(FFT_MAXN/2)/m;
+      c = Cos2[t];
+      s = Sin2[t];
+      for(k=j; k<n; k=k+2*m){
+        tr = (x[2*(k+m)]*c + x[2*(k+m)+1]*s)>>15;
+        ti = (x[2*(k+m)+1]*c - x[2*(k+m)]*s)>>15;
+        ur = x[2*k];
+        ui = x[2*k+1];
+        x[2*k] = (ur + tr)>>1;       x[2*k+1] = (ui + ti)>>1;
+        x[2*(k+m)] = (ur - tr)>>1;   x[2*(k+m)+1] = (ui - ti)>>1;
+      }
+    }
+  }
+}
+
+static double worst(uint32_t n){
+  uint32_t i;
+  double e, max = 0;
+  for(i=0; i<2*n; i++){
+    e = fabs(X[i] - Ref[i]);
+    if(e > max) max = e;
+  }
+  return max;
+}
+
+static uint64_t timed(uint32_t n, int baseline){
+  uint64_t start, best = ~0ULL, t;
+  uint32_t r, i;
+  for(r=0; r<REPEAT; r++){
+    for(i=0; i<2*n; i++) X[i] = Input[i];
+    start = CYCLES();
+    if(baseline){
+      radix2(X, n);
+    } else{
+      FFT_Q15(X, n);
+    }
+    t = CYCLES() - start;
+    if(t < best) best = t;
+  }
+  return best;
+}
+
+int main(void){
+  static const char *kinds[3] = {"sine", "noise", "impulse"};
+  static uint16_t adc[FFT_MAXN], mag[FFT_MAXN/2];
+  uint32_t n, i, kind, peak;
+  double e;
+  int fail = 0;
+  for(i=0; i<FFT_MAXN/2; i++){
+    Cos2[i] = (int16_t)lround(32767*cos(2*M_PI*i/FFT_MAXN));
+    Sin2[i] = (int16_t)lround(32767*sin(2*M_PI*i/FFT_MAXN));
+  }
+  srand(1);
+  printf("%5s %8s %8s %8s %12s %12s\n", "n", "sine", "noise", "impulse", "radix-4/2", "radix-2");
+  for(n=4; n<=FFT_MAXN; n=n*2){
+    printf("%5u", n);
+    for(kind=0; kind<3; kind++){
+      for(i=0; i<n; i++){
+        switch(kind){
+        case 0:
+          Input[2*i] = (int16_t)lround(32767*cos(2*M_PI*(n/4 - 1)*i/n));
+          Input[2*i+1] = (int16_t)lround(32767*sin(2*M_PI*(n/4 - 1)*i/n));
+          break;
+        case 1:
+          Input[2*i] = rand()%32768 - 16384;
+          Input[2*i+1] = rand()%32768 - 16384;
+          break;
+        default:
+          Input[2*i] = (i == 1) ? 32767 : 0;
+          Input[2*i+1] = 0;
+          break;
+        }
+      }
+      dft(n);
+      for(i=0; i<2*n; i++) X[i] = Input[i];
+      FFT_Q15(X, n);
+      e = worst(n);
+      if(e > MAXERROR){
+        printf("\nFAIL: %s, n %u, error %.1f LSB\n", kinds[kind], n, e);
+        fail = 1;
+      }
+      printf(" %8.1f", e);
+    }
+    printf(" %12llu %12llu\n", (unsigned long long)timed(n, 0), (unsigned long long)timed(n, 1));
+  }
+  for(i=0; i<256; i++){
+    adc[i] = 2048 + (int)lround(2047*sin(2*M_PI*20*i/256));
+  }
+  FFT_LoadADC(X, adc, 256);
+  FFT_Q15(X, 256);
+  FFT_Magnitude(X, mag, 256);
+  peak = 0;
+  for(i=0; i<128; i++){
+    if(mag[i] > mag[peak]) peak = i;
+  }
+  printf("errors in LSB, times in host TSC cycles per transform (best of %u)\n", REPEAT);
+  printf("full scale sine in bin 20 of 256: peak %u in bin %u\n", mag[peak], peak);
+  if(fail || (peak != 20)){
+    return 1;
+  }
+  printf("PASS\n");
+  return 0;
+}
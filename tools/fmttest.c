@@ -0,0 +1,92 @@
+// fmttest.c
+// Runs on a PC (Linux), not on the LaunchPad.
+// Check of the number formatting in the Single User Pong Game
+// driver, which is included here so its static functions can be
+// called.  It checks that the reciprocal multiply udecFormat() uses
+// for n/100 is exact for all 2^32 inputs, then compares
+// udecFormat() and fixFormat() with sprintf() on 3M values: every
+// power of ten and its neighbors, the ends of the ranges, and
+// random numbers of every length, with 0 to 9 decimals.
+// It fails on the first difference.
+//
+// build: gcc -O1 -no-pie -w -DST7735_SHIM -I. -I"../Single User Pong Game"
+//          -I"../Ball Roll using accelerometer" -o fmttest fmttest.c
+//          st7735shim.c
+// usage: ./fmttest
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "ST7735.c"
+
+#define VALUES 3000000
+
+static uint32_t random32(void){
+  uint32_t n = ((uint32_t)rand()<<16) ^ (uint32_t)rand();
+  return n >> (rand()%32);              // every number of digits
+}
+
+// fixFormat() as sprintf() would write it.
+static void fixRef(char *buf, int32_t n, uint8_t decimals){
+  uint32_t u = (n < 0) ? -(uint32_t)n : (uint32_t)n;
+  uint32_t p = 1, i;
+  for(i=0; i<decimals; i++) p = p*10;
+  if(decimals){
+    sprintf(buf, "%s%u.%0*u", (n < 0) ? "-" : "", u/p, decimals, u%p);
+  } else{
+    sprintf(buf, "%s%u", (n < 0) ? "-" : "", u);
+  }
+}
+
+static int check(uint32_t n, uint8_t decimals){
+  char got[16], want[16];
+  uint32_t len;
+  len = udecFormat(got, n);
+  got[len] = 0;
+  sprintf(want, "%u", n);
+  if(strcmp(got, want)){
+    printf("FAIL: udecFormat(%u) gave \"%s\"\n", n, got);
+    return 1;
+  }
+  len = fixFormat(got, (int32_t)n, decimals);
+  got[len] = 0;
+  fixRef(want, (int32_t)n, decimals);
+  if(strcmp(got, want) || (len > 12)){
+    printf("FAIL: fixFormat(%d, %u) gave \"%s\", not \"%s\"\n", (int32_t)n, decimals, got, want);
+    return 1;
+  }
+  return 0;
+}
+
+int main(void){
+  uint64_t n;
+  uint32_t i, p, count = 0;
+  int d, k;
+  for(n=0; n<=0xFFFFFFFF; n++){
+    if((uint32_t)((n*0x51EB851F)>>37) != (uint32_t)n/100){
+      printf("FAIL: reciprocal quotient of %llu\n", (unsigned long long)n);
+      return 1;
+    }
+  }
+  printf("reciprocal n/100 exact for all 2^32 n\n");
+  for(p=1, i=0; i<10; i++, p=p*10){
+    for(d=-2; d<=2; d++){
+      for(k=0; k<10; k++){
+        if(check(p + d, k) || check(-(int32_t)(p + d), k)) return 1;
+        count = count + 2;
+      }
+    }
+  }
+  for(k=0; k<10; k++){
+    if(check(0, k) || check(0xFFFFFFFF, k) || check(0x7FFFFFFF, k) || check(0x80000000, k)) return 1;
+    count = count + 4;
+  }
+  srand(1);
+  while(count < VALUES){
+    if(check(random32(), rand()%10) || check(-random32(), rand()%10)) return 1;
+    count = count + 2;
+  }
+  printf("PASS: udecFormat and fixFormat match sprintf on %u values\n", count);
+  return 0;
+}
@@ -0,0 +1,237 @@
+// hudtest.c
+// Runs on a PC (Linux), not on the LaunchPad.
+// Check of the heads-up display fields (ST7735_HudUDec() and
+// ST7735_HudFix() in the Single User Pong Game driver) using the
+// SSI/uDMA model in st7735shim.c.  The driver is included here so
+// the font can be read.  Each run puts a field of random place,
+// width, size and colors on a filled screen and shows 200 random
+// numbers in it: counters going up by one, repeats, numbers of every
+// length, often shorter than the last one, and numbers too long for
+// the field, with 0 to 3 decimals.  After each call the screen read
+// back from the wire must show the number as sprintf() writes it,
+// right aligned, or all '*'s if it does not fit, with the cells left
+// of it cleared and the rest of the screen unchanged.  The wire must
+// carry exactly one window per run of cells that changed, and
+// nothing if no cell did.
+// It fails on the first wrong screen or window, or if the shim finds
+// a handshake error.
+//
+// build: gcc -O1 -no-pie -w -DST7735_SHIM -I. -I"../Single User Pong Game"
+//          -I"../Ball Roll using accelerometer" -o hudtest hudtest.c
+//          st7735shim.c
+// usage: ./hudtest [runs]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "ST7735.c"
+
+#define SIZE 128                        // screen of the Single User Pong Game driver
+#define CALLS 200                       // numbers shown in each run
+
+static uint16_t Screen[SIZE*SIZE], Expect[SIZE*SIZE];
+static int WinX0[16], WinY0[16], WinX1[16], WinY1[16];
+static uint32_t Windows;
+
+// Replay the wire since the last Shim_Clear() into Screen, and list
+// the windows.  The window is kept between calls, since the driver
+// does not resend an address window that is already set.
+static void replay(void){
+  static int x0 = 0, x1 = SIZE-1, y0 = 0, y1 = SIZE-1, x = 0, y = 0;
+  const ShimWire_t *w = &Shim_Wire[SHIM_SSI0];
+  uint32_t i, cmd = 0, arg = 0;
+  uint8_t a[4];
+  int hi = -1;
+  for(i=0; i<w->count; i++){
+    if((w->data[i]&SHIM_DATA) == 0){
+      cmd = w->data[i];
+      arg = 0;
+      if(cmd == ST7735_RAMWR){
+        if(Windows < 16){
+          WinX0[Windows] = x0; WinY0[Windows] = y0;
+          WinX1[Windows] = x1; WinY1[Windows] = y1;
+        }
+        Windows++;
+        x = x0;
+        y = y0;
+        hi = -1;
+      }
+      continue;
+    }
+    if((cmd == ST7735_CASET) || (cmd == ST7735_RASET)){
+      a[arg++&3] = w->data[i];
+      if(arg == 4){
+        if(cmd == ST7735_CASET){
+          x0 = a[1]; x1 = a[3];
+        } else{
+          y0 = a[1]; y1 = a[3];
+        }
+      }
+    } else if(cmd == ST7735_RAMWR){
+      if(hi < 0){
+        hi = w->data[i]&0xFF;
+        continue;
+      }
+      if((x < SIZE) && (y < SIZE)) Screen[SIZE*y + x] = (hi<<8) | (w->data[i]&0xFF);
+      hi = -1;
+      if(++x > x1){
+        x = x0;
+        y++;
+      }
+    }
+  }
+}
+
+static int rnd(int lo, int hi){
+  return lo + rand()%(hi - lo + 1);
+}
+
+// A random number of 1 to 10 digits.
+static uint32_t random32(void){
+  uint32_t n = ((uint32_t)rand()<<16) ^ (uint32_t)rand();
+  return n >> (rand()%32);
+}
+
+// Paint character k of a field into Expect.
+static void paintCell(const HudNumber_t *h, int k, char ch){
+  int r, c, s, t;
+  uint8_t bits;
+  for(r=0; r<8; r++){
+    bits = FontRow[((uint8_t)ch)*8 + r];
+    for(c=0; c<6; c++){
+      for(s=0; s<h->size; s++){
+        for(t=0; t<h->size; t++){
+          Expect[SIZE*(h->y + r*h->size + s) + h->x + (6*k + c)*h->size + t] =
+            ((bits>>c)&1) ? h->color : h->bgColor;
+        }
+      }
+    }
+  }
+}
+
+// Show one random number, unsigned or fixed point, in the field and
+// put the cells it should show in cell.
+static void show(HudNumber_t *h, char *cell, uint32_t *last){
+  char text[24];
+  uint32_t len, c, n, u, p;
+  int32_t f;
+  uint8_t decimals;
+  switch(rand()%4){
+  case 0: n = *last + 1; break;         // a counter
+  case 1: n = *last; break;             // unchanged
+  case 2: n = *last/rnd(2, 1000); break; // shorter
+  default: n = random32(); break;
+  }
+  *last = n;
+  if(rand()%2){
+    ST7735_HudUDec(h, n);
+    sprintf(text, "%u", n);
+  } else{
+    f = (rand()%4) ? (int32_t)n : -(int32_t)(n&0x7FFFFFFF);
+    decimals = rnd(0, 3);
+    ST7735_HudFix(h, f, decimals);
+    u = (f < 0) ? -(uint32_t)f : (uint32_t)f;
+    for(p=1, c=0; c<decimals; c++) p = p*10;
+    if(decimals){
+      sprintf(text, "%s%u.%0*u", (f < 0) ? "-" : "", u/p, decimals&3, u%p); // &3 bounds the width for -Wall
+    } else{
+      sprintf(text, "%s%u", (f < 0) ? "-" : "", u);
+    }
+  }
+  len = strlen(text);
+  for(c=0; c<h->width; c++){
+    if(len > h->width) cell[c] = '*';
+    else cell[c] = (c < h->width - len) ? ' ' : text[c - (h->width - len)];
+  }
+}
+
+// Check the screen and the windows of the last call, given the cells
+// shown before it.  Returns 0 if right.
+static int check(const HudNumber_t *h, const char *was, const char *cell){
+  uint32_t c, n, k = 0;
+  for(c=0; c<h->width; c++) paintCell(h, c, cell[c]);
+  if(memcmp(Screen, Expect, sizeof(Screen))){
+    for(c=0; Screen[c] == Expect[c]; c++){}
+    printf("pixel (%u,%u) is %04X not %04X\n", c%SIZE, c/SIZE, Screen[c], Expect[c]);
+    return 1;
+  }
+  c = 0;
+  while(c < h->width){                  // one window per run of changed cells
+    if(cell[c] == was[c]){
+      c++;
+      continue;
+    }
+    for(n=0; (c + n < h->width) && (cell[c + n] != was[c + n]); n++){}
+    if((k >= Windows) || (WinX0[k] != h->x + 6*h->size*c) || (WinX1[k] != h->x + 6*h->size*(c + n) - 1) ||
+       (WinY0[k] != h->y) || (WinY1[k] != h->y + 8*h->size - 1)){
+      printf("window %u is not cells %u to %u\n", k, c, c + n - 1);
+      return 1;
+    }
+    k++;
+    c = c + n;
+  }
+  if(k != Windows){
+    printf("%u windows for %u runs of changed cells\n", Windows, k);
+    return 1;
+  }
+  if((k == 0) && Shim_Wire[SHIM_SSI0].count){
+    printf("%u bytes sent with no cell changed\n", Shim_Wire[SHIM_SSI0].count);
+    return 1;
+  }
+  return 0;
+}
+
+int main(int argc, char **argv){
+  long runs = (argc > 1) ? atol(argv[1]) : 2000;
+  long r, calls = 0, shrinks = 0, idle = 0;
+  HudNumber_t h;
+  char was[12], cell[12];
+  uint32_t last, i, c, len, wasLen;
+  uint16_t color, bg;
+  uint8_t width, size;
+  srand(1);
+  Shim_Init();
+  ST7735_InitR(INITR_REDTAB);
+  for(r=0; r<runs; r++){
+    bg = rand();
+    ST7735_FillScreen(bg);
+    for(i=0; i<SIZE*SIZE; i++) Expect[i] = bg;
+    size = (rand()%4) ? 1 : 2;
+    width = rnd(1, (size == 1) ? 12 : 10);
+    color = rand();
+    do{
+      bg = (rand()%2) ? bg : rand();    // often the screen color
+    } while(bg == color);
+    ST7735_HudInit(&h, rnd(0, SIZE - 6*size*width), rnd(0, SIZE - 8*size), width, size, color, bg);
+    ST7735_WaitIdle();
+    Shim_Drain();
+    replay();
+    Shim_Clear();
+    memset(was, 0, sizeof(was));        // nothing shown yet
+    last = random32();
+    for(i=0; i<CALLS; i++){
+      Windows = 0;
+      show(&h, cell, &last);
+      ST7735_WaitIdle();
+      Shim_Drain();
+      replay();
+      if(check(&h, was, cell) || Shim_Errors){
+        printf("FAIL: run %ld, call %u, field at (%d,%d) of %u cells, size %u, \"%.*s\" after \"%.*s\", %u handshake errors\n",
+               r, i, h.x, h.y, width, size, width, cell, width, was, Shim_Errors);
+        return 1;
+      }
+      Shim_Clear();
+      for(c=len=wasLen=0; c<width; c++){
+        len += (cell[c] != ' ');
+        wasLen += (was[c] != ' ') && (was[c] != 0);
+      }
+      shrinks += (len < wasLen);
+      idle += (Windows == 0);
+      calls++;
+      memcpy(was, cell, sizeof(was));
+    }
+  }
+  printf("PASS: %ld calls, %ld shorter than the last, %ld with nothing sent\n", calls, shrinks, idle);
+  return 0;
+}
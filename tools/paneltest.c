@@ -0,0 +1,253 @@
+// paneltest.c
+// Runs on a PC (Linux), not on the LaunchPad.
+// Two panel check: drawing on a panel on SSI0 and one on SSI2 in
+// turns, switching with ST7735_SelectPanel() between every batch of
+// calls, must leave each panel as drawing on it alone.  The same
+// random calls are run three ways, each in its own process so the
+// driver starts fresh:
+//   A  the panel on SSI0 alone
+//   B  the panel on SSI2 alone (DC on PB0, RESET on PB1)
+//   I  both, interleaved
+// under st7735shim.c, which records each SSI.
+// Round 1 draws fills, lines, circles, strings, pixels and rotations:
+// I's SSI0 wire must be byte for byte A's (Data/Command pin
+// included), and I's SSI2 wire B's.
+// Round 2 prints console text.  The console shadow is forgotten on
+// a switch, so I sends more (cells it cannot skip), and the screens,
+// read back from the wires after every batch, must be the same
+// instead.
+//
+// build: gcc -O1 -no-pie -w -DST7735_SHIM -I. -I"../Single User Pong Game"
+//          -I"../Ball Roll using accelerometer" -o paneltest paneltest.c
+//          st7735shim.c "../Single User Pong Game/ST7735.c"
+// usage: ./paneltest
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "ST7735.h"
+#include "st7735shim.h"
+
+#define ST7735_CASET   0x2A
+#define ST7735_RASET   0x2B
+#define ST7735_RAMWR   0x2C
+#define BATCHES 30
+#define CALLS 40                        // per batch
+#define PB0 0x40005004                  // DC of the second panel, bit-specific address
+
+typedef struct{
+  uint16_t *data;
+  uint32_t count;
+  uint32_t mark[BATCHES];               // count after each batch
+} Wire_t;
+
+static Panel_t Right = {2, 1, 0x01, 0x02};
+
+// A batch of calls on the selected panel, the same for a given k
+// and panel whatever else has been drawn.  Round 2 is console text
+// only, since drawing over it needs ST7735_TextInvalidate().
+static void batch(int k, int panel, int round){
+  static const char *text[4] = {"Hi\n", "Score 12", "\n", "Rally 3\nBest 20\n"};
+  int i, x, y, w, h;
+  uint16_t c;
+  srand(7*k + panel);
+  for(i=0; i<CALLS; i++){
+    x = rand()%140 - 6;
+    y = rand()%140 - 6;
+    w = rand()%50;
+    h = rand()%50;
+    c = rand();
+    if(round == 2){
+      switch(rand()%4){
+      case 0: ST7735_SetCursor(w%21, h%16); break;
+      case 1: ST7735_SetTextColor(c); break;
+      default: ST7735_OutString((char *)text[x&3]); break;
+      }
+      if(i == CALLS-1){                 // switch away with a new line not yet written
+        ST7735_SetCursor(0, k%15 + 1);
+        ST7735_OutString("Long line of text");
+        ST7735_SetCursor(0, k%15);
+        ST7735_OutString("Next\n");
+      }
+      continue;
+    }
+    switch(rand()%6){
+    case 0: ST7735_FillRect(x, y, w, h, c); break;
+    case 1: ST7735_DrawLine(x, y, w, h, c); break;
+    case 2: ST7735_FillCircle(x, y, w/4, c); break;
+    case 3: ST7735_DrawString((x < 0) ? 0 : x%20, (y < 0) ? 0 : y%15, "Hello", c); break;
+    case 4: ST7735_DrawPixel(x, y, c); break;
+    default: ST7735_SetRotation(rand()%4); break;
+    }
+  }
+}
+
+// Play the first n entries of a wire into a screen: address windows
+// and pixel data.
+static void replay(const Wire_t *w, uint32_t n, uint16_t *screen){
+  uint32_t i, cmd = 0, arg = 0;
+  uint8_t a[4];
+  int x0 = 0, x1 = 127, y0 = 0, x = 0, y = 0, hi = -1;
+  for(i=0; i<n; i++){
+    if((w->data[i]&SHIM_DATA) == 0){
+      cmd = w->data[i];
+      arg = 0;
+      if(cmd == ST7735_RAMWR){
+        x = x0;
+        y = y0;
+        hi = -1;
+      }
+      continue;
+    }
+    if((cmd == ST7735_CASET) || (cmd == ST7735_RASET)){
+      a[arg++&3] = w->data[i];
+      if(arg == 4){
+        if(cmd == ST7735_CASET){
+          x0 = a[1]; x1 = a[3];
+        } else{
+          y0 = a[1];
+        }
+      }
+    } else if(cmd == ST7735_RAMWR){
+      if(hi < 0){
+        hi = w->data[i]&0xFF;
+        continue;
+      }
+      if((x < 132) && (y < 162)) screen[132*y + x] = (hi<<8) | (w->data[i]&0xFF);
+      hi = -1;
+      if(++x > x1){
+        x = x0;
+        y++;
+      }
+    }
+  }
+}
+
+// Run one way in a child process and read back both wires.
+static void run(char mode, int round, Wire_t wire[2]){
+  int fd[2], k, s;
+  pid_t pid;
+  uint32_t n;
+  ssize_t got;
+  if(pipe(fd) < 0){
+    perror("pipe");
+    exit(1);
+  }
+  pid = fork();
+  if(pid == 0){
+    close(fd[0]);
+    Shim_Init();
+    Shim_SetDC(SHIM_SSI2, PB0);
+    if(mode != 'B') ST7735_InitR(INITR_REDTAB);
+    if(mode != 'A'){
+      ST7735_SelectPanel(&Right);
+      ST7735_InitR(INITR_GREENTAB);
+    }
+    for(k=0; k<BATCHES; k++){
+      if(mode != 'B'){
+        ST7735_SelectPanel(0);
+        batch(k, 0, round);
+      }
+      if(mode != 'A'){
+        ST7735_SelectPanel(&Right);
+        batch(k, 1, round);
+      }
+      ST7735_WaitIdle();
+      Shim_Drain();
+      wire[0].mark[k] = Shim_Wire[0].count;
+      wire[1].mark[k] = Shim_Wire[1].count;
+    }
+    ST7735_WaitIdle();
+    Shim_Drain();
+    for(s=0; s<2; s++){
+      write(fd[1], &Shim_Wire[s].count, sizeof(uint32_t));
+      write(fd[1], wire[s].mark, sizeof(wire[s].mark));
+      write(fd[1], Shim_Wire[s].data, Shim_Wire[s].count*sizeof(uint16_t));
+    }
+    write(fd[1], &Shim_Errors, sizeof(uint32_t));
+    _exit(0);
+  }
+  close(fd[1]);
+  for(s=0; s<2; s++){
+    read(fd[0], &wire[s].count, sizeof(uint32_t));
+    read(fd[0], wire[s].mark, sizeof(wire[s].mark));
+    wire[s].data = malloc(wire[s].count*sizeof(uint16_t) + 1);
+    for(n=0; n<wire[s].count*sizeof(uint16_t); n=n+got){
+      got = read(fd[0], (char *)wire[s].data + n, wire[s].count*sizeof(uint16_t) - n);
+      if(got <= 0){
+        printf("FAIL: %c stopped early\n", mode);
+        exit(1);
+      }
+    }
+  }
+  n = 1;
+  read(fd[0], &n, sizeof(uint32_t));
+  close(fd[0]);
+  waitpid(pid, 0, 0);
+  if(n){
+    printf("FAIL: %c: %u handshake errors\n", mode, n);
+    exit(1);
+  }
+}
+
+// Index of the first difference, or -1.
+static int32_t compare(const Wire_t *a, const Wire_t *b){
+  uint32_t i;
+  for(i=0; (i<a->count) && (i<b->count); i++){
+    if(a->data[i] != b->data[i]) return i;
+  }
+  return (a->count == b->count) ? -1 : (int32_t)i;
+}
+
+// Batch after which the screens read back from the two wires first
+// differ, or -1.
+static int sameScreen(const Wire_t *a, const Wire_t *b){
+  static uint16_t sa[132*162], sb[132*162];
+  int k;
+  for(k=0; k<BATCHES; k++){
+    memset(sa, 0, sizeof(sa));
+    memset(sb, 0, sizeof(sb));
+    replay(a, a->mark[k], sa);
+    replay(b, b->mark[k], sb);
+    if(memcmp(sa, sb, sizeof(sa))) return k;
+  }
+  return -1;
+}
+
+int main(void){
+  Wire_t a[2], b[2], in[2];
+  int32_t d0, d2;
+  int round;
+  for(round=1; round<=2; round++){
+    run('A', round, a);
+    run('B', round, b);
+    run('I', round, in);
+    printf("round %d: SSI0 alone %u bytes, interleaved %u; SSI2 alone %u, interleaved %u\n", round,
+           a[SHIM_SSI0].count, in[SHIM_SSI0].count, b[SHIM_SSI2].count, in[SHIM_SSI2].count);
+    if((a[SHIM_SSI0].count == 0) || (b[SHIM_SSI2].count == 0) ||
+       a[SHIM_SSI2].count || b[SHIM_SSI0].count){
+      printf("FAIL: a panel was drawn on the wrong SSI\n");
+      return 1;
+    }
+    if(round == 1){
+      d0 = compare(&in[SHIM_SSI0], &a[SHIM_SSI0]);
+      d2 = compare(&in[SHIM_SSI2], &b[SHIM_SSI2]);
+      if((d0 >= 0) || (d2 >= 0)){
+        printf("FAIL: first difference at byte %d of SSI0, %d of SSI2\n", d0, d2);
+        return 1;
+      }
+    } else{
+      d0 = sameScreen(&in[SHIM_SSI0], &a[SHIM_SSI0]);
+      d2 = sameScreen(&in[SHIM_SSI2], &b[SHIM_SSI2]);
+      if((d0 >= 0) || (d2 >= 0)){
+        printf("FAIL: screens first differ after batch %d on SSI0, %d on SSI2\n", d0, d2);
+        return 1;
+      }
+    }
+  }
+  printf("PASS: each panel is drawn the same interleaved as alone\n");
+  return 0;
+}
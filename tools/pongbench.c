@@ -0,0 +1,166 @@
+// pongbench.c
+// Runs on a PC (any C compiler), not on the LaunchPad.
+// Plays the game of Pong.c (Single User Pong Game) headless: Pong_Tick()
+// draws into a sink that only counts the commands, and the paddle is
+// moved by one of two players:
+//   imperfect  aims at the predicted impact row with up to 12 pixels of
+//              error, picked again every 64 ticks, and moves 2 pixels
+//              per tick
+//   perfect    puts the paddle on the prediction each tick, as the
+//              firmware's AUTOPLAY does; it must never miss
+// As in main.c, every STALL_EVERY ticks the loop falls STALL_TICKS
+// behind: the ticks past MAX_CATCHUP go to Pong_Skip(), and are dropped
+// if it cannot take them.
+// It prints ticks per second, draw commands per tick, the rallies
+// (paddle hits per ball) and how often Pong_Skip() took the ticks.
+//
+// build: gcc -O2 -I"../Single User Pong Game" -o pongbench pongbench.c
+//          "../Single User Pong Game/Pong.c" "../Single User Pong Game/Ball.c"
+// usage: ./pongbench [ticks]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include "Ball.h"
+#include "Pong.h"
+
+#define TICKS 20000000                  // default, 46 hours of play at TICK_HZ
+#define MAX_CATCHUP 8                   // as main.c
+#define STALL_EVERY (5*TICK_HZ)
+#define STALL_TICKS (TICK_HZ/4)
+#define AIM_ERROR 12                    // imperfect player, pixels either way
+#define AIM_TICKS 64
+#define PADDLE_STEP 2
+#define IMPERFECT 0
+#define PERFECT 1
+
+typedef struct{
+  uint32_t ticks;                       // stepped by Pong_Tick()
+  uint32_t ops[PONG_DRAW_SERVE+1];      // draw commands by PONG_DRAW_...
+  uint32_t rallies;
+  uint32_t hits;                        // over all rallies
+  uint32_t longest;
+  uint32_t length[8];                   // rallies of 0, 1, 2-3, 4-7 ... 64 or more hits
+  uint32_t skipped;                     // ticks Pong_Skip() took
+  uint32_t dropped;                     // ticks it could not
+  double seconds;
+} Run_t;
+
+static volatile int32_t Sum;            // keeps the draw commands alive
+
+// Stands in for drawCommands() in main.c.
+static void sink(Run_t *run, const PongDraw_t *draw, uint32_t n){
+  uint32_t i;
+  for(i=0; i<n; i++){
+    run->ops[draw[i].op]++;
+    Sum += draw[i].x + draw[i].y + draw[i].arg;
+  }
+}
+
+static double now(void){
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + t.tv_nsec*1e-9;
+}
+
+static int32_t clamp(int32_t y){
+  return y < PADDLE_MIN_Y ? PADDLE_MIN_Y : y > PADDLE_MAX_Y ? PADDLE_MAX_Y : y;
+}
+
+// Paddle row for the next tick.
+static int32_t play(int player, const Pong_t *game, uint32_t tick, int32_t paddle){
+  static int32_t aim;
+  static uint32_t random = 1;
+  // center the paddle (rows y-15 to y) on the ball (rows y-4 to y)
+  int32_t want = (game->impactY + BALL_ONE/2)/BALL_ONE + (PADDLE_HEIGHT - BALL_SIZE)/2;
+  if(player == PERFECT){
+    return clamp(want);
+  }
+  if(tick%AIM_TICKS == 0){
+    random = random*1103515245 + 12345;
+    aim = want + (int32_t)((random>>16)%(2*AIM_ERROR + 1)) - AIM_ERROR;
+  } else if(abs(want - aim) > AIM_ERROR){
+    aim = want;                         // the prediction moved: a bounce
+  }
+  if(paddle < aim){
+    paddle = paddle + (aim - paddle > PADDLE_STEP ? PADDLE_STEP : aim - paddle);
+  } else{
+    paddle = paddle - (paddle - aim > PADDLE_STEP ? PADDLE_STEP : paddle - aim);
+  }
+  return clamp(paddle);
+}
+
+static void run(int player, uint32_t ticks, Run_t *r){
+  Pong_t game;
+  PongInput_t input;
+  PongDraw_t draw[PONG_MAX_DRAWS];
+  uint32_t t, i, n, k, skip;
+  double t0;
+  Pong_Init(&game, 12345);
+  input.paddleY = (PADDLE_MIN_Y + PADDLE_MAX_Y)/2;
+  t0 = now();
+  for(t=0; t<ticks; t++){
+    if((t%STALL_EVERY == 0) && (t > 0)){
+      skip = STALL_TICKS - MAX_CATCHUP;
+      if(Pong_Skip(&game, skip)){
+        r->skipped += skip;
+      } else{
+        r->dropped += skip;
+      }
+    }
+    if(game.countdown == 0){
+      input.paddleY = play(player, &game, t, input.paddleY);
+    }
+    n = Pong_Tick(&game, &input, draw);
+    sink(r, draw, n);
+    for(i=0; i<n; i++){
+      if(draw[i].op == PONG_DRAW_MISS){
+        r->rallies++;
+        r->hits += game.lastRally;
+        if(game.lastRally > r->longest) r->longest = game.lastRally;
+        for(k=0; (k < 7) && (game.lastRally>>k); k++){}
+        r->length[k]++;
+      }
+    }
+  }
+  r->seconds = now() - t0;
+  r->ticks = ticks;
+}
+
+static void report(const char *name, const Run_t *r){
+  static const char *label[8] = {"0", "1", "2-3", "4-7", "8-15", "16-31", "32-63", "64+"};
+  int k;
+  printf("%s player: %u ticks in %.2f s, %.1f M ticks/s\n", name, r->ticks, r->seconds,
+         r->ticks/r->seconds/1e6);
+  printf("  draw commands per tick: ball %.3f, paddle %.3f, marker %.3f, flash %.4f\n",
+         (double)r->ops[PONG_DRAW_BALL]/r->ticks, (double)r->ops[PONG_DRAW_PADDLE]/r->ticks,
+         (double)r->ops[PONG_DRAW_MARKER]/r->ticks, (double)r->ops[PONG_DRAW_FLASH]/r->ticks);
+  printf("  %u serves, %u misses", r->ops[PONG_DRAW_SERVE], r->rallies);
+  if(r->rallies){
+    printf(", mean rally %.1f hits, longest %u\n ", (double)r->hits/r->rallies, r->longest);
+    for(k=0; k<8; k++){
+      printf(" %s: %.1f%%", label[k], 100.0*r->length[k]/r->rallies);
+    }
+  }
+  printf("\n  Pong_Skip() took %u stalled ticks, %u dropped\n", r->skipped, r->dropped);
+}
+
+int main(int argc, char **argv){
+  static Run_t imperfect, perfect;
+  uint32_t ticks = (argc > 1) ? strtoul(argv[1], 0, 0) : TICKS;
+  run(IMPERFECT, ticks, &imperfect);
+  report("imperfect", &imperfect);
+  run(PERFECT, ticks, &perfect);
+  report("perfect", &perfect);
+  if(perfect.rallies){
+    printf("FAIL: the perfect player missed\n");
+    return 1;
+  }
+  if(imperfect.dropped && (imperfect.skipped == 0)){
+    printf("FAIL: Pong_Skip() never took a stall\n");
+    return 1;
+  }
+  printf("PASS\n");
+  return 0;
+}
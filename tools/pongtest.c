@@ -0,0 +1,165 @@
+// pongtest.c
+// Runs on a PC (any C compiler), not on the LaunchPad.
+// Checks the closed form impact prediction of Pong.c (Single User Pong
+// Game) against stepping the ball one tick at a time with isColliding(),
+// the paddle out of the way, for every launch angle the game uses (8 to
+// 40 either side of straight left, and of straight right for a ball
+// coming back off the paddle), every start row between the walls, three
+// start columns and speeds of 1 to 3 pixels per tick:
+//  - foldY() against reflecting a row off the walls one at a time
+//  - the ticks calculateDestCoor() gives until the ball's left edge
+//    reaches the paddle's front must be the ticks stepping takes
+//  - the row it gives must be the stepped row there, interpolated in
+//    the last tick when no wall is in it, to 1/256 pixel (the two
+//    divisions round differently)
+//  - fastForwardBall() by n ticks must land exactly where n steps do,
+//    for every n before the paddle
+// It also times the prediction against stepping to the paddle.
+// Pong.c is included, not linked, to reach its static functions.
+//
+// build: gcc -O2 -I"../Single User Pong Game" -o pongtest pongtest.c
+//          "../Single User Pong Game/Ball.c"
+// usage: ./pongtest
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include "../Single User Pong Game/Pong.c"
+
+#define AWAY 1000                       // paddle row no ball reaches
+#define SPEED_STEP (4*BALL_SPEED_STEP)
+#define ROW_LIMIT 1                     // Q8.8
+#define MAX_TICKS 1000
+
+static int Fail;
+static Ball_t Start[4*(LAUNCH_MAX_ANGLE-LAUNCH_MIN_ANGLE+1)*(WALL_BOTTOM_Y-WALL_TOP_Y+1)*3*
+                    ((BALL_MAX_SPEED-BALL_START_SPEED)/SPEED_STEP+1)];
+static uint32_t Starts;
+
+static void check(int ok, const char *what, const Ball_t *ball){
+  if(!ok && (Fail < 10)){
+    printf("FAIL: %s, ball at (%d, %d) angle %d speed %d\n", what,
+           ball->x, ball->y, ball->angle, ball->speed);
+  }
+  Fail += !ok;
+}
+
+static double now(void){
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + t.tv_nsec*1e-9;
+}
+
+// foldY() the long way: one wall at a time.
+static int32_t reflect(int32_t y, uint8_t *flipped){
+  *flipped = 0;
+  for(;;){
+    if(y < WALL_TOP_Y*BALL_ONE){
+      y = 2*WALL_TOP_Y*BALL_ONE - y;
+    } else if(y > WALL_BOTTOM_Y*BALL_ONE){
+      y = 2*WALL_BOTTOM_Y*BALL_ONE - y;
+    } else{
+      return y;
+    }
+    *flipped ^= 1;
+  }
+}
+
+// Every start the game can give, and more rows and columns.
+static void starts(void){
+  static const int column[3] = {PADDLE_X + PADDLE_WIDTH, 60, WALL_RIGHT_X};
+  int a, side, row, c;
+  int32_t speed;
+  for(a=LAUNCH_MIN_ANGLE; a<=LAUNCH_MAX_ANGLE; a++){
+    for(side=0; side<4; side++){
+      for(row=WALL_TOP_Y; row<=WALL_BOTTOM_Y; row++){
+        for(c=0; c<3; c++){
+          for(speed=BALL_START_SPEED; speed<=BALL_MAX_SPEED; speed=speed+SPEED_STEP){
+            Ball_Launch(&Start[Starts++], column[c], row,
+                        (uint8_t)((side&2 ? BALL_ANGLE_LEFT : 0) + (side&1 ? a : -a)), speed);
+          }
+        }
+      }
+    }
+  }
+}
+
+int main(void){
+  Ball_t ball, ahead;
+  uint32_t i, n, ticks, rows = 0, worstTicks = 0;
+  int32_t y, yf, yStep, e, worstRow = 0, worstAhead = 0;
+  int32_t lastX, lastY, lastVy;
+  uint8_t flipped, again;
+  double t0, tPredict, tStep;
+  volatile int32_t sink = 0;
+  for(y=-3*128*BALL_ONE; y<=3*128*BALL_ONE; y++){
+    yf = foldY(y, &flipped);
+    // on a wall, bounced or not is the same place
+    if((yf != reflect(y, &again)) || ((flipped != again) && (yf != WALL_TOP_Y*BALL_ONE) &&
+                                      (yf != WALL_BOTTOM_Y*BALL_ONE))){
+      printf("FAIL: foldY(%d)\n", y);
+      return 1;
+    }
+  }
+  starts();
+  for(i=0; i<Starts; i++){
+    ticks = calculateDestCoor(&Start[i], PADDLE_FACE, &yf);
+    ball = Start[i];
+    lastX = ball.x;
+    lastY = ball.y;
+    lastVy = ball.vy;
+    for(n=0; (n < MAX_TICKS) && ((ball.vx > 0) || (ball.x > PADDLE_FACE)); n++){
+      // every tick before the paddle, fast-forwarding gets there too
+      ahead = Start[i];
+      fastForwardBall(&ahead, n);
+      e = abs(ahead.x - ball.x) + abs(ahead.y - ball.y);
+      if(e > worstAhead) worstAhead = e;
+      check(e == 0, "fastForwardBall position", &Start[i]);
+      // one tick early at a wall the bounce is still to come
+      check(ahead.vx == ball.vx && (ahead.vy == ball.vy || ball.y == WALL_TOP_Y*BALL_ONE ||
+            ball.y == WALL_BOTTOM_Y*BALL_ONE), "fastForwardBall velocity", &Start[i]);
+      lastX = ball.x;
+      lastY = ball.y;
+      lastVy = ball.vy;
+      isColliding(&ball, PADDLE_X, AWAY);
+    }
+    if(n > worstTicks) worstTicks = n;
+    check(n == ticks, "ticks to the paddle", &Start[i]);
+    // the row where the last tick crossed the front, if no wall was in it
+    if((lastVy == ball.vy) && (lastX > ball.x)){
+      yStep = lastY + (int32_t)((int64_t)(ball.y - lastY)*(lastX - PADDLE_FACE)/(lastX - ball.x));
+      e = abs(yStep - yf);
+      if(e > worstRow) worstRow = e;
+      check(e <= ROW_LIMIT, "row at the paddle", &Start[i]);
+      rows++;
+    }
+  }
+  // time the two ways to the same answer
+  t0 = now();
+  for(i=0; i<Starts; i++){
+    sink += calculateDestCoor(&Start[i], PADDLE_FACE, &yf);
+  }
+  tPredict = now() - t0;
+  t0 = now();
+  for(i=0; i<Starts; i++){
+    ball = Start[i];
+    for(n=0; (ball.vx > 0) || (ball.x > PADDLE_FACE); n++){
+      isColliding(&ball, PADDLE_X, AWAY);
+    }
+    sink += n;
+  }
+  tStep = now() - t0;
+  printf("%u starts, up to %u ticks to the paddle\n", Starts, worstTicks);
+  printf("row at the paddle, %u without a wall in the last tick: worst error %d/256 px\n",
+         rows, worstRow);
+  printf("fastForwardBall against stepping: worst error %d/256 px\n", worstAhead);
+  printf("predict %.1f ns, step %.1f ns, %.0fx faster\n", tPredict/Starts*1e9,
+         tStep/Starts*1e9, tStep/tPredict);
+  if(Fail){
+    printf("FAIL: %d checks\n", Fail);
+    return 1;
+  }
+  printf("PASS\n");
+  return 0;
+}
@@ -0,0 +1,240 @@
+// rastertest.c
+// Runs on a PC (Linux), not on the LaunchPad.
+// Check of the span rasterizer (ST7735_DrawLine(), ST7735_DrawCircle(),
+// ST7735_FillCircle() and ST7735_FillTriangle() in the Single User
+// Pong Game driver) using the SSI/uDMA model in st7735shim.c.  The
+// wire is read back into a count of how many times each pixel was
+// written, and every shape is compared with a reference drawn one
+// pixel at a time:
+//   line      exactly the pixels of a plain Bresenham line
+//   circle    exactly the pixels of the matching disc (x*x + y*y <=
+//             r*r + r) that have a 4-neighbor outside it
+//   disc      exactly the pixels of that disc
+//   triangle  every pixel whose center is inside, and nothing more
+//             than a pixel outside any edge
+// No pixel may be written twice.  Shapes are random and may hang off
+// the screen, where the reference is clipped the same way.  It also
+// prints the windows and pixels of a radius 39 circle outline.
+// It fails on the first wrong shape, or if the shim finds a
+// handshake error.
+//
+// build: gcc -O1 -no-pie -w -DST7735_SHIM -I. -I"../Single User Pong Game"
+//          -I"../Ball Roll using accelerometer" -o rastertest rastertest.c
+//          st7735shim.c "../Single User Pong Game/ST7735.c"
+// usage: ./rastertest [shapes]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "ST7735.h"
+#include "st7735shim.h"
+
+#define ST7735_CASET   0x2A
+#define ST7735_RASET   0x2B
+#define ST7735_RAMWR   0x2C
+#define SIZE 128                        // screen of the Single User Pong Game driver
+
+static uint8_t Count[SIZE*SIZE];        // writes to each pixel
+static uint8_t Ref[SIZE*SIZE];          // 1 if the pixel should be drawn
+static uint8_t Near[SIZE*SIZE];         // 1 if a triangle may draw the pixel
+
+// Replay the wire since the last Shim_Clear() into Count.  The
+// window is kept between calls, since the driver does not resend
+// an address window that is already set.
+static void replay(void){
+  static int x0 = 0, x1 = SIZE-1, y0 = 0, x = 0, y = 0;
+  const ShimWire_t *w = &Shim_Wire[SHIM_SSI0];
+  uint32_t i, cmd = 0, arg = 0;
+  uint8_t a[4];
+  int hi = -1;
+  for(i=0; i<w->count; i++){
+    if((w->data[i]&SHIM_DATA) == 0){
+      cmd = w->data[i];
+      arg = 0;
+      if(cmd == ST7735_RAMWR){
+        x = x0;
+        y = y0;
+        hi = -1;
+      }
+      continue;
+    }
+    if((cmd == ST7735_CASET) || (cmd == ST7735_RASET)){
+      a[arg++&3] = w->data[i];
+      if(arg == 4){
+        if(cmd == ST7735_CASET){
+          x0 = a[1]; x1 = a[3];
+        } else{
+          y0 = a[1];
+        }
+      }
+    } else if(cmd == ST7735_RAMWR){
+      if(hi < 0){
+        hi = w->data[i]&0xFF;
+        continue;
+      }
+      if((x < SIZE) && (y < SIZE)) Count[SIZE*y + x]++;
+      hi = -1;
+      if(++x > x1){
+        x = x0;
+        y++;
+      }
+    }
+  }
+}
+
+static void plot(uint8_t *map, int32_t x, int32_t y){
+  if((x >= 0) && (x < SIZE) && (y >= 0) && (y < SIZE)) map[SIZE*y + x] = 1;
+}
+
+static void refLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1){
+  int32_t dx = abs(x1 - x0), dy = abs(y1 - y0), t, err;
+  if(dx >= dy){
+    if(x0 > x1){ t = x0; x0 = x1; x1 = t; t = y0; y0 = y1; y1 = t; }
+    err = dx/2;
+    for(t=x0; t<=x1; t++){
+      plot(Ref, t, y0);
+      err = err - dy;
+      if(err < 0){ y0 = y0 + ((y1 > y0) ? 1 : -1); err = err + dx; }
+    }
+  } else{
+    if(y0 > y1){ t = x0; x0 = x1; x1 = t; t = y0; y0 = y1; y1 = t; }
+    err = dy/2;
+    for(t=y0; t<=y1; t++){
+      plot(Ref, x0, t);
+      err = err - dx;
+      if(err < 0){ x0 = x0 + ((x1 > x0) ? 1 : -1); err = err + dy; }
+    }
+  }
+}
+
+static int inDisc(int32_t x, int32_t y, int32_t r){
+  return (x*x + y*y) <= (r*r + r);
+}
+
+static void refCircle(int32_t x0, int32_t y0, int32_t r, int outline){
+  int32_t x, y;
+  for(y=-r; y<=r; y++){
+    for(x=-r; x<=r; x++){
+      if(!inDisc(x, y, r)) continue;
+      if(outline && inDisc(x-1, y, r) && inDisc(x+1, y, r) &&
+         inDisc(x, y-1, r) && inDisc(x, y+1, r)) continue;
+      plot(Ref, x0 + x, y0 + y);
+    }
+  }
+}
+
+// Twice the signed area of a,b,p, with p at a pixel center.
+static int64_t edge(int32_t ax, int32_t ay, int32_t bx, int32_t by, int32_t px, int32_t py){
+  return (int64_t)(bx - ax)*(py - ay) - (int64_t)(by - ay)*(px - ax);
+}
+
+// Ref gets the pixels strictly inside, Near those no more than a
+// pixel outside any edge, a whole pixel along x or y.
+static void refTriangle(const int32_t *c){
+  int32_t x, y, i, j, k;
+  int64_t e, s;
+  int inside, near;
+  s = edge(c[0], c[1], c[2], c[3], c[4], c[5]);
+  for(y=0; y<SIZE; y++){
+    for(x=0; x<SIZE; x++){
+      inside = (s != 0);
+      near = 1;
+      for(i=0; i<3; i++){
+        j = (i + 1)%3;
+        e = edge(c[2*i], c[2*i+1], c[2*j], c[2*j+1], x, y);
+        if(s < 0) e = -e;
+        if(e <= 0) inside = 0;
+        k = abs(c[2*j] - c[2*i]) + abs(c[2*j+1] - c[2*i+1]);
+        if(e < -k) near = 0;
+      }
+      if(near){
+        near = (x >= c[0] - 1 || x >= c[2] - 1 || x >= c[4] - 1) &&
+               (x <= c[0] + 1 || x <= c[2] + 1 || x <= c[4] + 1) &&
+               (y >= c[1] || y >= c[3] || y >= c[5]) &&
+               (y <= c[1] || y <= c[3] || y <= c[5]);
+      }
+      Ref[SIZE*y + x] = inside;
+      Near[SIZE*y + x] = near;
+    }
+  }
+}
+
+static int rnd(int lo, int hi){
+  return lo + rand()%(hi - lo + 1);
+}
+
+int main(int argc, char **argv){
+  static const char *names[4] = {"line", "circle", "disc", "triangle"};
+  long shapes = (argc > 1) ? atol(argv[1]) : 100000;
+  long n, windows[4] = {0}, pixels[4] = {0};
+  int32_t c[6], i, kind, r, bad;
+  srand(1);
+  Shim_Init();
+  ST7735_InitR(INITR_REDTAB);
+  ST7735_FillScreen(0);
+  ST7735_WaitIdle();
+  Shim_Drain();
+  replay();
+  Shim_Clear();
+
+  memset(Count, 0, sizeof(Count));
+  ST7735_ClearTxCount();
+  ST7735_DrawCircle(64, 64, 39, ST7735_WHITE);
+  Shim_Drain();
+  replay();
+  Shim_Clear();
+  for(i=bad=0; i<SIZE*SIZE; i++) bad += Count[i];
+  printf("radius 39 circle outline: %u windows, %d pixels\n", ST7735_GetWindowCount(), bad);
+
+  for(n=0; n<shapes; n++){
+    kind = n%4;
+    for(i=0; i<6; i++) c[i] = rnd(-40, SIZE + 40);
+    r = rnd(0, 80);
+    memset(Count, 0, sizeof(Count));
+    memset(Ref, 0, sizeof(Ref));
+    ST7735_ClearTxCount();
+    switch(kind){
+    case 0:
+      ST7735_DrawLine(c[0], c[1], c[2], c[3], ST7735_WHITE);
+      refLine(c[0], c[1], c[2], c[3]);
+      break;
+    case 1:
+      ST7735_DrawCircle(c[0], c[1], r, ST7735_WHITE);
+      refCircle(c[0], c[1], r, 1);
+      break;
+    case 2:
+      ST7735_FillCircle(c[0], c[1], r, ST7735_WHITE);
+      refCircle(c[0], c[1], r, 0);
+      break;
+    default:
+      ST7735_FillTriangle(c[0], c[1], c[2], c[3], c[4], c[5], ST7735_WHITE);
+      refTriangle(c);
+      break;
+    }
+    Shim_Drain();
+    replay();
+    Shim_Clear();
+    windows[kind] += ST7735_GetWindowCount();
+    for(i=bad=0; i<SIZE*SIZE; i++){
+      pixels[kind] += Count[i];
+      if(Count[i] > 1) bad = 1;         // overdraw
+      if(kind == 3){
+        if(Ref[i] && !Count[i]) bad = 1;
+        if(Count[i] && !Near[i]) bad = 1;
+      } else if(Count[i] != Ref[i]){
+        bad = 1;
+      }
+    }
+    if(bad || Shim_Errors){
+      printf("FAIL: shape %ld, %s (%d,%d) (%d,%d) (%d,%d) r=%d, %u handshake errors\n",
+             n, names[kind], c[0], c[1], c[2], c[3], c[4], c[5], r, Shim_Errors);
+      return 1;
+    }
+  }
+  for(kind=0; kind<4; kind++){
+    printf("%-8s %9ld windows %10ld pixels\n", names[kind], windows[kind], pixels[kind]);
+  }
+  printf("PASS: %ld shapes\n", shapes);
+  return 0;
+}
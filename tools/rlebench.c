@@ -0,0 +1,173 @@
+// rlebench.c
+// Runs on a PC (Linux), not on the LaunchPad.
+// Cost of drawing the Pong walls (Single User Pong Game, drawWalls())
+// three ways, using the SSI/uDMA model in st7735shim.c:
+//   brick   the original loop, a 1x5 bitmap drawn once per column
+//           or row of wall
+//   bitmap  each wall as one full bitmap with ST7735_DrawBitmap()
+//   rle     each wall as one run with ST7735_DrawBitmapRLE()
+// For each it prints:
+//   flash   bytes of image data in flash
+//   bytes   bytes sent to the panel
+//   wire    bus cycles from the first call until the last byte is out
+//   held    CPU cycles held by the LCD (waits in the driver)
+//   cpu/dma FIFO writes by the CPU and items moved by the uDMA
+// The screen is read back from the wire and all three must leave
+// the same 1800 wall pixels.  It fails if they do not, or if the
+// shim finds a handshake error.
+//
+// build: gcc -O1 -no-pie -w -DST7735_SHIM -I. -I"../Single User Pong Game"
+//          -I"../Ball Roll using accelerometer" -o rlebench rlebench.c
+//          st7735shim.c "../Single User Pong Game/ST7735.c"
+// usage: ./rlebench
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include "ST7735.h"
+#include "st7735shim.h"
+
+#define ST7735_CASET   0x2A
+#define ST7735_RASET   0x2B
+#define ST7735_RAMWR   0x2C
+#define WALL_X 7                        // first column right of the paddle
+
+// the brick main.c used before, and its walls now
+static const uint16_t brick[]= {0X0000, 0X0000, 0X0000, 0X0000, 0X0000};
+static const uint16_t wall_horizontal_rle[]= {121*5, 0X0000};
+static const uint16_t wall_vertical_rle[]= {5*118, 0X0000};
+// the same walls as plain bitmaps
+static const uint16_t wall_horizontal[121*5];
+static const uint16_t wall_vertical[5*118];
+
+static uint16_t Screen[128*128], Expect[128*128];
+
+typedef struct{
+  uint64_t wire, held;
+  uint32_t flash, bytes, cpu, dma;
+} Result_t;
+
+static void walls(int which){
+  int i;
+  switch(which){
+  case 0:
+    for(i = WALL_X; i < 128; ++i){
+      ST7735_DrawBitmap(i, 4, brick, 1, 5);
+    }
+    for(i = 5; i < 123; ++i){
+      ST7735_DrawBitmap(123, i, brick, 5, 1);
+    }
+    for(i = WALL_X; i < 128; ++i){
+      ST7735_DrawBitmap(i, 127, brick, 1, 5);
+    }
+    break;
+  case 1:
+    ST7735_DrawBitmap(WALL_X, 4, wall_horizontal, 121, 5);
+    ST7735_DrawBitmap(123, 122, wall_vertical, 5, 118);
+    ST7735_DrawBitmap(WALL_X, 127, wall_horizontal, 121, 5);
+    break;
+  default:
+    ST7735_DrawBitmapRLE(WALL_X, 4, wall_horizontal_rle, 121, 5);
+    ST7735_DrawBitmapRLE(123, 122, wall_vertical_rle, 5, 118);
+    ST7735_DrawBitmapRLE(WALL_X, 127, wall_horizontal_rle, 121, 5);
+    break;
+  }
+}
+
+// Replay the wire into Screen: address windows and pixel data.
+static void replay(void){
+  const ShimWire_t *w = &Shim_Wire[SHIM_SSI0];
+  uint32_t i, cmd = 0, arg = 0;
+  uint8_t a[4];
+  int x0 = 0, x1 = 127, y0 = 0, x = 0, y = 0, hi = -1;
+  for(i=0; i<w->count; i++){
+    if((w->data[i]&SHIM_DATA) == 0){
+      cmd = w->data[i];
+      arg = 0;
+      if(cmd == ST7735_RAMWR){
+        x = x0;
+        y = y0;
+        hi = -1;
+      }
+      continue;
+    }
+    if((cmd == ST7735_CASET) || (cmd == ST7735_RASET)){
+      a[arg++&3] = w->data[i];
+      if(arg == 4){
+        if(cmd == ST7735_CASET){
+          x0 = a[1]; x1 = a[3];
+        } else{
+          y0 = a[1];
+        }
+      }
+    } else if(cmd == ST7735_RAMWR){
+      if(hi < 0){
+        hi = w->data[i]&0xFF;
+        continue;
+      }
+      if((x < 128) && (y < 128)) Screen[128*y + x] = (hi<<8) | (w->data[i]&0xFF);
+      hi = -1;
+      if(++x > x1){
+        x = x0;
+        y++;
+      }
+    }
+  }
+}
+
+static Result_t measure(int which){
+  Result_t r;
+  uint64_t start;
+  ST7735_FillScreen(ST7735_WHITE);
+  ST7735_WaitIdle();
+  Shim_Drain();
+  Shim_Clear();
+  memset(Screen, 0xFF, sizeof(Screen));
+  start = Shim_Cycles;
+  walls(which);
+  ST7735_WaitIdle();
+  r.held = Shim_WaitCycles;
+  Shim_Drain();
+  r.wire = Shim_Cycles - start;
+  r.bytes = Shim_Wire[SHIM_SSI0].count;
+  r.cpu = Shim_CPUWrites;
+  r.dma = Shim_DMAItems;
+  replay();
+  return r;
+}
+
+int main(void){
+  static const char *names[3] = {"brick", "bitmap", "rle"};
+  static const uint32_t flash[3] = {sizeof(brick),
+    sizeof(wall_horizontal) + sizeof(wall_vertical),
+    sizeof(wall_horizontal_rle) + sizeof(wall_vertical_rle)};
+  Result_t r;
+  uint32_t errors = 0, black = 0;
+  int i, k, same = 1;
+  Shim_Init();
+  ST7735_InitR(INITR_REDTAB);
+  printf("%-8s %6s %6s %9s %9s %6s %6s\n", "walls", "flash", "bytes", "wire", "held", "cpu", "dma");
+  for(i=0; i<3; i++){
+    r = measure(i);
+    errors += Shim_Errors;
+    if(i == 0){
+      memcpy(Expect, Screen, sizeof(Screen));
+      for(k=0; k<128*128; k++) black += (Screen[k] == ST7735_BLACK);
+      if(black != 2*121*5 + 5*118){
+        printf("%s: %u wall pixels\n", names[i], black);
+        same = 0;
+      }
+    } else if(memcmp(Expect, Screen, sizeof(Screen))){
+      printf("%s: different pixels\n", names[i]);
+      same = 0;
+    }
+    printf("%-8s %6u %6u %9llu %9llu %6u %6u\n", names[i], flash[i], r.bytes,
+           (unsigned long long)r.wire, (unsigned long long)r.held, r.cpu, r.dma);
+  }
+  if(errors || !same){
+    printf("FAIL: %u handshake errors\n", errors);
+    return 1;
+  }
+  printf("PASS: same walls\n");
+  return 0;
+}
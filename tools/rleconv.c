@@ -0,0 +1,103 @@
+// rleconv.c
+// Runs on a PC (any C compiler), not on the LaunchPad.
+// Converts a 16-bit color bitmap, as used by ST7735_DrawBitmap(),
+// to the run-length encoded format of ST7735_DrawBitmapRLE().
+//
+// usage: rleconv name width height < pixels.txt > name.c
+//   pixels.txt holds the width*height colors of the bitmap in the
+//   ST7735_DrawBitmap() order (bottom row first), written as C
+//   numbers separated by commas or white space, e.g. the inside of
+//   the braces of an existing const uint16_t array.
+// The output is a const uint16_t array with the rows flipped to top
+// row first.  Runs of 3 or more equal pixels become run records and
+// everything else is collected into literal records.  A comment
+// gives the flash size before and after.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#define MAXRECORD 0x7FFF
+
+static uint16_t *Out;                   // encoded words
+static long OutCount;
+
+static void put(uint16_t word){
+  Out[OutCount++] = word;
+}
+
+// Emit pixels[start..end) as literal records.
+static void putLiteral(const uint16_t *pixels, long start, long end){
+  long n, i;
+  while(start < end){
+    n = end - start;
+    if(n > MAXRECORD) n = MAXRECORD;
+    put(0x8000 | n);
+    for(i=0; i<n; i++){
+      put(pixels[start + i]);
+    }
+    start = start + n;
+  }
+}
+
+int main(int argc, char **argv){
+  long w, h, count, i, j, run, literalStart;
+  uint16_t *raw, *pixels;
+  char token[64];
+  if(argc != 4){
+    fprintf(stderr, "usage: rleconv name width height < pixels.txt\n");
+    return 1;
+  }
+  w = atol(argv[2]);
+  h = atol(argv[3]);
+  if((w <= 0) || (h <= 0)){
+    fprintf(stderr, "rleconv: bad size\n");
+    return 1;
+  }
+  raw = malloc(w*h*sizeof(uint16_t));
+  pixels = malloc(w*h*sizeof(uint16_t));
+  Out = malloc(2*w*h*sizeof(uint16_t) + 16);
+  if(!raw || !pixels || !Out){
+    fprintf(stderr, "rleconv: out of memory\n");
+    return 1;
+  }
+  count = 0;
+  while((count < w*h) && (scanf(" %63[^, \t\r\n]%*[, \t\r\n]", token) == 1)){
+    raw[count++] = (uint16_t)strtol(token, 0, 0);
+  }
+  if(count != w*h){
+    fprintf(stderr, "rleconv: expected %ld pixels, read %ld\n", w*h, count);
+    return 1;
+  }
+  for(j=0; j<h; j++){                   // bottom row first to top row first
+    for(i=0; i<w; i++){
+      pixels[j*w + i] = raw[(h - 1 - j)*w + i];
+    }
+  }
+
+  OutCount = 0;
+  literalStart = 0;
+  i = 0;
+  while(i < count){
+    for(run=1; (i + run < count) && (run < MAXRECORD) && (pixels[i + run] == pixels[i]); run++){}
+    if(run >= 3){
+      putLiteral(pixels, literalStart, i);
+      put(run);
+      put(pixels[i]);
+      i = i + run;
+      literalStart = i;
+    } else{
+      i = i + run;
+    }
+  }
+  putLiteral(pixels, literalStart, count);
+
+  printf("// %s: %ldx%ld, %ld bytes as a bitmap, %ld bytes encoded\n",
+         argv[1], w, h, 2*count, 2*OutCount);
+  printf("const uint16_t %s[] = {", argv[1]);
+  for(i=0; i<OutCount; i++){
+    printf("%s0x%04X%s", (i%8) ? " " : "\n  ", Out[i], (i < OutCount - 1) ? "," : "");
+  }
+  printf("\n};\n");
+  return 0;
+}
@@ -0,0 +1,340 @@
+// scrolltest.c
+// Runs on a PC (Linux), not on the LaunchPad.
+// Check of the hardware scrolled displays in the Single User Pong
+// Game driver using the SSI/uDMA model in st7735shim.c.  The driver
+// is included here so the font can be read.  The wire is replayed
+// into a model of the panel: 132x162 frame memory written through
+// CASET/RASET/RAMWR as MADCTL maps them, and shown through the
+// VSCRDEF/VSCSAD scroll area until NORON.  After each call the image
+// the panel shows must match, long after the scroll start has
+// wrapped around:
+//   console  (ST7735_SetScrollConsole(), ST7735_OutString()) a plain
+//            terminal holding the same text, in rotations 0 and 2
+//   strip    (ST7735_StripInit(), ST7735_StripSample()) the newest
+//            sample at the left edge, where it replaces the oldest,
+//            and the ones before it right to left from the right
+//            edge, each a span from the sample before, in rotations
+//            1 and 3
+//   waterfall  (ST7735_WaterfallInit(), ST7735_WaterfallRow()) the
+//            newest row at the bottom, where it replaces the oldest,
+//            and the ones before it top down from the top edge, in
+//            rotations 0 and 2
+// It fails on the first different image, or if the shim finds a
+// handshake error.
+//
+// build: gcc -O1 -no-pie -w -DST7735_SHIM -I. -I"../Single User Pong Game"
+//          -I"../Ball Roll using accelerometer" -o scrolltest scrolltest.c
+//          st7735shim.c
+// usage: ./scrolltest [runs]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "ST7735.c"
+
+#define COLS 132                        // frame memory of the controller
+#define ROWS 162
+#define MAXSIZE 160                     // longest side of the screen
+
+// panel model
+static uint16_t Mem[ROWS][COLS];
+static uint8_t Madctl;
+static int Scrolling, Tfa, Vsa, Ssa;
+
+// what the panel should show, in screen coordinates
+static uint16_t Expect[MAXSIZE][MAXSIZE];
+
+// Replay the wire since the last Shim_Clear() into the panel model.
+// The window and the write position are kept between calls.
+static void replay(void){
+  static int xs = 0, xe = COLS-1, ys = 0, ye = ROWS-1, c = 0, p = 0;
+  const ShimWire_t *w = &Shim_Wire[SHIM_SSI0];
+  uint32_t i, cmd = 0, arg = 0;
+  uint8_t a[6];
+  int hi = -1, col, row;
+  for(i=0; i<w->count; i++){
+    if((w->data[i]&SHIM_DATA) == 0){
+      cmd = w->data[i];
+      arg = 0;
+      if(cmd == ST7735_RAMWR){
+        c = xs;
+        p = ys;
+        hi = -1;
+      }
+      if(cmd == ST7735_NORON) Scrolling = 0;
+      continue;
+    }
+    if(arg < 6) a[arg] = w->data[i];
+    arg++;
+    switch(cmd){
+    case ST7735_CASET:
+      if(arg == 4){ xs = (a[0]<<8)|a[1]; xe = (a[2]<<8)|a[3]; }
+      break;
+    case ST7735_RASET:
+      if(arg == 4){ ys = (a[0]<<8)|a[1]; ye = (a[2]<<8)|a[3]; }
+      break;
+    case ST7735_MADCTL:
+      Madctl = a[0];
+      break;
+    case ST7735_VSCRDEF:
+      if(arg == 6){ Tfa = (a[0]<<8)|a[1]; Vsa = (a[2]<<8)|a[3]; }
+      break;
+    case ST7735_VSCSAD:
+      if(arg == 2){ Ssa = (a[0]<<8)|a[1]; Scrolling = 1; }
+      break;
+    case ST7735_RAMWR:
+      if(hi < 0){
+        hi = w->data[i]&0xFF;
+        break;
+      }
+      col = (Madctl&MADCTL_MV) ? p : c;
+      row = (Madctl&MADCTL_MV) ? c : p;
+      if(Madctl&MADCTL_MX) col = (COLS-1) - col;
+      if(Madctl&MADCTL_MY) row = (ROWS-1) - row;
+      if((col >= 0) && (col < COLS) && (row >= 0) && (row < ROWS)){
+        Mem[row][col] = (hi<<8) | (w->data[i]&0xFF);
+      }
+      hi = -1;
+      if(++c > xe){
+        c = xs;
+        if(++p > ye) p = ys;
+      }
+      break;
+    }
+  }
+}
+
+// Pixel the panel shows at screen (x,y): the frame memory the
+// address maps to, with the row moved by the scroll.
+static uint16_t shown(int x, int y){
+  int col = (Madctl&MADCTL_MV) ? y : x;
+  int row = (Madctl&MADCTL_MV) ? x : y;
+  if(Madctl&MADCTL_MX) col = (COLS-1) - col;
+  if(Madctl&MADCTL_MY) row = (ROWS-1) - row;
+  if(Scrolling && (row >= Tfa) && (row < Tfa + Vsa)){
+    row = Tfa + (row - Tfa + Ssa - Tfa)%Vsa;
+  }
+  return Mem[row][col];
+}
+
+static void sync(void){
+  ST7735_WaitIdle();
+  Shim_Drain();
+  replay();
+  Shim_Clear();
+}
+
+// 1 if the panel shows Expect.
+static int same(const char *what, long run, long step){
+  int x, y;
+  for(y=0; y<_height; y++){
+    for(x=0; x<_width; x++){
+      if(shown(x, y) != Expect[y][x]){
+        printf("FAIL: %s run %ld step %ld, rotation %d, pixel (%d,%d) is %04X not %04X\n",
+               what, run, step, Rotation, x, y, shown(x, y), Expect[y][x]);
+        return 0;
+      }
+    }
+  }
+  return 1;
+}
+
+static int rnd(int lo, int hi){
+  return lo + rand()%(hi - lo + 1);
+}
+
+//------------console------------
+// A plain terminal: the lines shown, top to bottom.
+static char TermChar[16][21];
+static uint16_t TermFg[16][21], TermBg[16][21];
+static int TermX, TermY, TermLines;
+
+static void termPut(int c, char ch, uint16_t fg, uint16_t bg){
+  TermChar[TermY][c] = ch;
+  TermFg[TermY][c] = fg;
+  TermBg[TermY][c] = bg;
+}
+
+static void termChar(char ch){
+  int c;
+  if((ch == '\n') || (ch == '\r')){
+    TermX = 0;
+    if(TermY < TermLines-1){
+      TermY++;
+    } else{                             // everything moves up a line
+      memmove(TermChar[0], TermChar[1], sizeof(TermChar[0])*(TermLines-1));
+      memmove(TermFg[0], TermFg[1], sizeof(TermFg[0])*(TermLines-1));
+      memmove(TermBg[0], TermBg[1], sizeof(TermBg[0])*(TermLines-1));
+    }
+    for(c=0; c<21; c++) termPut(c, ' ', StTextColor, StTextBgColor);
+    return;
+  }
+  termPut(TermX, ch, StTextColor, StTextBgColor);
+  TermX++;
+  if(TermX > 20){
+    TermX = 20;
+    termPut(20, '*', ST7735_RED, StTextBgColor);
+  }
+}
+
+// Draw the terminal into Expect: 6x8 cells on lines 10 rows apart,
+// the rest black.
+static void termDraw(void){
+  int line, c, r, i;
+  uint8_t bits;
+  memset(Expect, 0, sizeof(Expect));
+  for(line=0; line<TermLines; line++){
+    for(c=0; c<21; c++){
+      for(r=0; r<8; r++){
+        bits = FontRow[((uint8_t)TermChar[line][c])*8 + r];
+        for(i=0; i<6; i++){
+          Expect[line*10 + r][c*6 + i] = ((bits>>i)&1) ? TermFg[line][c] : TermBg[line][c];
+        }
+      }
+    }
+  }
+}
+
+static int console(long run, long steps){
+  char text[40];
+  long s;
+  int i, n;
+  ST7735_SetRotation(2*(run%2));
+  if(!ST7735_SetScrollConsole(1)){
+    printf("FAIL: no scrolling in rotation %d\n", Rotation);
+    return 1;
+  }
+  ST7735_SetTextColor(ST7735_YELLOW);
+  ST7735_SetTextBgColor(ST7735_BLACK);
+  TermLines = _height/10;
+  TermX = TermY = 0;
+  for(i=0; i<16*21; i++){
+    TermChar[i/21][i%21] = ' ';
+    TermFg[i/21][i%21] = TermBg[i/21][i%21] = ST7735_BLACK;
+  }
+  for(s=0; s<steps; s++){
+    switch(rand()%10){
+    case 0:
+      ST7735_SetTextColor(rand());
+      break;
+    case 1:
+      ST7735_SetTextBgColor(rand()%2 ? ST7735_BLACK : rand());
+      break;
+    case 2:
+      TermX = rnd(0, 20);
+      TermY = rnd(0, TermLines-1);
+      ST7735_SetCursor(TermX, TermY);
+      break;
+    case 3:
+      text[0] = (rand()%3) ? '\n' : rnd(32, 126);
+      termChar(text[0]);
+      ST7735_OutChar(text[0]);
+      break;
+    default:
+      n = rnd(0, 30);
+      for(i=0; i<n; i++){
+        text[i] = (rand()%8) ? rnd(32, 126) : '\n';
+        termChar(text[i]);
+      }
+      text[n] = 0;
+      ST7735_OutString(text);
+      break;
+    }
+    sync();
+    termDraw();
+    if(!same("console", run, s) || Shim_Errors) return 1;
+  }
+  return 0;
+}
+
+//------------strip chart------------
+#define SAMPLES 1000                    // most samples in a run
+static int16_t StripLo[SAMPLES], StripHi[SAMPLES];
+
+static int strip(long run, long steps){
+  int32_t ymin, ymax, lo, range, y, j, last = -1;
+  uint16_t color = rand(), bg = rand();
+  long s, k;
+  int x, i;
+  ST7735_SetRotation(1 + 2*(run%2));
+  ymin = rnd(-3000, 3000);
+  ymax = ymin + rnd(-3000, 3000);       // either way up
+  ST7735_StripInit(ymin, ymax, color, bg);
+  lo = (ymin < ymax) ? ymin : ymax;
+  range = (ymin < ymax) ? (ymax - ymin) : (ymin - ymax);
+  if(range == 0) range = 1;
+  y = lo + range/2;
+  for(s=0; (s<steps) && (s<SAMPLES); s++){
+    y = y + rnd(-range/8 - 1, range/8 + 1);
+    if(rand()%30 == 0) y = rnd(lo - range, lo + 2*range); // spike, maybe out of range
+    ST7735_StripSample(y);
+    j = (y < lo) ? lo : (y > lo + range) ? lo + range : y;
+    j = (_height-1) - ((_height-1)*(j - lo))/range;
+    StripLo[s] = StripHi[s] = j;
+    if(last >= 0){
+      if(last < j) StripLo[s] = last;
+      if(last > j) StripHi[s] = last;
+    }
+    last = j;
+    sync();
+    for(x=0; x<_width; x++){            // newest at the left edge
+      k = (x == 0) ? s : (s - _width + x);
+      for(i=0; i<_height; i++){
+        Expect[i][x] = ((k >= 0) && (i >= StripLo[k]) && (i <= StripHi[k])) ? color : bg;
+      }
+    }
+    if(!same("strip", run, s) || Shim_Errors) return 1;
+  }
+  return 0;
+}
+
+//------------waterfall------------
+static uint16_t WaterRow[SAMPLES][MAXSIZE];
+
+static int waterfall(long run, long steps){
+  uint16_t mag[MAXSIZE + 8];
+  uint32_t n;
+  long s, k;
+  int x, y, i;
+  ST7735_SetRotation(2*(run%2));
+  ST7735_WaterfallInit();
+  for(s=0; (s<steps) && (s<SAMPLES); s++){
+    n = rnd(0, _width + 8);
+    for(i=0; i<n; i++){
+      mag[i] = (rand()%4) ? rnd(0, 1023) : rand()%2048; // some past full scale
+      y = (mag[i]/2 > 511) ? 511 : mag[i]/2;
+      if(i < _width) WaterRow[s][i] = WaterfallPalette[159 - dBfs[y]];
+    }
+    for(i=n; i<_width; i++) WaterRow[s][i] = ST7735_BLACK;
+    ST7735_WaterfallRow(mag, n);
+    sync();
+    for(y=0; y<_height; y++){           // newest at the bottom edge
+      k = (y == _height-1) ? s : (s - 1 - y);
+      for(x=0; x<_width; x++){
+        Expect[y][x] = (k >= 0) ? WaterRow[k][x] : ST7735_BLACK;
+      }
+    }
+    if(!same("waterfall", run, s) || Shim_Errors) return 1;
+  }
+  return 0;
+}
+
+int main(int argc, char **argv){
+  long runs = (argc > 1) ? atol(argv[1]) : 20;
+  long r;
+  srand(1);
+  Shim_Init();
+  ST7735_InitR(INITR_REDTAB);
+  sync();
+  for(r=0; r<runs; r++){
+    if(console(r, 2000) || strip(r, SAMPLES) || waterfall(r, SAMPLES)) return 1;
+  }
+  if(Shim_Errors){
+    printf("FAIL: %u handshake errors\n", Shim_Errors);
+    return 1;
+  }
+  printf("PASS: %ld runs of 2000 console calls, %d strip chart samples and %d waterfall rows\n",
+         runs, SAMPLES, SAMPLES);
+  return 0;
+}
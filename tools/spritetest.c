@@ -0,0 +1,246 @@
+// spritetest.c
+// Runs on a PC (Linux), not on the LaunchPad.
+// Random check of the sprite engine (ST7735_SpriteMove(),
+// ST7735_SpriteHide(), ST7735_SpritePalette() and
+// ST7735_SpriteUpdate() in the Single User Pong Game driver) using
+// the SSI/uDMA model in st7735shim.c.  A table of sprites of random
+// size and format (16-bit BMP, 8-bit or 4-bit indexed, atlas cut,
+// with or without a key color) is moved, hidden and recolored at
+// random, often hanging off or crossing any of the four edges.
+// After each update the screen is read back from the wire and every
+// pixel must be the background, or where sprites cover it, the
+// pixel of one of them.  Every address window must lie on the
+// screen and take no more pixels than it holds, and an update with
+// nothing changed must send nothing.
+// It fails on the first wrong screen or window, or if the shim
+// finds a handshake error.
+//
+// build: gcc -O1 -no-pie -w -DST7735_SHIM -I. -I"../Single User Pong Game"
+//          -I"../Ball Roll using accelerometer" -o spritetest spritetest.c
+//          st7735shim.c "../Single User Pong Game/ST7735.c"
+// usage: ./spritetest [updates]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "ST7735.h"
+#include "st7735shim.h"
+
+#define ST7735_CASET   0x2A
+#define ST7735_RASET   0x2B
+#define ST7735_RAMWR   0x2C
+#define SIZE 128                        // screen of the Single User Pong Game driver
+#define SPRITES 6
+#define MAXSIDE 24                      // largest sprite side tried
+#define SHEET 32                        // atlas side
+
+static uint16_t Screen[SIZE*SIZE];
+static uint16_t Image16[SPRITES][SHEET*SHEET];
+static uint8_t Image8[SPRITES][SHEET*SHEET];
+static uint16_t Palette[2][256];
+static Sprite_t Table[SPRITES];
+static uint16_t Bg;
+static uint32_t BadWindows;
+
+// Replay the wire since the last Shim_Clear() into Screen, counting
+// windows that are off the screen, empty, or written past the end.
+// The window is kept between calls, since the driver does not
+// resend an address window that is already set.
+static void replay(void){
+  static int x0 = 0, x1 = SIZE-1, y0 = 0, y1 = SIZE-1, x = 0, y = 0;
+  const ShimWire_t *w = &Shim_Wire[SHIM_SSI0];
+  uint32_t i, cmd = 0, arg = 0;
+  uint8_t a[4];
+  int hi = -1;
+  for(i=0; i<w->count; i++){
+    if((w->data[i]&SHIM_DATA) == 0){
+      cmd = w->data[i];
+      arg = 0;
+      if(cmd == ST7735_RAMWR){
+        if((x0 > x1) || (y0 > y1) || (x1 >= SIZE) || (y1 >= SIZE)) BadWindows++;
+        x = x0;
+        y = y0;
+        hi = -1;
+      }
+      continue;
+    }
+    if((cmd == ST7735_CASET) || (cmd == ST7735_RASET)){
+      a[arg++&3] = w->data[i];
+      if(arg == 4){
+        if(cmd == ST7735_CASET){
+          x0 = a[1]; x1 = a[3];
+        } else{
+          y0 = a[1]; y1 = a[3];
+        }
+      }
+    } else if(cmd == ST7735_RAMWR){
+      if(hi < 0){
+        hi = w->data[i]&0xFF;
+        continue;
+      }
+      if(y > y1) BadWindows++;          // more pixels than the window
+      else if((x < SIZE) && (y < SIZE)) Screen[SIZE*y + x] = (hi<<8) | (w->data[i]&0xFF);
+      hi = -1;
+      if(++x > x1){
+        x = x0;
+        y++;
+      }
+    }
+  }
+}
+
+// Color of sprite pixel (c,r), r counted from the top, as it is
+// drawn: the key color or index shows the background.
+static uint16_t pixel(const Sprite_t *sp, int c, int r){
+  const Atlas_t *atlas = &sp->sheet;
+  int rowSize = (atlas->w*atlas->bpp + 7)/8;
+  int col = sp->sx + c;
+  int row = atlas->topDown ? (sp->sy + r) : (atlas->h - 1 - sp->sy - r);
+  const uint8_t *index = atlas->image;
+  int v;
+  if(atlas->bpp == 16){
+    v = ((const uint16_t *)atlas->image)[row*atlas->w + col];
+    return (v == sp->key) ? Bg : v;
+  }
+  if(atlas->bpp == 8){
+    v = index[row*rowSize + col];
+  } else{
+    v = index[row*rowSize + col/2];
+    v = (col&1) ? (v&0x0F) : (v>>4);
+  }
+  return (v == sp->key) ? Bg : sp->palette[v];
+}
+
+// 1 if every pixel shows the background or a sprite covering it.
+static int check(void){
+  int x, y, k, covered, ok;
+  const Sprite_t *sp;
+  for(y=0; y<SIZE; y++){
+    for(x=0; x<SIZE; x++){
+      covered = ok = 0;
+      for(k=0; k<SPRITES; k++){
+        sp = &Table[k];
+        if(!sp->visible || (x < sp->x) || (x >= sp->x + sp->w) ||
+           (y > sp->y) || (y <= sp->y - sp->h)) continue;
+        covered = 1;
+        if(Screen[SIZE*y + x] == pixel(sp, x - sp->x, y - (sp->y - sp->h + 1))) ok = 1;
+      }
+      if(!covered) ok = (Screen[SIZE*y + x] == Bg);
+      if(!ok){
+        printf("pixel (%d,%d) is %04X\n", x, y, Screen[SIZE*y + x]);
+        return 0;
+      }
+    }
+  }
+  return 1;
+}
+
+static int rnd(int lo, int hi){
+  return lo + rand()%(hi - lo + 1);
+}
+
+static void update(void){
+  ST7735_SpriteUpdate(Table, SPRITES);
+  ST7735_WaitIdle();
+  Shim_Drain();
+  replay();
+}
+
+// A new sprite of random format in entry k.
+static void newSprite(int k){
+  static const uint8_t bpps[3] = {16, 8, 4};
+  Sprite_t *sp = &Table[k];
+  Atlas_t atlas;
+  int w = rnd(1, MAXSIDE), h = rnd(1, MAXSIDE), i;
+  int32_t key;
+  for(i=0; i<SHEET*SHEET; i++){
+    Image16[k][i] = rand()%8;           // few colors, so the key is common
+    Image8[k][i] = rand()%4*0x11;
+  }
+  switch(rand()%4){
+  case 0:
+    key = (rand()%2) ? rand()%8 : -1;
+    ST7735_SpriteInit(sp, Image16[k], w, h, key);
+    break;
+  case 1:
+    key = (rand()%2) ? 0x11*(rand()%4) : -1;
+    ST7735_SpriteInitIndexed(sp, Image8[k], 8, Palette[0], w, h, key);
+    break;
+  case 2:
+    key = (rand()%2) ? rand()%4 : -1;
+    ST7735_SpriteInitIndexed(sp, Image8[k], 4, Palette[0], w, h, key);
+    break;
+  default:
+    atlas.bpp = bpps[rand()%3];
+    atlas.topDown = rand()%2;
+    atlas.w = atlas.h = SHEET;
+    atlas.image = (atlas.bpp == 16) ? (const void *)Image16[k] : (const void *)Image8[k];
+    key = (rand()%2) ? rand()%4 : -1;
+    ST7735_SpriteInitAtlas(sp, &atlas, Palette[0], rnd(0, SHEET - w), rnd(0, SHEET - h), w, h, key);
+    break;
+  }
+}
+
+int main(int argc, char **argv){
+  long updates = (argc > 1) ? atol(argv[1]) : 50000;
+  long n, windows = 0;
+  int i, k;
+  Sprite_t *sp;
+  srand(1);
+  for(i=0; i<256; i++){
+    Palette[0][i] = rand();
+    Palette[1][i] = rand();
+  }
+  Shim_Init();
+  ST7735_InitR(INITR_REDTAB);
+  for(n=0; n<updates; n++){
+    if(n%2000 == 0){                    // new background and sprites
+      for(k=0; k<SPRITES; k++) ST7735_SpriteHide(&Table[k]);
+      update();
+      Shim_Clear();
+      Bg = rand();
+      ST7735_SpriteBackground(Bg);
+      ST7735_FillScreen(Bg);
+      for(k=0; k<SPRITES; k++) newSprite(k);
+      ST7735_WaitIdle();
+      Shim_Drain();
+      replay();
+    }
+    Shim_Clear();
+    for(k=0; k<SPRITES; k++){
+      sp = &Table[k];
+      switch(rand()%8){
+      case 0: case 1:                   // anywhere, maybe off an edge
+        ST7735_SpriteMove(sp, rnd(-sp->w - 2, SIZE + 2), rnd(-2, SIZE + sp->h + 2));
+        break;
+      case 2:                           // a small step
+        ST7735_SpriteMove(sp, sp->x + rnd(-3, 3), sp->y + rnd(-3, 3));
+        break;
+      case 3:
+        if(rand()%4 == 0) ST7735_SpriteHide(sp);
+        break;
+      case 4:
+        if(sp->sheet.bpp != 16) ST7735_SpritePalette(sp, Palette[rand()%2]);
+        break;
+      default:
+        break;                          // unchanged
+      }
+    }
+    ST7735_ClearTxCount();
+    update();
+    windows += ST7735_GetWindowCount();
+    if(!check() || BadWindows || Shim_Errors){
+      printf("FAIL: update %ld, %u bad windows, %u handshake errors\n", n, BadWindows, Shim_Errors);
+      return 1;
+    }
+    Shim_Clear();
+    update();                           // nothing changed
+    if(Shim_Wire[SHIM_SSI0].count){
+      printf("FAIL: update %ld sent %u bytes with nothing changed\n", n, Shim_Wire[SHIM_SSI0].count);
+      return 1;
+    }
+  }
+  printf("PASS: %ld updates, %ld windows, and as many idle updates sent nothing\n", updates, windows);
+  return 0;
+}
@@ -0,0 +1,221 @@
+// ssirecord.c
+// Runs on a PC (Linux), not on the LaunchPad.
+// SSI recorder test: the driver's 16-bit frame and uDMA pixel paths
+// must put the same bytes on the wire as the original driver, which
+// sent every byte as an 8-bit frame through writedata().
+// The original setAddrWindow(), pushColor(), ST7735_DrawPixel(),
+// ST7735_DrawFastVLine(), ST7735_DrawFastHLine(), ST7735_FillRect()
+// and ST7735_DrawBitmap() are kept below as the reference, writing
+// into a byte list instead of the SSI.  The same random calls go to
+// the driver under st7735shim.c, which records the wire, and the
+// two byte lists (with the Data/Command pin) must match.
+// The one intended difference is that the driver leaves out a
+// CASET or RASET that repeats the one before (ST7735_GetSavedCount()),
+// so the reference does the same.
+//
+// build: gcc -O1 -no-pie -w -DST7735_SHIM -I. -I"../Single User Pong Game"
+//          -I"../Ball Roll using accelerometer" -o ssirecord ssirecord.c
+//          st7735shim.c "../Single User Pong Game/ST7735.c"
+// usage: ./ssirecord
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "ST7735.h"
+#include "st7735shim.h"
+
+#define ST7735_CASET   0x2A
+#define ST7735_RASET   0x2B
+#define ST7735_RAMWR   0x2C
+#define CALLS 20000
+
+static uint16_t *Ref;                   // reference wire, as in ShimWire_t
+static uint32_t RefCount, RefSize;
+static const int16_t _width = 128, _height = 128;
+static const uint8_t ColStart = 0, RowStart = 0;   // INITR_REDTAB
+static uint32_t LastCols, LastRows;     // last window sent, for the skip
+static uint16_t Image[64*64];
+
+static void put(uint16_t entry){
+  if(RefCount == RefSize){
+    RefSize = RefSize ? 2*RefSize : 65536;
+    Ref = realloc(Ref, RefSize*sizeof(uint16_t));
+  }
+  Ref[RefCount++] = entry;
+}
+static void writecommand(uint8_t c){ put(c); }
+static void writedata(uint8_t c){ put(SHIM_DATA | c); }
+
+// reference from here on, as the driver was
+static void setAddrWindow(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1) {
+  uint32_t cols = (x0+ColStart)<<8 | (x1+ColStart);
+  uint32_t rows = (y0+RowStart)<<8 | (y1+RowStart);
+  if(cols != LastCols){                 // skipped by the driver when repeated
+    writecommand(ST7735_CASET); // Column addr set
+    writedata(0x00);
+    writedata(x0+ColStart);     // XSTART
+    writedata(0x00);
+    writedata(x1+ColStart);     // XEND
+    LastCols = cols;
+  }
+  if(rows != LastRows){
+    writecommand(ST7735_RASET); // Row addr set
+    writedata(0x00);
+    writedata(y0+RowStart);     // YSTART
+    writedata(0x00);
+    writedata(y1+RowStart);     // YEND
+    LastRows = rows;
+  }
+  writecommand(ST7735_RAMWR); // write to RAM
+}
+
+static void pushColor(uint16_t color) {
+  writedata((uint8_t)(color >> 8));
+  writedata((uint8_t)color);
+}
+
+static void refDrawPixel(int16_t x, int16_t y, uint16_t color) {
+  if((x < 0) || (x >= _width) || (y < 0) || (y >= _height)) return;
+  setAddrWindow(x,y,x,y);
+  pushColor(color);
+}
+
+static void refDrawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+  uint8_t hi = color >> 8, lo = color;
+  if((x >= _width) || (y >= _height)) return;
+  if((y+h-1) >= _height) h = _height-y;
+  setAddrWindow(x, y, x, y+h-1);
+  while (h--) {
+    writedata(hi);
+    writedata(lo);
+  }
+}
+
+static void refDrawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+  uint8_t hi = color >> 8, lo = color;
+  if((x >= _width) || (y >= _height)) return;
+  if((x+w-1) >= _width)  w = _width-x;
+  setAddrWindow(x, y, x+w-1, y);
+  while (w--) {
+    writedata(hi);
+    writedata(lo);
+  }
+}
+
+static void refFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  uint8_t hi = color >> 8, lo = color;
+  if((x >= _width) || (y >= _height)) return;
+  if((x + w - 1) >= _width)  w = _width  - x;
+  if((y + h - 1) >= _height) h = _height - y;
+  setAddrWindow(x, y, x+w-1, y+h-1);
+  for(y=h; y>0; y--) {
+    for(x=w; x>0; x--) {
+      writedata(hi);
+      writedata(lo);
+    }
+  }
+}
+
+static void refDrawBitmap(int16_t x, int16_t y, const uint16_t *image, int16_t w, int16_t h){
+  int16_t skipC = 0;
+  int16_t originalWidth = w;
+  int i = w*(h - 1);
+  if((x >= _width) || ((y - h + 1) >= _height) || ((x + w) <= 0) || (y < 0)){
+    return;
+  }
+  if((w > _width) || (h > _height)){
+    return;
+  }
+  if((x + w - 1) >= _width){
+    skipC = (x + w) - _width;
+    w = _width - x;
+  }
+  if((y - h + 1) < 0){
+    i = i - (h - y - 1)*originalWidth;
+    h = y + 1;
+  }
+  if(x < 0){
+    w = w + x;
+    skipC = -1*x;
+    i = i - x;
+    x = 0;
+  }
+  if(y >= _height){
+    h = h - (y - _height + 1);
+    y = _height - 1;
+  }
+  setAddrWindow(x, y-h+1, x+w-1, y);
+  for(y=0; y<h; y=y+1){
+    for(x=0; x<w; x=x+1){
+      writedata((uint8_t)(image[i] >> 8));
+      writedata((uint8_t)image[i]);
+      i = i + 1;
+    }
+    i = i + skipC;
+    i = i - 2*originalWidth;
+  }
+}
+// end of the reference
+
+int main(void){
+  uint32_t k, i, first;
+  int op, x, y, w, h;
+  uint16_t color;
+  const ShimWire_t *wire = &Shim_Wire[SHIM_SSI0];
+  srand(1);
+  for(i=0; i<64*64; i++) Image[i] = rand();
+  Shim_Init();
+  ST7735_InitR(INITR_REDTAB);           // ends with a full screen fill
+  ST7735_WaitIdle();
+  Shim_Drain();
+  Shim_Clear();
+  LastCols = (ColStart<<8) | (ColStart + _width - 1);
+  LastRows = (RowStart<<8) | (RowStart + _height - 1);
+  for(k=0; k<CALLS; k++){
+    op = rand()%5;
+    x = rand()%128;
+    y = rand()%128;
+    w = 1 + rand()%64;
+    h = 1 + rand()%64;
+    color = rand();
+    switch(op){
+    case 0:
+      refDrawPixel(x, y, color);
+      ST7735_DrawPixel(x, y, color);
+      break;
+    case 1:
+      refDrawFastVLine(x, y, h, color);
+      ST7735_DrawFastVLine(x, y, h, color);
+      break;
+    case 2:
+      refDrawFastHLine(x, y, w, color);
+      ST7735_DrawFastHLine(x, y, w, color);
+      break;
+    case 3:                             // up to 64x64, some over 1024 pixels
+      refFillRect(x, y, w, h, color);
+      ST7735_FillRect(x, y, w, h, color);
+      break;
+    default:                            // may hang off any one side
+      x = x - 32;
+      y = y + 32;
+      if(rand()%2) x = x/2 + 32; else y = y/2 + 32;
+      refDrawBitmap(x, y, Image, w, h);
+      ST7735_DrawBitmap(x, y, Image, w, h);
+      break;
+    }
+  }
+  ST7735_WaitIdle();
+  Shim_Drain();
+  first = 0;
+  while((first < RefCount) && (first < wire->count) && (Ref[first] == wire->data[first])){
+    first++;
+  }
+  printf("%u calls: reference %u bytes, wire %u bytes (%u CPU writes, %u uDMA items)\n",
+         CALLS, RefCount, wire->count, Shim_CPUWrites, Shim_DMAItems);
+  if((first != RefCount) || (first != wire->count) || Shim_Errors){
+    printf("FAIL: first difference at byte %u, %u handshake errors\n", first, Shim_Errors);
+    return 1;
+  }
+  printf("PASS: byte stream unchanged\n");
+  return 0;
+}
@@ -0,0 +1,333 @@
+// st7735shim.c
+// Runs on a PC (Linux), not on the LaunchPad.
+// A model of the parts of the TM4C123 the ST7735 driver streams
+// through, so the driver can be tested and timed on the host:
+//  - the SSI0 and SSI2 transmitters, with their 8-frame FIFOs and
+//    their bit rate from CR0 and CPSR, 4 to 16 bit frames
+//  - uDMA channels 11 (SSI0 Tx) and 13 (SSI2 Tx) in basic mode, read
+//    from the driver's control table, feeding the FIFO whenever it
+//    has room once TXDMAE is set, and raising the SSI interrupt
+//    (SSI0Handler() or SSI2Handler()) when done, if it is enabled
+//    in the NVIC
+// The register pages are plain memory mapped at the real addresses,
+// so initialization code runs unchanged; only the hooks in ST7735.c
+// (SSI_WRITE, DMA_ENABLE, POLL) reach this file.  The status
+// register is rewritten after every step, so the driver's wait
+// loops see TNF and BSY change as the frames go out.
+// Time only moves while the driver waits (POLL) or the test calls
+// Shim_Work(): the CPU's own instructions are not counted, so
+// Shim_WaitCycles is the time the CPU is held by the LCD.
+// Handshake errors are counted and printed: a write to a full FIFO,
+// the Data/Command pin changed while a byte was still going out, a
+// channel started twice or pointed at the wrong SSI, and a wait that
+// can never end (e.g. a transfer whose interrupt is disabled).
+//
+// Link with the driver and a test program:
+//   gcc -no-pie -DST7735_SHIM -I. -I"../Single User Pong Game"
+//     -I"../Ball Roll using accelerometer" -o test test.c st7735shim.c
+//     "../Single User Pong Game/ST7735.c"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include "st7735shim.h"
+
+void SSI0Handler(void);
+void SSI2Handler(void);
+
+#define REG(address)   (*((volatile uint32_t *)(uintptr_t)(address)))
+#define PERIPH_BASE    0x40000000       // 1 MB of peripherals, to the uDMA
+#define PERIPH_SIZE    0x00100000
+#define CORE_BASE      0xE000E000       // NVIC and SysTick
+#define CORE_SIZE      0x00001000
+#define SYSCTL_PR      0x400FEA00       // peripheral ready registers
+#define UDMA_CTLBASE   0x400FF008
+#define UDMA_CHMAP1    0x400FF514
+#define NVIC_EN0       0xE000E100
+#define SSI_O_CR0      0x00
+#define SSI_O_DR       0x08
+#define SSI_O_SR       0x0C
+#define SSI_O_CPSR     0x10
+#define SSI_O_DMACTL   0x24
+#define FIFO_DEPTH     8
+
+ShimWire_t Shim_Wire[2];
+uint64_t Shim_Cycles;
+uint64_t Shim_WaitCycles;
+uint32_t Shim_CPUWrites;
+uint32_t Shim_DMAItems;
+uint32_t Shim_Interrupts;
+uint32_t Shim_Errors;
+
+typedef struct{
+  uint32_t base;                        // register block
+  uint32_t dcAddress;                   // Data/Command pin
+  uint32_t channel;                     // uDMA channel for Tx
+  uint32_t irq;                         // interrupt number
+  void (*handler)(void);
+  uint64_t start[FIFO_DEPTH + 1];       // when each queued frame starts shifting
+  uint32_t queued;
+  uint64_t busyUntil;                   // when the last frame is out
+  uint32_t lastDC;
+  // uDMA channel state
+  uint8_t dmaOn;
+  uint8_t pending;                      // interrupt raised, not yet taken
+  uint32_t src;                         // next item
+  uint32_t step;                        // bytes between items, 0 for a fixed source
+  uint32_t size;                        // bytes per item
+  uint32_t remaining;
+} Port_t;
+
+static Port_t Ports[2] = {
+  {0x40008000, 0x40004100, 11, 7, SSI0Handler},
+  {0x4000A000, 0x40004100, 13, 57, SSI2Handler}
+};
+static uint64_t Now;
+static uint8_t InHandler;
+
+static void error(const char *message){
+  Shim_Errors++;
+  fprintf(stderr, "shim: %s at cycle %llu\n", message, (unsigned long long)Now);
+}
+
+static Port_t *portOf(uint32_t base){
+  if(base == Ports[0].base) return &Ports[0];
+  if(base == Ports[1].base) return &Ports[1];
+  error("write to an unknown SSI");
+  exit(1);
+}
+
+static void record(uint32_t ssi, uint16_t entry){
+  ShimWire_t *w = &Shim_Wire[ssi];
+  if(w->count == w->size){
+    w->size = w->size ? 2*w->size : 65536;
+    w->data = realloc(w->data, w->size*sizeof(uint16_t));
+    if(w->data == 0){
+      fprintf(stderr, "shim: out of memory\n");
+      exit(1);
+    }
+  }
+  w->data[w->count++] = entry;
+}
+
+// Frames that have started shifting leave the FIFO.
+static void retire(Port_t *p){
+  uint32_t i, n = 0;
+  for(i=0; i<p->queued; i++){
+    if(p->start[i] > Now){
+      p->start[n++] = p->start[i];
+    }
+  }
+  p->queued = n;
+}
+
+// Status register as the driver sees it now.
+static void status(Port_t *p){
+  uint32_t sr = 0x01;                   // TFE, transmit FIFO empty
+  retire(p);
+  if(p->queued) sr = 0;
+  if(p->queued < FIFO_DEPTH) sr |= 0x02;   // TNF
+  if(p->busyUntil > Now) sr |= 0x10;       // BSY
+  REG(p->base + SSI_O_SR) = sr;
+}
+
+// One frame into the FIFO, recorded as the bytes the panel gets,
+// most significant byte first.
+static void push(Port_t *p, uint32_t data){
+  uint32_t ssi = p - Ports;
+  uint32_t cr0 = REG(p->base + SSI_O_CR0);
+  uint32_t bits = (cr0&0x0F) + 1;
+  uint32_t cpsr = REG(p->base + SSI_O_CPSR)&0xFF;
+  uint32_t scr = (cr0>>8)&0xFF;
+  uint32_t dc = REG(p->dcAddress) ? SHIM_DATA : 0;
+  uint64_t start;
+  retire(p);
+  if(p->queued >= FIFO_DEPTH){
+    error("write to a full transmit FIFO");
+  }
+  if((dc != p->lastDC) && (p->busyUntil > Now)){
+    error("Data/Command pin changed while a byte was going out");
+  }
+  p->lastDC = dc;
+  if(cpsr < 2) cpsr = 2;
+  start = (p->busyUntil > Now) ? p->busyUntil : Now;
+  if(p->queued < FIFO_DEPTH + 1){
+    p->start[p->queued++] = start;
+  }
+  p->busyUntil = start + (uint64_t)bits*cpsr*(scr + 1);
+  if(bits > 8){
+    record(ssi, dc | ((data>>8)&0xFF));
+  }
+  record(ssi, dc | (data&0xFF));
+}
+
+// Let the uDMA fill the FIFOs, and take the interrupts it raises.
+static void runDMA(void){
+  uint32_t i, v;
+  Port_t *p;
+  int again = 1;
+  while(again){
+    again = 0;
+    for(i=0; i<2; i++){
+      p = &Ports[i];
+      retire(p);
+      if(p->dmaOn && (REG(p->base + SSI_O_DMACTL)&0x02)){
+        while(p->remaining && (p->queued < FIFO_DEPTH)){
+          v = (p->size == 2) ? *(uint16_t *)(uintptr_t)p->src : *(uint8_t *)(uintptr_t)p->src;
+          push(p, v);
+          Shim_DMAItems++;
+          p->src += p->step;
+          p->remaining--;
+        }
+        if(p->remaining == 0){
+          p->dmaOn = 0;
+          p->pending = 1;
+        }
+      }
+      if(p->pending && !InHandler &&
+         (REG(NVIC_EN0 + 4*(p->irq/32))&(1u<<(p->irq%32)))){
+        p->pending = 0;
+        Shim_Interrupts++;
+        InHandler = 1;
+        p->handler();
+        InHandler = 0;
+        again = 1;
+      }
+    }
+  }
+  status(&Ports[0]);
+  status(&Ports[1]);
+}
+
+// Earliest time after now that anything changes, or 0 if never.
+static uint64_t nextEvent(int dmaOnly){
+  uint64_t t = 0;
+  uint32_t i, j;
+  Port_t *p;
+  for(i=0; i<2; i++){
+    p = &Ports[i];
+    if(dmaOnly && !p->dmaOn) continue;
+    for(j=0; j<p->queued; j++){
+      if((p->start[j] > Now) && ((t == 0) || (p->start[j] < t))) t = p->start[j];
+    }
+    if(!dmaOnly && (p->busyUntil > Now) && ((t == 0) || (p->busyUntil < t))) t = p->busyUntil;
+  }
+  return t;
+}
+
+// Move the clock to t, with the uDMA running at every step.
+static void advance(uint64_t t){
+  uint64_t next;
+  runDMA();
+  for(;;){
+    next = nextEvent(1);
+    if((next == 0) || (next > t)) break;
+    Now = next;
+    runDMA();
+  }
+  if(t > Now) Now = t;
+  runDMA();
+  Shim_Cycles = Now;
+}
+
+void Shim_SSIWrite(uint32_t base, uint32_t data){
+  Port_t *p = portOf(base);
+  runDMA();
+  if(p->dmaOn){
+    error("CPU write to an SSI the uDMA is feeding");
+  }
+  push(p, data);
+  Shim_CPUWrites++;
+  status(p);
+}
+
+void Shim_DMAEnable(uint32_t channel){
+  uint32_t table = REG(UDMA_CTLBASE);
+  uint32_t srcEnd = REG(table + 16*channel);
+  uint32_t dstEnd = REG(table + 16*channel + 4);
+  uint32_t control = REG(table + 16*channel + 8);
+  uint32_t n = ((control>>4)&0x3FF) + 1;
+  uint32_t srcInc = (control>>26)&0x03;
+  Port_t *p;
+  if(channel == Ports[0].channel){
+    p = &Ports[0];
+    if(REG(UDMA_CHMAP1)&0x0000F000) error("channel 11 not mapped to SSI0 Tx");
+  } else if(channel == Ports[1].channel){
+    p = &Ports[1];
+    if(((REG(UDMA_CHMAP1)>>20)&0x0F) != 2) error("channel 13 not mapped to SSI2 Tx");
+  } else{
+    error("unknown uDMA channel");
+    return;
+  }
+  if(p->dmaOn){
+    error("uDMA channel started while still running");
+  }
+  if(dstEnd != p->base + SSI_O_DR){
+    error("uDMA destination is not the SSI data register");
+  }
+  if((control&0x07) != 0x01){
+    error("uDMA channel not in basic mode");
+  }
+  p->size = 1u<<((control>>24)&0x03);
+  p->step = (srcInc == 3) ? 0 : (1u<<srcInc);
+  p->src = srcEnd - p->step*(n - 1);
+  p->remaining = n;
+  p->dmaOn = 1;
+}
+
+void Shim_Poll(void){
+  uint64_t next;
+  runDMA();
+  next = nextEvent(0);
+  if(next == 0){
+    error("the driver waits for something that never happens");
+    exit(1);
+  }
+  Shim_WaitCycles += next - Now;
+  advance(next);
+}
+
+void Shim_Work(uint32_t cycles){
+  advance(Now + cycles);
+}
+
+void Shim_Drain(void){
+  uint64_t next;
+  runDMA();
+  while((next = nextEvent(0)) != 0){
+    Shim_WaitCycles += next - Now;
+    advance(next);
+  }
+}
+
+void Shim_SetDC(uint32_t ssi, uint32_t address){
+  Ports[ssi].dcAddress = address;
+}
+
+void Shim_Clear(void){
+  Shim_Wire[0].count = 0;
+  Shim_Wire[1].count = 0;
+  Shim_Cycles = Now;
+  Shim_WaitCycles = 0;
+  Shim_CPUWrites = 0;
+  Shim_DMAItems = 0;
+  Shim_Interrupts = 0;
+  Shim_Errors = 0;
+}
+
+void Shim_Init(void){
+  uint32_t i;
+  if((mmap((void *)PERIPH_BASE, PERIPH_SIZE, PROT_READ|PROT_WRITE,
+           MAP_FIXED|MAP_PRIVATE|MAP_ANONYMOUS, -1, 0) == MAP_FAILED) ||
+     (mmap((void *)CORE_BASE, CORE_SIZE, PROT_READ|PROT_WRITE,
+           MAP_FIXED|MAP_PRIVATE|MAP_ANONYMOUS, -1, 0) == MAP_FAILED)){
+    perror("shim: mmap");
+    exit(1);
+  }
+  for(i=0; i<0xA0; i=i+4){
+    REG(SYSCTL_PR + i) = 0xFFFFFFFF;    // every peripheral ready
+  }
+  status(&Ports[0]);
+  status(&Ports[1]);
+}
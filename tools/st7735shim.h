@@ -0,0 +1,61 @@
+// st7735shim.h
+// Runs on a PC (Linux), not on the LaunchPad.
+// Register shim for host tests of the ST7735 driver, see st7735shim.c.
+// ST7735.c built with -DST7735_SHIM includes this file, so its SSI
+// data register writes, uDMA channel starts and wait loops come
+// here instead of going to the hardware.
+
+#ifndef ST7735SHIM_H
+#define ST7735SHIM_H
+
+#include <stdint.h>
+
+// hooks used by ST7735.c
+#define SSI_WRITE(data)         Shim_SSIWrite(SSIBase, (data))
+#define DMA_ENABLE(channel)     Shim_DMAEnable(channel)
+#define POLL()                  Shim_Poll()
+
+void Shim_SSIWrite(uint32_t base, uint32_t data);
+void Shim_DMAEnable(uint32_t channel);
+void Shim_Poll(void);
+
+// Bytes seen on the wire by one panel, in order.  Each entry is
+// the byte, plus 0x100 if the Data/Command pin was high (data).
+typedef struct{
+  uint16_t *data;
+  uint32_t count;
+  uint32_t size;
+} ShimWire_t;
+
+#define SHIM_SSI0 0                     // index of SSI0 in Shim_Wire[]
+#define SHIM_SSI2 1                     // index of SSI2 in Shim_Wire[]
+#define SHIM_DATA 0x100                 // Data/Command pin high
+
+extern ShimWire_t Shim_Wire[2];
+extern uint64_t Shim_Cycles;            // 80 MHz bus cycles since Shim_Init()
+extern uint64_t Shim_WaitCycles;        // of these, spent in driver wait loops
+extern uint32_t Shim_CPUWrites;         // frames written to an SSI by the CPU
+extern uint32_t Shim_DMAItems;          // frames written to an SSI by the uDMA
+extern uint32_t Shim_Interrupts;        // SSI interrupts taken
+extern uint32_t Shim_Errors;            // handshake errors found, also printed
+
+// Map the peripheral and core register pages at their TM4C123
+// addresses and make the clocks read as ready.  The program must be
+// linked with -no-pie, so the driver's 32-bit pointers fit.
+void Shim_Init(void);
+
+// Clear the wires and the counters (not the FIFOs or the clock).
+void Shim_Clear(void);
+
+// Data/Command pin of the panel on an SSI, as its bit-specific GPIO
+// address.  SSI0 starts as PA6, the default panel.
+void Shim_SetDC(uint32_t ssi, uint32_t address);
+
+// The CPU does something else for the given number of bus cycles,
+// while the SSI and the uDMA go on (and interrupts are taken).
+void Shim_Work(uint32_t cycles);
+
+// Wait until both SSIs are idle, counting the wait, as a frame end.
+void Shim_Drain(void);
+
+#endif
@@ -0,0 +1,94 @@
+// sweeptest.c
+// Runs on a PC (any C compiler), not on the LaunchPad.
+// Check of the swept collision test isColliding() in Pong.c (Single
+// User Pong Game), which is included here to reach the static
+// function.  Balls are launched from random points between the walls
+// at any angle and at 1 to 20 pixels per tick, against a random
+// paddle row, and stepped until they are lost or for 2.5 seconds of
+// ticks.  After every tick:
+//  - the ball must be inside the walls
+//  - if the straight path of the tick reaches the front of the paddle
+//    before any wall, the row where it does decides: a path whose rows
+//    overlap the paddle's must be returned as BALL_HIT moving right,
+//    and one that misses must be returned as BALL_LOST.  Rows within
+//    1/128 pixel of the edge of the paddle are not judged, as the row
+//    is rounded.
+// It fails on the first wrong tick.
+//
+// build: gcc -O2 -I"../Single User Pong Game" -o sweeptest sweeptest.c
+//          "../Single User Pong Game/Ball.c" -lm
+// usage: ./sweeptest [launches]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "../Single User Pong Game/Pong.c"
+
+#define MAX_TICKS 300                   // 2.5 seconds at TICK_HZ
+#define MAX_SPEED (20*BALL_ONE)
+
+static int rnd(int lo, int hi){
+  return lo + rand()%(hi - lo + 1);
+}
+
+static int overlaps(int32_t row, int32_t paddleY){
+  return (row > paddleY - PADDLE_HEIGHT) && (row - BALL_SIZE < paddleY);
+}
+
+static void report(const char *what, long launch, int tick, const Ball_t *before, uint32_t paddleY){
+  printf("FAIL: %s, launch %ld tick %d, ball (%d, %d) velocity (%d, %d), paddle row %u\n",
+         what, launch, tick, before->x, before->y, before->vx, before->vy, paddleY);
+}
+
+int main(int argc, char **argv){
+  long launches = (argc > 1) ? atol(argv[1]) : 200000;
+  long n, ticks = 0, hits = 0, misses = 0;
+  int32_t face = (PADDLE_X + PADDLE_WIDTH)*BALL_ONE;
+  int32_t lo, hi;
+  uint32_t paddleY;
+  Ball_t ball, before;
+  uint8_t result;
+  double t, row;
+  int tick;
+  srand(1);
+  for(n=0; n<launches; n++){
+    paddleY = rnd(PADDLE_HEIGHT - 1, 127);
+    Ball_Launch(&ball, rnd(PADDLE_X + PADDLE_WIDTH, WALL_RIGHT_X), rnd(WALL_TOP_Y, WALL_BOTTOM_Y),
+                rand()%256, rnd(BALL_ONE, MAX_SPEED));
+    for(tick=0; tick<MAX_TICKS; tick++){
+      before = ball;
+      result = isColliding(&ball, PADDLE_X, paddleY);
+      ticks++;
+      if((ball.y < WALL_TOP_Y*BALL_ONE) || (ball.y > WALL_BOTTOM_Y*BALL_ONE) ||
+         (ball.x > WALL_RIGHT_X*BALL_ONE)){
+        report("outside the walls", n, tick, &before, paddleY);
+        return 1;
+      }
+      if((before.vx < 0) && (before.x + before.vx < face)){
+        t = (double)(before.x - face)/-before.vx;
+        row = (before.y + before.vy*t)/BALL_ONE;
+        if((row > WALL_TOP_Y + 1.0/128) && (row < WALL_BOTTOM_Y - 1.0/128)){ // no wall first
+          lo = (int32_t)floor(row - 1.0/128 + 0.5);
+          hi = (int32_t)floor(row + 1.0/128 + 0.5);
+          if(overlaps(lo, paddleY) && overlaps(hi, paddleY)){
+            hits++;
+            if((result != BALL_HIT) || (ball.vx <= 0)){
+              report("path over the paddle not a hit", n, tick, &before, paddleY);
+              return 1;
+            }
+          } else if(!overlaps(lo, paddleY) && !overlaps(hi, paddleY)){
+            misses++;
+            if(result != BALL_LOST){
+              report("path past the paddle not lost", n, tick, &before, paddleY);
+              return 1;
+            }
+          }
+        }
+      }
+      if(result == BALL_LOST) break;
+    }
+  }
+  printf("PASS: %ld launches, %ld ticks, %ld paths judged hits and %ld misses\n",
+         launches, ticks, hits, misses);
+  return 0;
+}
@@ -0,0 +1,207 @@
+// texttest.c
+// Runs on a PC (Linux), not on the LaunchPad.
+// Console text check: reprinting an unchanged multi-line screen with
+// printf() (through the driver's fputc()) or ST7735_OutString() must
+// not set up a single address window (ST7735_GetWindowCount()), and
+// a changed screen must end up showing the same pixels as the same
+// text printed on a cleared screen.  Then 20000 random calls of
+// ST7735_SetCursor(), ST7735_SetTextColor(), ST7735_OutString(),
+// ST7735_OutUDec() and printf() must leave the panel showing the
+// character grid: every 100 calls, forcing a full redraw with
+// ST7735_TextInvalidate() must not change a pixel.  The pixels are
+// read back from the wire recorded by st7735shim.c.
+//
+// build: gcc -O1 -no-pie -w -DST7735_SHIM -I. -I"../Single User Pong Game"
+//          -I"../Ball Roll using accelerometer" -o texttest texttest.c
+//          st7735shim.c "../Single User Pong Game/ST7735.c"
+// usage: ./texttest
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "ST7735.h"
+#include "st7735shim.h"
+
+#define ST7735_CASET   0x2A
+#define ST7735_RASET   0x2B
+#define ST7735_RAMWR   0x2C
+
+static const char *Status =
+  "Speed  120\n"
+  "Score 10 to 9\n"
+  "Rally 14\n"
+  "Best 20\n";
+static const char *Changed =            // the first line is not begun by a newline,
+  "Speed  118\n"                        // so only it is not blanked past its text
+  "Score 10 to 10\n"                    // longer
+  "Rally 3\n"                           // shorter
+  "\n"                                  // emptied
+  "Last\n";                             // new
+
+static uint16_t Screen[128*128], Expect[128*128];
+static uint32_t Replayed;               // wire entries already in Screen
+
+// printf() on the LaunchPad ends in fputc() for each character.
+static void print(const char *s){
+  while(*s){
+    fputc(*s, stdout);
+    s = s + 1;
+  }
+}
+
+// Each line through ST7735_OutString(), as a program without printf().
+static void outLines(const char *s){
+  char line[32];
+  uint32_t n;
+  while(*s){
+    for(n=0; s[n] && (s[n] != '\n'); n++){}
+    if(s[n]) n++;                       // with its newline
+    memcpy(line, s, n);
+    line[n] = 0;
+    ST7735_OutString(line);
+    s = s + n;
+  }
+}
+
+// Play the wire recorded since the last call into Screen.
+static void replay(void){
+  static uint32_t cmd, arg;
+  static uint8_t a[4];
+  static int x0 = 0, x1 = 127, y0 = 0, x = 0, y = 0, hi = -1;
+  const ShimWire_t *w = &Shim_Wire[SHIM_SSI0];
+  uint32_t i;
+  for(i=Replayed; i<w->count; i++){
+    if((w->data[i]&SHIM_DATA) == 0){
+      cmd = w->data[i];
+      arg = 0;
+      if(cmd == ST7735_RAMWR){
+        x = x0;
+        y = y0;
+        hi = -1;
+      }
+      continue;
+    }
+    if((cmd == ST7735_CASET) || (cmd == ST7735_RASET)){
+      a[arg++&3] = w->data[i];
+      if(arg == 4){
+        if(cmd == ST7735_CASET){
+          x0 = a[1]; x1 = a[3];
+        } else{
+          y0 = a[1];
+        }
+      }
+    } else if(cmd == ST7735_RAMWR){
+      if(hi < 0){
+        hi = w->data[i]&0xFF;
+        continue;
+      }
+      if((x < 128) && (y < 128)) Screen[128*y + x] = (hi<<8) | (w->data[i]&0xFF);
+      hi = -1;
+      if(++x > x1){
+        x = x0;
+        y++;
+      }
+    }
+  }
+  Replayed = w->count;
+}
+
+// Windows set up by one printing of text at the top left.
+static uint32_t windows(void (*out)(const char *), const char *text){
+  ST7735_SetCursor(0, 0);
+  ST7735_ClearTxCount();
+  out(text);
+  ST7735_WaitIdle();
+  Shim_Drain();
+  replay();
+  return ST7735_GetWindowCount();
+}
+
+// Random console calls; returns the number of times the panel did
+// not match a full redraw of the grid.
+static uint32_t randomCalls(uint32_t calls){
+  static const char chars[] = "abc XYZ 0123\n";
+  char text[32];
+  uint32_t i, k, n, bad = 0;
+  for(i=1; i<=calls; i++){
+    switch(rand()%8){
+    case 0:
+      ST7735_SetCursor(rand()%21, rand()%16);
+      break;
+    case 1:
+      ST7735_SetTextColor((rand()%2) ? ST7735_YELLOW : ST7735_Color565(rand(), rand(), rand()));
+      break;
+    case 2:
+      ST7735_OutUDec(rand());
+      break;
+    default:
+      n = rand()%30;
+      for(k=0; k<n; k++) text[k] = chars[rand()%(sizeof(chars) - 1)];
+      text[n] = 0;
+      if(rand()%2){
+        ST7735_OutString(text);
+      } else{
+        print(text);
+      }
+      break;
+    }
+    if((i%100) == 0){
+      ST7735_TextFlush();               // show any partial printf() line
+      ST7735_WaitIdle();
+      Shim_Drain();
+      replay();
+      memcpy(Expect, Screen, sizeof(Screen));
+      ST7735_TextInvalidate();
+      ST7735_TextFlush();
+      ST7735_WaitIdle();
+      Shim_Drain();
+      replay();
+      bad += (memcmp(Expect, Screen, sizeof(Screen)) != 0);
+    }
+  }
+  return bad;
+}
+
+int main(void){
+  uint32_t first, again, lines, changed, errors, bad;
+  int fail = 0;
+  Shim_Init();
+  ST7735_InitR(INITR_REDTAB);
+  ST7735_FillScreen(ST7735_BLACK);
+  // the same text on a cleared screen
+  windows(print, Changed);
+  memcpy(Expect, Screen, sizeof(Screen));
+  ST7735_FillScreen(ST7735_BLACK);
+  first = windows(print, Status);
+  again = windows(print, Status);
+  lines = windows(outLines, Status);
+  changed = windows(print, Changed);
+  if(memcmp(Expect, Screen, sizeof(Screen))){
+    printf("FAIL: the changed screen differs from the same text printed on a cleared screen\n");
+    fail = 1;
+  }
+  srand(1);
+  bad = randomCalls(20000);
+  errors = Shim_Errors;
+  printf("windows: first %u, printf again %u, OutString again %u, changed %u\n",
+         first, again, lines, changed);
+  if((first == 0) || (again != 0) || (lines != 0)){
+    printf("FAIL: an unchanged screen was sent again\n");
+    fail = 1;
+  }
+  printf("random calls: %u of 200 redraws changed the panel\n", bad);
+  if(bad){
+    printf("FAIL: the panel does not show the character grid\n");
+    fail = 1;
+  }
+  if(errors){
+    printf("FAIL: %u handshake errors\n", errors);
+    fail = 1;
+  }
+  if(fail){
+    return 1;
+  }
+  printf("PASS\n");
+  return 0;
+}
@@ -0,0 +1,223 @@
+// tracetest.c
+// Runs on a PC (Linux), not on the LaunchPad.
+// Check of the multi-trace strip chart (ST7735_TraceInit(),
+// ST7735_TraceSample() and ST7735_TraceUpdate() in the Single User
+// Pong Game driver) using the SSI/uDMA model in st7735shim.c.
+// Each run picks a channel count, value range and decimation, then
+// interleaves samples and updates at random, with bursts of samples
+// long enough to fill the column FIFO.  A reference model keeps the
+// same envelopes, including the rule that a column keeps collecting
+// while the FIFO is full.  Every column read back from the wire must
+// match the reference column pixel for pixel, land one column right
+// of the one before, and be scrolled in by exactly one VSCSAD sent
+// after its data.
+// It fails on the first difference, or if the shim finds a
+// handshake error.
+//
+// build: gcc -O1 -no-pie -w -DST7735_SHIM -I. -I"../Single User Pong Game"
+//          -I"../Ball Roll using accelerometer" -o tracetest tracetest.c
+//          st7735shim.c "../Single User Pong Game/ST7735.c"
+// usage: ./tracetest [runs]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "ST7735.h"
+#include "st7735shim.h"
+
+#define ST7735_CASET   0x2A
+#define ST7735_RAMWR   0x2C
+#define ST7735_VSCSAD  0x37
+#define SIZE 128                        // screen of the Single User Pong Game driver
+#define CHANNELS 4                      // TRACE_MAX in the driver
+#define FIFO 16                         // TRACE_FIFO in the driver
+#define COLUMNS 4000                    // largest number of columns in a run
+
+// reference envelopes
+static int32_t RefMin[CHANNELS], RefMax[CHANNELS];
+static int32_t QueueMin[FIFO][CHANNELS], QueueMax[FIFO][CHANNELS];
+static uint32_t Queued, RefCount;
+static int32_t Top[CHANNELS], Bottom[CHANNELS];
+static uint16_t Expect[COLUMNS][SIZE];
+static uint32_t Expected;
+
+// columns read back from the wire
+static uint16_t Column[COLUMNS][SIZE];
+static int32_t ColumnX[COLUMNS];
+static uint32_t Columns, Scrolls, BadScrolls;
+
+static int32_t Channels, Ymin, Ymax;
+static uint32_t PerColumn;
+static const uint16_t Colors[CHANNELS] = {ST7735_YELLOW, ST7735_CYAN, ST7735_RED, ST7735_WHITE};
+
+// Find the columns and scroll commands in the wire since the last
+// Shim_Clear().
+static void replay(void){
+  static int x0;
+  const ShimWire_t *w = &Shim_Wire[SHIM_SSI0];
+  uint32_t i, cmd = 0, arg = 0, n = 0;
+  int hi = -1;
+  for(i=0; i<w->count; i++){
+    if((w->data[i]&SHIM_DATA) == 0){
+      cmd = w->data[i];
+      arg = 0;
+      if(cmd == ST7735_RAMWR){
+        if(Columns < COLUMNS) ColumnX[Columns] = x0;
+        n = 0;
+        hi = -1;
+      }
+      if(cmd == ST7735_VSCSAD){
+        Scrolls++;
+        if(Scrolls != Columns) BadScrolls++; // one after each column but the newest
+      }
+      continue;
+    }
+    if(cmd == ST7735_CASET){
+      if(++arg == 2) x0 = w->data[i]&0xFF;
+    } else if(cmd == ST7735_RAMWR){
+      if(hi < 0){
+        hi = w->data[i]&0xFF;
+        continue;
+      }
+      if((Columns < COLUMNS) && (n < SIZE)) Column[Columns][n] = (hi<<8) | (w->data[i]&0xFF);
+      hi = -1;
+      if(++n == SIZE) Columns++;
+    }
+  }
+}
+
+// Row that shows value y, as the driver computes it.
+static int32_t row(int32_t y){
+  int32_t range = Ymax - Ymin;
+  if(y < Ymin) y = Ymin;
+  if(y > Ymax) y = Ymax;
+  return (SIZE-1) - ((SIZE-1)*(y - Ymin))/range;
+}
+
+static void refSample(const int32_t *y){
+  int32_t c;
+  for(c=0; c<Channels; c++){
+    if((RefCount == 0) || (y[c] < RefMin[c])) RefMin[c] = y[c];
+    if((RefCount == 0) || (y[c] > RefMax[c])) RefMax[c] = y[c];
+  }
+  RefCount++;
+  if((RefCount >= PerColumn) && (Queued < FIFO - 1)){
+    memcpy(QueueMin[Queued], RefMin, sizeof(RefMin));
+    memcpy(QueueMax[Queued], RefMax, sizeof(RefMax));
+    Queued++;
+    RefCount = 0;
+  }
+}
+
+static void refUpdate(void){
+  uint32_t q;
+  int32_t c, i, top, bottom, lo, hi;
+  for(q=0; q<Queued; q++){
+    uint16_t *col = Expect[Expected < COLUMNS ? Expected : COLUMNS-1];
+    for(i=0; i<SIZE; i++) col[i] = ST7735_BLACK;
+    for(c=0; c<Channels; c++){
+      top = row(QueueMax[q][c]);
+      bottom = row(QueueMin[q][c]);
+      lo = top;
+      hi = bottom;
+      if(Top[c] >= 0){
+        if(lo > Bottom[c]) lo = Bottom[c];
+        if(hi < Top[c]) hi = Top[c];
+      }
+      for(i=lo; i<=hi; i++) col[i] = Colors[c];
+      Top[c] = top;
+      Bottom[c] = bottom;
+    }
+    Expected++;
+  }
+  Queued = 0;
+}
+
+static int rnd(int lo, int hi){
+  return lo + rand()%(hi - lo + 1);
+}
+
+// One chart: returns 0 if every column matched.
+static int run(int32_t steps){
+  int32_t y[CHANNELS], c, i, k, burst;
+  uint32_t drawn;
+  Channels = rnd(1, CHANNELS);
+  Ymin = rnd(-3000, 3000);
+  Ymax = Ymin + rnd(1, 5000);
+  PerColumn = rnd(1, 50);
+  ST7735_TraceInit(Channels, Ymin, Ymax, PerColumn, Colors, ST7735_BLACK);
+  ST7735_WaitIdle();
+  Shim_Drain();
+  Shim_Clear();
+  Queued = RefCount = Expected = 0;
+  Columns = Scrolls = BadScrolls = 0;
+  for(c=0; c<CHANNELS; c++){
+    Top[c] = -1;
+    y[c] = rnd(Ymin, Ymax);
+  }
+  for(i=0; (i<steps) && (Expected < COLUMNS - FIFO); i++){
+    if(rand()%4){                       // samples, sometimes enough to fill the FIFO
+      burst = (rand()%20) ? rnd(1, 2*PerColumn) : rnd(1, 40*PerColumn);
+      for(k=0; k<burst; k++){
+        for(c=0; c<Channels; c++){
+          y[c] = y[c] + rnd(-200, 200);
+          if(rand()%50 == 0) y[c] = rnd(Ymin - 1000, Ymax + 1000); // spike, maybe out of range
+        }
+        ST7735_TraceSample(y);
+        refSample(y);
+      }
+    } else{
+      drawn = ST7735_TraceUpdate();
+      if(drawn != Queued){
+        printf("FAIL: update drew %u columns, %u were finished\n", drawn, Queued);
+        return 1;
+      }
+      refUpdate();
+    }
+  }
+  ST7735_WaitIdle();
+  Shim_Drain();
+  replay();
+  if(Columns != Expected){
+    printf("FAIL: %u columns on the wire, %u expected\n", Columns, Expected);
+    return 1;
+  }
+  for(k=0; k<(int32_t)Columns; k++){
+    if(memcmp(Column[k], Expect[k], sizeof(Expect[k]))){
+      printf("FAIL: column %d of %d channels, %u samples per column, range %d to %d\n",
+             k, Channels, PerColumn, Ymin, Ymax);
+      return 1;
+    }
+    if((k > 0) && (ColumnX[k] != (ColumnX[k-1] + 1)%SIZE)){
+      printf("FAIL: column %d sent to x=%d after x=%d\n", k, ColumnX[k], ColumnX[k-1]);
+      return 1;
+    }
+  }
+  if(BadScrolls || (Columns && (Scrolls != Columns - 1))){
+    printf("FAIL: %u scrolls for %u columns, %u out of place\n", Scrolls, Columns, BadScrolls);
+    return 1;
+  }
+  return 0;
+}
+
+int main(int argc, char **argv){
+  long runs = (argc > 1) ? atol(argv[1]) : 200;
+  long r, columns = 0;
+  srand(1);
+  Shim_Init();
+  ST7735_InitR(INITR_REDTAB);
+  for(r=0; r<runs; r++){
+    if(run(rnd(10, 2000))){
+      printf("in run %ld\n", r);
+      return 1;
+    }
+    columns = columns + Columns;
+  }
+  if(Shim_Errors){
+    printf("FAIL: %u handshake errors\n", Shim_Errors);
+    return 1;
+  }
+  printf("PASS: %ld charts, %ld columns\n", runs, columns);
+  return 0;
+}